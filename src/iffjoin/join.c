@@ -21,12 +21,18 @@
  
 #include "join.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include "iff.h"
 #include "chunk.h"
 #include "form.h"
 #include "cat.h"
 #include "list.h"
 #include "id.h"
+#include "io.h"
+#include "error.h"
+#include "fdstream.h"
+
+#define IFF_MAX_CHUNK_SIZE 0x7fffffff
 
 int IFF_join(char **inputFilenames, const unsigned int inputFilenamesLength, const char *outputFilename)
 {
@@ -36,17 +42,20 @@ int IFF_join(char **inputFilenames, const unsigned int inputFilenamesLength, con
 
     for(i = 0; i < inputFilenamesLength; i++)
     {
-        /* Open each input IFF file */
-        IFF_Chunk *chunk = IFF_readFile(inputFilenames[i], NULL);
+        /* Open each input IFF file and check whether it is valid while it is parsed */
+        IFF_Chunk *chunk = IFF_readValidated(inputFilenames[i], NULL);
 
-        /* Check whether the IFF file is valid */
-        if(chunk == NULL || !IFF_check(chunk, NULL))
+        if(chunk == NULL)
+        {
+            IFF_free((IFF_Chunk*)cat, NULL);
+            return 1;
+        }
+        else if(!IFF_addToCATAndUpdateContentsType(cat, chunk)) /* Add the input IFF chunk to the concatenation */
         {
+            IFF_free(chunk, NULL);
             IFF_free((IFF_Chunk*)cat, NULL);
             return 1;
         }
-        else
-            IFF_addToCATAndUpdateContentsType(cat, chunk); /* Add the input IFF chunk to the concatenation */
     }
 
     /* Write the resulting CAT to the output file or standard output */
@@ -59,3 +68,180 @@ int IFF_join(char **inputFilenames, const unsigned int inputFilenamesLength, con
     /* Return whether the join has succeeded */
     return status;
 }
+
+static IFF_Bool readMainChunkHeader(IFF_FdIOStream *stream, const char *filename, const IFF_Bool check, IFF_Long *chunkSize, IFF_ID *groupType)
+{
+    IFF_ID chunkId;
+    long fileSize;
+
+    /* Parse and check the entire file if requested. It is freed right away, so that only one input file resides in memory at the time */
+    if(check)
+    {
+        IFF_Chunk *chunk = IFF_readValidatedStream((IFF_IOStream*)stream, NULL);
+
+        if(chunk == NULL)
+        {
+            IFF_error("ERROR: file: %s is not a valid IFF file!\n", filename);
+            return FALSE;
+        }
+
+        IFF_free(chunk, NULL);
+
+        if(!stream->seek((IFF_IOStream*)stream, 0, SEEK_SET))
+            return FALSE;
+    }
+
+    if(!IFF_readChunkHeader((IFF_IOStream*)stream, &chunkId, chunkSize)
+        || !IFF_readId((IFF_IOStream*)stream, groupType, chunkId, "groupType"))
+        return FALSE;
+
+    /* Only group chunks may be members of a concatenation */
+    if(chunkId != IFF_ID_FORM && chunkId != IFF_ID_CAT && chunkId != IFF_ID_LIST)
+    {
+        IFF_error("ERROR: the main chunk of file: %s must be a FORM, CAT or LIST, but it is: '", filename);
+        IFF_errorId(chunkId);
+        IFF_error("'\n");
+        return FALSE;
+    }
+
+    /* Check whether the file contains the entire chunk, so that the output is not truncated while copying */
+    if(!stream->seek((IFF_IOStream*)stream, 0, SEEK_END)
+        || (fileSize = stream->tell((IFF_IOStream*)stream)) == -1
+        || *chunkSize < IFF_ID_SIZE
+        || fileSize - IFF_ID_SIZE - (long)sizeof(IFF_Long) < *chunkSize)
+    {
+        IFF_error("ERROR: file: %s does not contain the entire main chunk!\n", filename);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static IFF_Bool readMainChunkHeaderFromFile(const char *filename, const IFF_Bool check, IFF_Long *chunkSize, IFF_ID *groupType)
+{
+    FILE *file = fopen(filename, "rb");
+    IFF_FdIOStream stream;
+    IFF_Bool status;
+
+    if(file == NULL)
+    {
+        IFF_error("ERROR: cannot open file: %s\n", filename);
+        return FALSE;
+    }
+
+    IFF_initFdIOStream(&stream, fileno(file));
+    status = readMainChunkHeader(&stream, filename, check, chunkSize, groupType);
+    fclose(file);
+
+    return status;
+}
+
+static IFF_Bool copyMainChunk(IFF_FdIOStream *outputStream, const char *filename, const IFF_Long chunkSize)
+{
+    FILE *file = fopen(filename, "rb");
+    IFF_FdIOStream stream;
+    IFF_Bool status;
+
+    if(file == NULL)
+    {
+        IFF_error("ERROR: cannot open file: %s\n", filename);
+        return FALSE;
+    }
+
+    IFF_initFdIOStream(&stream, fileno(file));
+
+    /* Copy the chunk header and body. The padding byte is written separately, since some files omit it at the end */
+    if(!(status = IFF_copyFdBytes(outputStream, &stream, IFF_ID_SIZE + sizeof(IFF_Long) + chunkSize)))
+        IFF_error("ERROR: cannot copy the main chunk of file: %s\n", filename);
+    else
+        status = IFF_writePaddingByte((IFF_IOStream*)outputStream, chunkSize, IFF_ID_CAT);
+
+    fclose(file);
+
+    return status;
+}
+
+static IFF_Bool writeStreamingCAT(IFF_FdIOStream *outputStream, char **inputFilenames, const unsigned int inputFilenamesLength, const IFF_Long *chunkSizes, const IFF_Long catSize, const IFF_ID contentsType)
+{
+    unsigned int i;
+
+    if(!IFF_writeId((IFF_IOStream*)outputStream, IFF_ID_CAT, IFF_ID_CAT, "chunkId")
+        || !IFF_writeLong((IFF_IOStream*)outputStream, catSize, IFF_ID_CAT, "chunkSize")
+        || !IFF_writeId((IFF_IOStream*)outputStream, contentsType, IFF_ID_CAT, "contentsType"))
+        return FALSE;
+
+    for(i = 0; i < inputFilenamesLength; i++)
+    {
+        if(!copyMainChunk(outputStream, inputFilenames[i], chunkSizes[i]))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+int IFF_joinStreaming(char **inputFilenames, const unsigned int inputFilenamesLength, const char *outputFilename, const IFF_Bool check)
+{
+    IFF_Long *chunkSizes = (IFF_Long*)malloc(inputFilenamesLength * sizeof(IFF_Long));
+    IFF_Long catSize = IFF_ID_SIZE;
+    IFF_ID contentsType = IFF_ID_JJJJ;
+    IFF_FdIOStream outputStream;
+    FILE *file;
+    unsigned int i;
+    int status = 0;
+
+    if(chunkSizes == NULL)
+        return 1;
+
+    /* Determine the size and contentsType of the concatenation from the headers of the input files */
+    for(i = 0; i < inputFilenamesLength; i++)
+    {
+        IFF_ID groupType;
+        IFF_Long memberSize;
+
+        if(!readMainChunkHeaderFromFile(inputFilenames[i], check, &chunkSizes[i], &groupType))
+        {
+            free(chunkSizes);
+            return 1;
+        }
+
+        memberSize = IFF_ID_SIZE + sizeof(IFF_Long) + chunkSizes[i] + chunkSizes[i] % 2;
+
+        if(catSize > IFF_MAX_CHUNK_SIZE - memberSize)
+        {
+            IFF_error("ERROR: the concatenation of the input files exceeds the maximum chunk size!\n");
+            free(chunkSizes);
+            return 1;
+        }
+
+        catSize += memberSize;
+
+        /* Use the group type of the members if they are all equal, else the wildcard */
+        if(i == 0)
+            contentsType = groupType;
+        else if(contentsType != groupType)
+            contentsType = IFF_ID_JJJJ;
+    }
+
+    /* Write the CAT header and copy the input files to the output file or standard output */
+    if(outputFilename == NULL)
+        file = stdout;
+    else if((file = fopen(outputFilename, "wb")) == NULL)
+    {
+        IFF_error("ERROR: cannot open file: %s\n", outputFilename);
+        free(chunkSizes);
+        return 1;
+    }
+
+    IFF_initFdIOStream(&outputStream, fileno(file));
+
+    if(!writeStreamingCAT(&outputStream, inputFilenames, inputFilenamesLength, chunkSizes, catSize, contentsType))
+        status = 1;
+
+    if(outputFilename != NULL)
+        fclose(file);
+
+    free(chunkSizes);
+
+    /* Return whether the join has succeeded */
+    return status;
+}
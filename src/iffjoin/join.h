@@ -22,6 +22,8 @@
 #ifndef __IFF_JOIN_H
 #define __IFF_JOIN_H
 
+#include "ifftypes.h"
+
 /**
  * Joins an arbitrary number of IFF input files in a single concatenation chunk.
  *
@@ -32,4 +34,19 @@
  */
 int IFF_join(char **inputFilenames, const unsigned int inputFilenamesLength, const char *outputFilename);
 
+/**
+ * Joins an arbitrary number of IFF input files in a single concatenation chunk,
+ * like IFF_join(), without parsing the input files into memory. Only the
+ * header of the main chunk of each input file is read to determine the size
+ * and contentsType of the concatenation. Then, the input files are copied to
+ * the output verbatim.
+ *
+ * @param inputFilenames An array of input IFF file names
+ * @param inputFilenamesLength Contains the length of the inputFilenames array
+ * @param outputFilename Specifies the name of the output file containing the resulting concatenation chunk. NULL can be used to write the result to the standard output.
+ * @param check Indicates whether each input file should be parsed and checked (one at a time) before it is copied
+ * @return 0 if the resulting concatenation has been successfully written, else 1
+ */
+int IFF_joinStreaming(char **inputFilenames, const unsigned int inputFilenamesLength, const char *outputFilename, const IFF_Bool check);
+
 #endif
@@ -40,13 +40,23 @@ static void printUsage(const char *command)
     "concatenation IFF file. The result is written to the standard output, or\n"
     "optionally to a given destination file.\n\n"
 
+    "By default, the input files are parsed and checked in memory before they are\n"
+    "joined. In streaming mode, only the header of each input file is read and the\n"
+    "input files are copied to the output without parsing them into memory.\n\n"
+
     "Options:\n"
 #if _MSC_VER
     "  /o FILE    Specify an output file name\n"
+    "  /s         Copy the input files without parsing them into memory\n"
+    "  /c         Check each input file before it is copied in streaming mode\n"
     "  /?         Shows the usage of this command to the user\n"
     "  /v         Shows the version of this command to the user"
 #else
     "  -o, --output-file=FILE    Specify an output file name\n"
+    "  -s, --stream              Copy the input files without parsing them into\n"
+    "                            memory\n"
+    "  -c, --check               Check each input file before it is copied in\n"
+    "                            streaming mode\n"
     "  -h, --help                Shows the usage of this command to the user\n"
     "  -v, --version             Shows the version of this command to the user"
 #endif
@@ -64,6 +74,8 @@ static void printVersion(const char *command)
 int main(int argc, char *argv[])
 {
     char *outputFilename = NULL;
+    IFF_Bool stream = FALSE;
+    IFF_Bool check = FALSE;
 
 #if _MSC_VER
     unsigned int optind = 1;
@@ -76,6 +88,16 @@ int main(int argc, char *argv[])
             outputFilename = argv[i];
             optind++;
         }
+        else if (strcmp(argv[i], "/s") == 0)
+        {
+            stream = TRUE;
+            optind++;
+        }
+        else if (strcmp(argv[i], "/c") == 0)
+        {
+            check = TRUE;
+            optind++;
+        }
         else if (strcmp(argv[i], "/?") == 0)
         {
             printUsage(argv[0]);
@@ -94,6 +116,8 @@ int main(int argc, char *argv[])
     struct option long_options[] =
     {
         {"output-file", required_argument, 0, 'o'},
+        {"stream", no_argument, 0, 's'},
+        {"check", no_argument, 0, 'c'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0}
@@ -102,9 +126,9 @@ int main(int argc, char *argv[])
     
     /* Parse command-line options */
 #if HAVE_GETOPT_H == 1
-    while((c = getopt_long(argc, argv, "o:hv", long_options, &option_index)) != -1)
+    while((c = getopt_long(argc, argv, "o:schv", long_options, &option_index)) != -1)
 #else
-    while((c = getopt(argc, argv, "o:hv")) != -1)
+    while((c = getopt(argc, argv, "o:schv")) != -1)
 #endif
     {
         switch(c)
@@ -112,6 +136,12 @@ int main(int argc, char *argv[])
             case 'o':
                 outputFilename = optarg;
                 break;
+            case 's':
+                stream = TRUE;
+                break;
+            case 'c':
+                check = TRUE;
+                break;
             case 'h':
                 printUsage(argv[0]);
                 return 0;
@@ -143,7 +173,10 @@ int main(int argc, char *argv[])
             inputFilenames[i] = argv[optind + i];
 
         /* Join the IFF files */
-        status = IFF_join(inputFilenames, inputFilenamesLength, outputFilename);
+        if(stream)
+            status = IFF_joinStreaming(inputFilenames, inputFilenamesLength, outputFilename, check);
+        else
+            status = IFF_join(inputFilenames, inputFilenamesLength, outputFilename);
 
         /* Cleanup */
         free(inputFilenames);
@@ -24,8 +24,13 @@
 
 int IFF_prettyPrint(const char *filename, const int options)
 {
-    /* Parse the chunk */
-    IFF_Chunk *chunk = IFF_read(filename, NULL);
+    /* Parse the chunk. Unless disabled, the file is checked while it is parsed */
+    IFF_Chunk *chunk;
+
+    if(options & IFFPP_DISABLE_CHECK)
+        chunk = IFF_read(filename, NULL);
+    else
+        chunk = IFF_readValidated(filename, NULL);
 
     if(chunk == NULL)
     {
@@ -34,22 +39,12 @@ int IFF_prettyPrint(const char *filename, const int options)
     }
     else
     {
-        int status;
-
-        /* Check the file */
-        if((options & IFFPP_DISABLE_CHECK) || IFF_check(chunk, NULL))
-        {
-            /* Print the file */
-            IFF_print(chunk, 0, NULL);
-
-            status = 0;
-        }
-        else
-            status = 1;
+        /* Print the file */
+        IFF_print(chunk, 0, NULL);
 
         /* Free the chunk structure */
         IFF_free(chunk, NULL);
 
-        return status;
+        return 0;
     }
 }
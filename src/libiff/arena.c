@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include "threadlocal.h"
+
+#define DEFAULT_SLAB_SIZE 65536
+
+/* Used to determine an alignment that is suitable for any struct member */
+typedef union
+{
+    void *pointer;
+    long integer;
+    double real;
+}
+Alignment;
+
+#define ALIGN(size) (((size) + sizeof(Alignment) - 1) / sizeof(Alignment) * sizeof(Alignment))
+
+static IFF_THREAD_LOCAL IFF_Arena *selectedArena = NULL;
+
+static IFF_ArenaSlab *createSlab(const size_t size, IFF_ArenaSlab *next)
+{
+    IFF_ArenaSlab *slab = (IFF_ArenaSlab*)malloc(ALIGN(sizeof(IFF_ArenaSlab)) + size);
+
+    if(slab != NULL)
+    {
+        slab->next = next;
+        slab->size = size;
+        slab->used = 0;
+        slab->data = (IFF_UByte*)slab + ALIGN(sizeof(IFF_ArenaSlab));
+    }
+
+    return slab;
+}
+
+static void freeSlabs(IFF_ArenaSlab *slab)
+{
+    while(slab != NULL)
+    {
+        IFF_ArenaSlab *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+}
+
+IFF_Arena *IFF_createArena(const size_t slabSize)
+{
+    IFF_Arena *arena = (IFF_Arena*)malloc(sizeof(IFF_Arena));
+
+    if(arena != NULL)
+    {
+        arena->slabSize = slabSize == 0 ? DEFAULT_SLAB_SIZE : ALIGN(slabSize);
+        arena->slab = NULL;
+        arena->lastAllocation = NULL;
+    }
+
+    return arena;
+}
+
+void IFF_resetArena(IFF_Arena *arena)
+{
+    /* Keep the current slab, so that subsequent allocations do not have to allocate a new one */
+    if(arena->slab != NULL)
+    {
+        freeSlabs(arena->slab->next);
+        arena->slab->next = NULL;
+        arena->slab->used = 0;
+    }
+
+    arena->lastAllocation = NULL;
+}
+
+void IFF_freeArena(IFF_Arena *arena)
+{
+    if(selectedArena == arena)
+        selectedArena = NULL;
+
+    freeSlabs(arena->slab);
+    free(arena);
+}
+
+IFF_Arena *IFF_selectArena(IFF_Arena *arena)
+{
+    IFF_Arena *previousArena = selectedArena;
+    selectedArena = arena;
+    return previousArena;
+}
+
+static void *allocateFromArena(IFF_Arena *arena, size_t size)
+{
+    void *data;
+
+    size = ALIGN(size);
+
+    /* Allocate a new slab if the allocation does not fit in the current one */
+    if(arena->slab == NULL || arena->slab->size - arena->slab->used < size)
+    {
+        IFF_ArenaSlab *slab = createSlab(size > arena->slabSize ? size : arena->slabSize, arena->slab);
+
+        if(slab == NULL)
+            return NULL;
+
+        arena->slab = slab;
+    }
+
+    data = arena->slab->data + arena->slab->used;
+    arena->slab->used += size;
+    arena->lastAllocation = data;
+
+    return data;
+}
+
+static void *reallocateFromArena(IFF_Arena *arena, void *data, const size_t oldSize, const size_t newSize)
+{
+    if(data == NULL)
+        return allocateFromArena(arena, newSize);
+    else if(data == arena->lastAllocation)
+    {
+        /* The most recent allocation can be enlarged in place if the slab has enough space left */
+        size_t offset = (IFF_UByte*)data - arena->slab->data;
+
+        if(ALIGN(newSize) <= arena->slab->size - offset)
+        {
+            arena->slab->used = offset + ALIGN(newSize);
+            return data;
+        }
+    }
+
+    if(newSize <= oldSize)
+        return data;
+    else
+    {
+        void *newData = allocateFromArena(arena, newSize);
+
+        if(newData != NULL)
+            memcpy(newData, data, oldSize);
+
+        return newData;
+    }
+}
+
+IFF_Arena *IFF_getSelectedArena(void)
+{
+    return selectedArena;
+}
+
+void *IFF_allocateIn(IFF_Arena *arena, const size_t size)
+{
+    if(arena == NULL)
+        return malloc(size);
+    else
+        return allocateFromArena(arena, size);
+}
+
+void *IFF_reallocateIn(IFF_Arena *arena, void *data, const size_t oldSize, const size_t newSize)
+{
+    if(arena == NULL)
+        return realloc(data, newSize);
+    else
+        return reallocateFromArena(arena, data, oldSize, newSize);
+}
+
+void IFF_deallocateIn(IFF_Arena *arena, void *data)
+{
+    if(arena == NULL)
+        free(data);
+}
+
+void *IFF_allocate(const size_t size)
+{
+    return IFF_allocateIn(selectedArena, size);
+}
+
+void *IFF_reallocate(void *data, const size_t oldSize, const size_t newSize)
+{
+    return IFF_reallocateIn(selectedArena, data, oldSize, newSize);
+}
+
+void IFF_deallocate(void *data)
+{
+    IFF_deallocateIn(selectedArena, data);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_ARENA_H
+#define __IFF_ARENA_H
+
+typedef struct IFF_ArenaSlab IFF_ArenaSlab;
+typedef struct IFF_Arena IFF_Arena;
+
+#include <stddef.h>
+#include "ifftypes.h"
+
+/**
+ * @brief A contiguous block of memory from which allocations are made by bumping an offset
+ */
+struct IFF_ArenaSlab
+{
+    /** Link to the slab that was allocated before this slab, or NULL if this is the first slab */
+    IFF_ArenaSlab *next;
+
+    /** Size of the usable memory in this slab in bytes */
+    size_t size;
+
+    /** Amount of bytes that have been handed out from this slab */
+    size_t used;
+
+    /** Pointer to the usable memory of this slab */
+    IFF_UByte *data;
+};
+
+/**
+ * @brief An arena from which the nodes, sub chunk arrays and chunk bodies of a chunk hierarchy can be allocated, so that the entire hierarchy can be released at once.
+ */
+struct IFF_Arena
+{
+    /** Size of a regular slab in bytes. Allocations that are bigger receive a slab of their own */
+    size_t slabSize;
+
+    /** Link to the slab from which allocations are currently made */
+    IFF_ArenaSlab *slab;
+
+    /** Pointer to the most recent allocation, which can be enlarged in place */
+    void *lastAllocation;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Creates a new arena. The arena must be freed with IFF_freeArena().
+ *
+ * @param slabSize Size of the slabs in bytes from which allocations are made, or 0 to use a default size
+ * @return An arena instance, or NULL if the memory can't be allocated
+ */
+IFF_Arena *IFF_createArena(const size_t slabSize);
+
+/**
+ * Releases all allocations that were made from the arena in one operation, so
+ * that its memory can be reused. Chunk hierarchies that were allocated from the
+ * arena become invalid and must not be freed with IFF_free().
+ *
+ * @param arena An arena instance
+ */
+void IFF_resetArena(IFF_Arena *arena);
+
+/**
+ * Frees the arena and all allocations that were made from it.
+ *
+ * @param arena An arena instance
+ */
+void IFF_freeArena(IFF_Arena *arena);
+
+/**
+ * Selects the arena from which the library allocates new chunks for the calling
+ * thread. Every chunk records the arena from which it has been allocated, so
+ * that its sub chunk arrays and bodies are grown and freed by the same arena,
+ * regardless of the arena that is selected when a chunk hierarchy is modified
+ * or freed.
+ *
+ * The selection is stored in thread local storage. If the compiler does not
+ * support it, which configure reports, the selection is shared by all threads
+ * of the process, and only one thread at a time may select an arena or read
+ * into one.
+ *
+ * @param arena An arena instance or NULL to allocate from the heap
+ * @return The arena that was selected previously, or NULL if none was selected
+ */
+IFF_Arena *IFF_selectArena(IFF_Arena *arena);
+
+/**
+ * Returns the arena that has been selected for the calling thread.
+ *
+ * @return The selected arena, or NULL if none was selected
+ */
+IFF_Arena *IFF_getSelectedArena(void);
+
+/**
+ * Allocates a block of memory from the given arena, or from the heap if no arena is given.
+ * Chunk types should allocate the memory that belongs to a chunk from the
+ * arena of the chunk, so that it is released along with the arena.
+ *
+ * @param arena An arena instance or NULL to allocate from the heap
+ * @param size Size of the memory block in bytes
+ * @return Pointer to the memory block, or NULL if the memory can't be allocated
+ */
+void *IFF_allocateIn(IFF_Arena *arena, const size_t size);
+
+/**
+ * Changes the size of a block of memory that was allocated with IFF_allocateIn()
+ * from the same arena.
+ *
+ * @param arena The arena from which the memory block was allocated, or NULL if it was allocated from the heap
+ * @param data Pointer to the memory block or NULL to allocate a new one
+ * @param oldSize Current size of the memory block in bytes
+ * @param newSize Requested size of the memory block in bytes
+ * @return Pointer to the resized memory block, or NULL if the memory can't be allocated
+ */
+void *IFF_reallocateIn(IFF_Arena *arena, void *data, const size_t oldSize, const size_t newSize);
+
+/**
+ * Frees a block of memory that was allocated with IFF_allocateIn() from the
+ * same arena. If an arena is given, this function does nothing, because the
+ * memory is released when the arena is reset.
+ *
+ * @param arena The arena from which the memory block was allocated, or NULL if it was allocated from the heap
+ * @param data Pointer to the memory block
+ */
+void IFF_deallocateIn(IFF_Arena *arena, void *data);
+
+/**
+ * Allocates a block of memory from the selected arena, or from the heap if no arena has been selected.
+ *
+ * @param size Size of the memory block in bytes
+ * @return Pointer to the memory block, or NULL if the memory can't be allocated
+ */
+void *IFF_allocate(const size_t size);
+
+/**
+ * Changes the size of a block of memory that was allocated with IFF_allocate()
+ * while the same arena was selected.
+ *
+ * @param data Pointer to the memory block or NULL to allocate a new one
+ * @param oldSize Current size of the memory block in bytes
+ * @param newSize Requested size of the memory block in bytes
+ * @return Pointer to the resized memory block, or NULL if the memory can't be allocated
+ */
+void *IFF_reallocate(void *data, const size_t oldSize, const size_t newSize);
+
+/**
+ * Frees a block of memory that was allocated with IFF_allocate() while the same
+ * arena was selected. If an arena has been selected, this function does
+ * nothing, because the memory is released when the arena is reset.
+ *
+ * @param data Pointer to the memory block
+ */
+void IFF_deallocate(void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
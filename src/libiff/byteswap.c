@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "byteswap.h"
+
+#if IFF_BIG_ENDIAN != 1
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IFF_SWAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if HAVE_AVX2_DISPATCH == 1 && defined(IFF_SWAP_SSE2)
+#define IFF_SWAP_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define IFF_SWAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+typedef void (*IFF_SwapFunction) (void *values, const size_t length);
+
+static void swapUWordsScalar(IFF_UWord *values, const size_t length)
+{
+    size_t i;
+
+    for(i = 0; i < length; i++)
+        values[i] = (values[i] & 0xff) << 8 | (values[i] & 0xff00) >> 8;
+}
+
+static void swapULongsScalar(IFF_ULong *values, const size_t length)
+{
+    size_t i;
+
+    for(i = 0; i < length; i++)
+    {
+        IFF_ULong value = values[i];
+        values[i] = (value & 0xff) << 24 | (value & 0xff00) << 8 | (value & 0xff0000) >> 8 | (value & 0xff000000) >> 24;
+    }
+}
+
+#ifdef IFF_SWAP_SSE2
+static void swapUWordsSSE2(void *values, const size_t length)
+{
+    IFF_UWord *words = (IFF_UWord*)values;
+    size_t i;
+
+    for(i = 0; i + 8 <= length; i += 8)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(words + i));
+        block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+        _mm_storeu_si128((__m128i*)(words + i), block);
+    }
+
+    swapUWordsScalar(words + i, length - i);
+}
+
+static void swapULongsSSE2(void *values, const size_t length)
+{
+    IFF_ULong *longs = (IFF_ULong*)values;
+    size_t i;
+
+    for(i = 0; i + 4 <= length; i += 4)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(longs + i));
+
+        /* Swap the bytes in each word, then swap the words in each long */
+        block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+        block = _mm_shufflelo_epi16(block, _MM_SHUFFLE(2, 3, 0, 1));
+        block = _mm_shufflehi_epi16(block, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128((__m128i*)(longs + i), block);
+    }
+
+    swapULongsScalar(longs + i, length - i);
+}
+#endif
+
+#ifdef IFF_SWAP_AVX2
+__attribute__((target("avx2"))) static void swapWithShuffle(IFF_UByte *values, const size_t size, const __m256i mask)
+{
+    size_t i;
+
+    for(i = 0; i + 32 <= size; i += 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(values + i));
+        _mm256_storeu_si256((__m256i*)(values + i), _mm256_shuffle_epi8(block, mask));
+    }
+}
+
+__attribute__((target("avx2"))) static void swapUWordsAVX2(void *values, const size_t length)
+{
+    const __m256i mask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    size_t processed = length - length % 16;
+
+    swapWithShuffle((IFF_UByte*)values, processed * sizeof(IFF_UWord), mask);
+    swapUWordsScalar((IFF_UWord*)values + processed, length - processed);
+}
+
+__attribute__((target("avx2"))) static void swapULongsAVX2(void *values, const size_t length)
+{
+    const __m256i mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    size_t processed = length - length % 8;
+
+    swapWithShuffle((IFF_UByte*)values, processed * sizeof(IFF_ULong), mask);
+    swapULongsScalar((IFF_ULong*)values + processed, length - processed);
+}
+#endif
+
+#ifdef IFF_SWAP_NEON
+static void swapUWordsNEON(void *values, const size_t length)
+{
+    IFF_UWord *words = (IFF_UWord*)values;
+    size_t i;
+
+    for(i = 0; i + 8 <= length; i += 8)
+        vst1q_u8((uint8_t*)(words + i), vrev16q_u8(vld1q_u8((const uint8_t*)(words + i))));
+
+    swapUWordsScalar(words + i, length - i);
+}
+
+static void swapULongsNEON(void *values, const size_t length)
+{
+    IFF_ULong *longs = (IFF_ULong*)values;
+    size_t i;
+
+    for(i = 0; i + 4 <= length; i += 4)
+        vst1q_u8((uint8_t*)(longs + i), vrev32q_u8(vld1q_u8((const uint8_t*)(longs + i))));
+
+    swapULongsScalar(longs + i, length - i);
+}
+#endif
+
+#if !defined(IFF_SWAP_SSE2) && !defined(IFF_SWAP_NEON)
+static void swapUWordsGeneric(void *values, const size_t length)
+{
+    swapUWordsScalar((IFF_UWord*)values, length);
+}
+
+static void swapULongsGeneric(void *values, const size_t length)
+{
+    swapULongsScalar((IFF_ULong*)values, length);
+}
+#endif
+
+static IFF_SwapFunction swapUWordsFunction = NULL;
+static IFF_SwapFunction swapULongsFunction = NULL;
+
+static void selectSwapFunctions(void)
+{
+    /* Concurrent selections yield the same functions, so no synchronization is needed */
+#if defined(IFF_SWAP_AVX2)
+    if(__builtin_cpu_supports("avx2"))
+    {
+        swapULongsFunction = &swapULongsAVX2;
+        swapUWordsFunction = &swapUWordsAVX2;
+    }
+    else
+    {
+        swapULongsFunction = &swapULongsSSE2;
+        swapUWordsFunction = &swapUWordsSSE2;
+    }
+#elif defined(IFF_SWAP_SSE2)
+    swapULongsFunction = &swapULongsSSE2;
+    swapUWordsFunction = &swapUWordsSSE2;
+#elif defined(IFF_SWAP_NEON)
+    swapULongsFunction = &swapULongsNEON;
+    swapUWordsFunction = &swapUWordsNEON;
+#else
+    swapULongsFunction = &swapULongsGeneric;
+    swapUWordsFunction = &swapUWordsGeneric;
+#endif
+}
+
+void IFF_swapUWords(IFF_UWord *values, const size_t length)
+{
+    if(swapUWordsFunction == NULL)
+        selectSwapFunctions();
+
+    swapUWordsFunction(values, length);
+}
+
+void IFF_swapULongs(IFF_ULong *values, const size_t length)
+{
+    if(swapULongsFunction == NULL)
+        selectSwapFunctions();
+
+    swapULongsFunction(values, length);
+}
+
+#else
+
+void IFF_swapUWords(IFF_UWord *values, const size_t length)
+{
+}
+
+void IFF_swapULongs(IFF_ULong *values, const size_t length)
+{
+}
+
+#endif
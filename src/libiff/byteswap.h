@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_BYTESWAP_H
+#define __IFF_BYTESWAP_H
+
+#include <stddef.h>
+#include "ifftypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Converts an array of words from big-endian to host byte order, or vice
+ * versa, in place. On little-endian hosts, the conversion uses the widest
+ * vector instructions that the CPU supports (NEON, SSE2 or AVX2), which are
+ * selected at runtime. On big-endian hosts it does nothing.
+ *
+ * @param values An array of words
+ * @param length Number of words in the array
+ */
+void IFF_swapUWords(IFF_UWord *values, const size_t length);
+
+/**
+ * Converts an array of longs from big-endian to host byte order, or vice
+ * versa, in place, like IFF_swapUWords().
+ *
+ * @param values An array of longs
+ * @param length Number of longs in the array
+ */
+void IFF_swapULongs(IFF_ULong *values, const size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -65,25 +65,34 @@ static void updateContentsType(IFF_CAT *cat, IFF_Chunk *chunk)
     }
 }
 
-void IFF_addToCAT(IFF_CAT *cat, IFF_Chunk *chunk)
+IFF_Bool IFF_addToCAT(IFF_CAT *cat, IFF_Chunk *chunk)
 {
-    IFF_addToGroup((IFF_Group*)cat, chunk);
+    return IFF_addToGroup((IFF_Group*)cat, chunk);
 }
 
-void IFF_addToCATAndUpdateContentsType(IFF_CAT *cat, IFF_Chunk *chunk)
+IFF_Bool IFF_addToCATAndUpdateContentsType(IFF_CAT *cat, IFF_Chunk *chunk)
 {
+    IFF_ID contentsType = cat->contentsType;
+
     updateContentsType(cat, chunk);
-    IFF_addToCAT(cat, chunk);
+
+    if(IFF_addToCAT(cat, chunk))
+        return TRUE;
+    else
+    {
+        cat->contentsType = contentsType;
+        return FALSE;
+    }
 }
 
-IFF_Bool IFF_readCAT(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool IFF_readCAT(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
-    return IFF_readGroup(file, chunk, CAT_GROUPTYPENAME, chunkRegistry, bytesProcessed);
+    return IFF_readCheckedGroup(stream, chunk, CAT_GROUPTYPENAME, &IFF_checkId, &IFF_checkCATSubChunk, chunkRegistry, bytesProcessed);
 }
 
-IFF_Bool IFF_writeCAT(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool IFF_writeCAT(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
-    return IFF_writeGroup(file, chunk, CAT_GROUPTYPENAME, chunkRegistry, bytesProcessed);
+    return IFF_writeGroup(stream, chunk, CAT_GROUPTYPENAME, chunkRegistry, bytesProcessed);
 }
 
 IFF_Bool IFF_checkCATSubChunk(const IFF_Group *group, const IFF_Chunk *subChunk)
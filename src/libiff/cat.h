@@ -29,7 +29,12 @@ typedef struct IFF_CAT IFF_CAT;
 
 #include <stdio.h>
 #include "ifftypes.h"
+#include "stream.h"
+#include "hash.h"
+#include "arena.h"
 #include "chunk.h"
+#include "lazy.h"
+#include "chunkindex.h"
 
 /**
  * @brief A special group chunk, which contains one or more FORM, LIST or CAT chunks.
@@ -45,6 +50,15 @@ struct IFF_CAT
     /** Contains the size of the chunk data in bytes */
     IFF_Long chunkSize;
 
+    /** Refers to the chunk type that was resolved when the chunk was read, so that it does not have to be looked up again. NULL if it should be looked up in the registry */
+    IFF_ChunkType *chunkType;
+
+    /** Caches the content hash that has been computed by IFF_hashChunk(). Both halves are 0 if it has not been computed, or if it has been invalidated by a modification */
+    IFF_Hash hash;
+
+    /** Refers to the arena from which the chunk has been allocated, or NULL if it has been allocated from the heap. The memory that belongs to the chunk is allocated from the same arena */
+    IFF_Arena *arena;
+
     /**
      * Contains a type ID which hints about the contents of this concatenation.
      * 'JJJJ' is used if this concatenation stores forms of multiple form types.
@@ -58,6 +72,15 @@ struct IFF_CAT
 
     /** An array of chunk pointers referring to the sub chunks */
     IFF_Chunk **chunk;
+
+    /** Contains the number of sub chunks for which the array of chunk pointers has room */
+    unsigned int chunkCapacity;
+
+    /** Keeps track of the sub chunks whose bodies are read on first access, or NULL if all sub chunks have been read */
+    IFF_LazyChunks *lazyChunks;
+
+    /** An index of the sub chunks by chunk id, which is built when the group becomes large enough, or NULL if the sub chunks are scanned */
+    IFF_ChunkIndex *chunkIndex;
 };
 
 #ifdef __cplusplus
@@ -110,8 +133,9 @@ IFF_Chunk *IFF_createUnparsedCAT(const IFF_ID chunkId, const IFF_Long chunkSize)
  *
  * @param cat An instance of a CAT struct
  * @param chunk A FORM, CAT or LIST chunk
+ * @return TRUE if the chunk has been added, or FALSE if the memory for it cannot be allocated. In that case, the chunk remains owned by the caller
  */
-void IFF_addToCAT(IFF_CAT *cat, IFF_Chunk *chunk);
+IFF_Bool IFF_addToCAT(IFF_CAT *cat, IFF_Chunk *chunk);
 
 /**
  * Adds a chunk to the body of the given CAT and updates the contents type.
@@ -121,30 +145,31 @@ void IFF_addToCAT(IFF_CAT *cat, IFF_Chunk *chunk);
  *
  * @param cat An instance of a CAT struct
  * @param chunk A FORM, CAT or LIST chunk
+ * @return TRUE if the chunk has been added, or FALSE if the memory for it cannot be allocated. In that case, the chunk remains owned by the caller
  */
-void IFF_addToCATAndUpdateContentsType(IFF_CAT *cat, IFF_Chunk *chunk);
+IFF_Bool IFF_addToCATAndUpdateContentsType(IFF_CAT *cat, IFF_Chunk *chunk);
 
 /**
- * Reads a concatenation chunk and its sub chunks from a file.
+ * Reads a concatenation chunk and its sub chunks from a stream.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk An instance of a concatenation chunk
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the CAT has been successfully read, or FALSE if an error has occured
  */
-IFF_Bool IFF_readCAT(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_readCAT(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
- * Writes a concatenation chunk and its sub chunks to a file.
+ * Writes a concatenation chunk and its sub chunks to a stream.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk An instance of a concatenation chunk
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the CAT has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeCAT(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_writeCAT(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
  * Checks a sub chunk in a CAT for its validity.
@@ -26,95 +26,179 @@
 #include "id.h"
 #include "util.h"
 #include "error.h"
+#include "context.h"
+#include "arena.h"
 
 #define ID_EMPTY IFF_MAKEID(' ', ' ', ' ', ' ')
 
 IFF_Chunk *IFF_createChunk(const IFF_ID chunkId, const IFF_Long chunkSize, size_t structSize)
 {
-    IFF_Chunk *chunk = (IFF_Chunk*)malloc(structSize);
+    IFF_Arena *arena = IFF_getSelectedArena();
+    IFF_Chunk *chunk = (IFF_Chunk*)IFF_allocateIn(arena, structSize);
 
     if(chunk != NULL)
     {
         chunk->parent = NULL;
         chunk->chunkId = chunkId;
         chunk->chunkSize = chunkSize;
+        chunk->chunkType = NULL;
+        chunk->hash.high = 0;
+        chunk->hash.low = 0;
+        chunk->arena = arena;
     }
 
     return chunk;
 }
 
-static IFF_Chunk *readChunkBody(FILE *file, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
+IFF_Chunk *IFF_readChunkBody(IFF_IOStream *stream, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
 {
     IFF_ChunkType *chunkType = IFF_findChunkType(chunkRegistry, formType, chunkId);
-    IFF_Chunk *chunk = chunkType->createExtensionChunk(chunkId, chunkSize);
+    IFF_Chunk *chunk;
 
-    if(chunk != NULL)
+    IFF_enterChunk(stream, chunkId);
+
+    chunk = chunkType->createExtensionChunk(chunkId, chunkSize);
+
+    if(chunk == NULL)
+        IFF_recordError(IFF_ERROR_MEMORY);
+    else
     {
         IFF_Long bytesProcessed = 0;
 
+        /* Remember the chunk type, so that subsequent operations do not have to look it up again */
+        chunk->chunkType = chunkType;
+
         /* Read remaining bytes (procedure depends on chunk id type) */
-        if(!chunkType->readExtensionChunkFields(file, chunk, chunkRegistry, &bytesProcessed)
-            || !IFF_skipUnknownBytes(file, chunk->chunkId, chunkSize, bytesProcessed)
-            || !IFF_readPaddingByte(file, chunkSize, chunk->chunkId))
+        if(!chunkType->readExtensionChunkFields(stream, chunk, chunkRegistry, &bytesProcessed)
+            || !IFF_skipUnknownBytes(stream, chunk->chunkId, chunkSize, bytesProcessed)
+            || !IFF_readPaddingByte(stream, chunkSize, chunk->chunkId))
         {
+            /* Only recorded if a more specific error has not been recorded yet */
+            IFF_recordError(IFF_ERROR_INVALID);
             IFF_freeChunk(chunk, formType, chunkRegistry);
-            return NULL;
+            chunk = NULL;
         }
     }
 
+    IFF_leaveChunk();
     return chunk;
 }
 
-IFF_Chunk *IFF_readChunk(FILE *file, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
+IFF_Bool IFF_readChunkHeader(IFF_IOStream *stream, IFF_ID *chunkId, IFF_Long *chunkSize)
+{
+    if(!IFF_readId(stream, chunkId, ID_EMPTY, "")
+        || !IFF_readLong(stream, chunkSize, *chunkId, "chunkSize"))
+        return FALSE;
+
+    /* When validating, an invalid chunk ID is rejected before its body is read */
+    if(IFF_getValidateOnRead() && !IFF_checkId(*chunkId))
+    {
+        IFF_recordError(IFF_ERROR_INVALID);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+IFF_Chunk *IFF_readChunk(IFF_IOStream *stream, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
 {
     IFF_ID chunkId;
     IFF_Long chunkSize;
 
-    if(!IFF_readId(file, &chunkId, ID_EMPTY, "")
-        || !IFF_readLong(file, &chunkSize, chunkId, "chunkSize"))
+    if(!IFF_readChunkHeader(stream, &chunkId, &chunkSize))
         return NULL;
 
-    return readChunkBody(file, chunkId, chunkSize, formType, chunkRegistry);
+    return IFF_readChunkBody(stream, chunkId, chunkSize, formType, chunkRegistry);
 }
 
-static IFF_Bool writeChunkBody(FILE *file, const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
+IFF_Chunk *IFF_readSubChunk(IFF_IOStream *stream, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Long bytesAvailable)
 {
-    IFF_ChunkType *chunkType = IFF_findChunkType(chunkRegistry, formType, chunk->chunkId);
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+
+    if(!IFF_readChunkHeader(stream, &chunkId, &chunkSize))
+        return NULL;
+
+    /* When validating, a sub chunk that does not fit in its group is rejected before its body is read */
+    if(IFF_getValidateOnRead()
+        && (chunkSize < 0 || chunkSize > bytesAvailable - IFF_ID_SIZE - (IFF_Long)sizeof(IFF_Long) - chunkSize % 2))
+    {
+        IFF_recordError(IFF_ERROR_INVALID);
+        IFF_error("Chunk: '");
+        IFF_errorId(chunkId);
+        IFF_error("' with size: %d does not fit in the remaining: %d bytes of its group!\n", chunkSize, bytesAvailable);
+        return NULL;
+    }
+
+    return IFF_readChunkBody(stream, chunkId, chunkSize, formType, chunkRegistry);
+}
+
+static IFF_ChunkType *getChunkType(const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
+{
+    if(chunk->chunkType == NULL)
+        return IFF_findChunkType(chunkRegistry, formType, chunk->chunkId);
+    else
+        return chunk->chunkType;
+}
+
+static IFF_Bool writeChunkBody(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_ChunkType *chunkType = getChunkType(chunk, formType, chunkRegistry);
     IFF_Long bytesProcessed = 0;
 
-    return chunkType->writeExtensionChunkFields(file, chunk, chunkRegistry, &bytesProcessed)
-        && IFF_writeZeroFillerBytes(file, chunk->chunkId, chunk->chunkSize, bytesProcessed)
-        && IFF_writePaddingByte(file, chunk->chunkSize, chunk->chunkId);
+    return chunkType->writeExtensionChunkFields(stream, chunk, chunkRegistry, &bytesProcessed)
+        && IFF_writeZeroFillerBytes(stream, chunk->chunkId, chunk->chunkSize, bytesProcessed)
+        && IFF_writePaddingByte(stream, chunk->chunkSize, chunk->chunkId);
 }
 
-IFF_Bool IFF_writeChunk(FILE *file, const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
+IFF_Bool IFF_writeChunk(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
 {
-    return IFF_writeId(file, chunk->chunkId, chunk->chunkId, "chunkId")
-        && IFF_writeLong(file, chunk->chunkSize, chunk->chunkId, "chunkSize")
-        && writeChunkBody(file, chunk, formType, chunkRegistry);
+    IFF_Bool status;
+
+    IFF_enterChunk(stream, chunk->chunkId);
+
+    status = IFF_writeId(stream, chunk->chunkId, chunk->chunkId, "chunkId")
+        && IFF_writeLong(stream, chunk->chunkSize, chunk->chunkId, "chunkSize")
+        && writeChunkBody(stream, chunk, formType, chunkRegistry);
+
+    if(!status)
+        IFF_recordError(IFF_ERROR_WRITE);
+
+    IFF_leaveChunk();
+    return status;
 }
 
 IFF_Bool IFF_checkChunk(const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
 {
+    IFF_Bool status;
+
+    IFF_enterChunk(NULL, chunk->chunkId);
+
     if(!IFF_checkId(chunk->chunkId))
-        return FALSE;
+        status = FALSE;
     else
     {
-        IFF_ChunkType *chunkType = IFF_findChunkType(chunkRegistry, formType, chunk->chunkId);
-        return chunkType->checkExtensionChunk(chunk, chunkRegistry);
+        IFF_ChunkType *chunkType = getChunkType(chunk, formType, chunkRegistry);
+        status = chunkType->checkExtensionChunk(chunk, chunkRegistry);
     }
+
+    if(!status)
+        IFF_recordError(IFF_ERROR_INVALID);
+
+    IFF_leaveChunk();
+    return status;
 }
 
 void IFF_freeChunk(IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
 {
-    IFF_ChunkType *chunkType = IFF_findChunkType(chunkRegistry, formType, chunk->chunkId);
+    IFF_ChunkType *chunkType = getChunkType(chunk, formType, chunkRegistry);
     chunkType->freeExtensionChunk(chunk, chunkRegistry);
-    free(chunk);
+    IFF_deallocateIn(chunk->arena, chunk);
 }
 
 void IFF_printChunk(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
 {
-    IFF_ChunkType *chunkType = IFF_findChunkType(chunkRegistry, formType, chunk->chunkId);
+    IFF_ChunkType *chunkType = getChunkType(chunk, formType, chunkRegistry);
 
     IFF_printIndent(stdout, indentLevel, "'");
     IFF_printId(chunk->chunkId);
@@ -124,13 +208,61 @@ void IFF_printChunk(const IFF_Chunk *chunk, const unsigned int indentLevel, cons
     IFF_printIndent(stdout, indentLevel, "}\n\n");
 }
 
+static IFF_Bool hasHash(const IFF_Chunk *chunk)
+{
+    return chunk->hash.high != 0 || chunk->hash.low != 0;
+}
+
 IFF_Bool IFF_compareChunk(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
 {
+    /* Chunks with different hashes cannot be equal. Equal hashes are not conclusive, so the contents are compared anyway */
+    if(hasHash(chunk1) && hasHash(chunk2) && !IFF_compareHash(chunk1->hash, chunk2->hash))
+        return FALSE;
+
     if(chunk1->chunkId == chunk2->chunkId && chunk1->chunkSize == chunk2->chunkSize)
     {
-        IFF_ChunkType *chunkType = IFF_findChunkType(chunkRegistry, formType, chunk1->chunkId);
+        IFF_ChunkType *chunkType = getChunkType(chunk1, formType, chunkRegistry);
         return chunkType->compareExtensionChunk(chunk1, chunk2, chunkRegistry);
     }
     else
         return FALSE;
 }
+
+IFF_Hash IFF_hashChunk(const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
+{
+    if(!hasHash(chunk))
+    {
+        IFF_Hash hash;
+
+        if(IFF_isGroupChunk(chunk))
+            hash = IFF_hashGroup((const IFF_Group*)chunk, chunkRegistry);
+        else
+        {
+            /* A data chunk is hashed by writing it, so that chunk types do not need a hash function of their own */
+            IFF_HashIOStream stream;
+
+            IFF_initHashIOStream(&stream);
+            IFF_writeChunk((IFF_IOStream*)&stream, chunk, formType, chunkRegistry);
+            hash = IFF_finishHasher(&stream.hasher);
+        }
+
+        /* A hash of 0 indicates that it has not been computed */
+        if(hash.high == 0 && hash.low == 0)
+            hash.low = 1;
+
+        ((IFF_Chunk*)chunk)->hash = hash;
+    }
+
+    return chunk->hash;
+}
+
+void IFF_invalidateChunkHash(IFF_Chunk *chunk)
+{
+    /* The hashes of the enclosing groups are derived from this hash. If a chunk has no hash, its enclosing groups have none either */
+    while(chunk != NULL && hasHash(chunk))
+    {
+        chunk->hash.high = 0;
+        chunk->hash.low = 0;
+        chunk = (IFF_Chunk*)chunk->parent;
+    }
+}
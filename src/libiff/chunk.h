@@ -26,6 +26,9 @@ typedef struct IFF_Chunk IFF_Chunk;
 
 #include <stdio.h>
 #include "ifftypes.h"
+#include "stream.h"
+#include "hash.h"
+#include "arena.h"
 #include "chunkregistry.h"
 #include "group.h"
 
@@ -42,6 +45,15 @@ struct IFF_Chunk
 
     /** Contains the size of the chunk data in bytes */
     IFF_Long chunkSize;
+
+    /** Refers to the chunk type that was resolved when the chunk was read, so that it does not have to be looked up again. NULL if it should be looked up in the registry */
+    IFF_ChunkType *chunkType;
+
+    /** Caches the content hash that has been computed by IFF_hashChunk(). Both halves are 0 if it has not been computed, or if it has been invalidated by a modification */
+    IFF_Hash hash;
+
+    /** Refers to the arena from which the chunk has been allocated, or NULL if it has been allocated from the heap. The memory that belongs to the chunk is allocated from the same arena */
+    IFF_Arena *arena;
 };
 
 #ifdef __cplusplus
@@ -60,25 +72,62 @@ extern "C" {
 IFF_Chunk *IFF_createChunk(const IFF_ID chunkId, IFF_Long chunkSize, size_t structSize);
 
 /**
- * Reads a chunk hierarchy from a given file descriptor. The resulting chunk must be freed using IFF_free()
+ * Reads the body of a chunk, of which the chunk id and chunk size have already
+ * been read from the given stream. The resulting chunk must be freed using IFF_free()
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
+ * @param chunkId A 4 character chunk id
+ * @param chunkSize Size of the chunk body in bytes
  * @param formType Form type id describing in which FORM the sub chunk is located. 0 is used for sub chunks in other group chunks.
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
- * @return A chunk hierarchy derived from the IFF file, or NULL if an error occurs
+ * @return A chunk hierarchy derived from the IFF stream, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readChunkBody(IFF_IOStream *stream, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Reads the header of a chunk from a given stream. If validate-on-read has
+ * been enabled with IFF_selectValidateOnRead(), the chunk ID is checked as well.
+ *
+ * @param stream An I/O stream
+ * @param chunkId Variable in which the 4 character chunk ID is stored
+ * @param chunkSize Variable in which the size of the chunk body is stored
+ * @return TRUE if the header has been successfully read, else FALSE
  */
-IFF_Chunk *IFF_readChunk(FILE *file, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry);
+IFF_Bool IFF_readChunkHeader(IFF_IOStream *stream, IFF_ID *chunkId, IFF_Long *chunkSize);
 
 /**
- * Writes a chunk hierarchy to a given file descriptor.
+ * Reads a chunk hierarchy from a given stream. The resulting chunk must be freed using IFF_free()
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
+ * @param formType Form type id describing in which FORM the sub chunk is located. 0 is used for sub chunks in other group chunks.
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return A chunk hierarchy derived from the IFF stream, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readChunk(IFF_IOStream *stream, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Reads a sub chunk of a group from a given stream. If validate-on-read has
+ * been enabled with IFF_selectValidateOnRead(), a sub chunk whose size exceeds
+ * the remaining bytes of the group is rejected before its body is read.
+ *
+ * @param stream An I/O stream
+ * @param formType Form type id describing in which FORM the sub chunk is located. 0 is used for sub chunks in other group chunks.
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param bytesAvailable The amount of bytes of the group body that have not been processed yet
+ * @return A chunk hierarchy derived from the IFF stream, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readSubChunk(IFF_IOStream *stream, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Long bytesAvailable);
+
+/**
+ * Writes a chunk hierarchy to a given stream.
+ *
+ * @param stream An I/O stream
  * @param chunk A chunk hierarchy representing an IFF file
  * @param formType Form type id describing in which FORM the sub chunk is located. NULL is used for sub chunks in other group chunks.
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
- * @return TRUE if the file has been successfully written, else FALSE
+ * @return TRUE if the chunk has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeChunk(FILE *file, const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry);
+IFF_Bool IFF_writeChunk(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry);
 
 /**
  * Checks whether a chunk hierarchy conforms to the IFF specification.
@@ -120,6 +169,29 @@ void IFF_printChunk(const IFF_Chunk *chunk, const unsigned int indentLevel, cons
  */
 IFF_Bool IFF_compareChunk(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry);
 
+/**
+ * Computes a 64-bit content hash of a chunk hierarchy, covering the chunk IDs,
+ * chunk sizes and contents. The hash of a group chunk is derived from the
+ * hashes of its sub chunks. The hashes are cached in the chunks, so that they
+ * are only computed again after a modification through the library, such as
+ * IFF_addToGroup() or IFF_setRawChunkData(). Equal chunk hierarchies have
+ * equal hashes, so that a hash can be used as a key to find duplicates.
+ *
+ * @param chunk A chunk hierarchy
+ * @param formType Form type id describing in which FORM the sub chunk is located. 0 is used for sub chunks in other group chunks.
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return The hash of the chunk hierarchy
+ */
+IFF_Hash IFF_hashChunk(const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Discards the cached hashes of a chunk and its enclosing groups. It must be
+ * invoked after the members of a chunk have been modified directly.
+ *
+ * @param chunk A chunk of which the contents have been modified
+ */
+void IFF_invalidateChunkHash(IFF_Chunk *chunk);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "chunkindex.h"
+#include "arena.h"
+
+/* Groups with fewer sub chunks are scanned, because that is cheaper than maintaining an index */
+#define IFF_CHUNK_INDEX_THRESHOLD 16
+
+#define IFF_INITIAL_SLOTS_COUNT 8
+
+#define IFF_INITIAL_POSITIONS_CAPACITY 2
+
+static unsigned int hashChunkId(const IFF_ID chunkId)
+{
+    unsigned int hash = chunkId * 0x9e3779b1U;
+    return hash ^ (hash >> 16);
+}
+
+static IFF_ChunkIndexSlot *getChunkIndexSlot(const IFF_ChunkIndex *chunkIndex, const IFF_ID chunkId)
+{
+    unsigned int i = hashChunkId(chunkId) & chunkIndex->slotMask;
+
+    /* The table is never full, so the probe sequence always ends in a matching or a free slot */
+    while(chunkIndex->slot[i].positions != NULL && chunkIndex->slot[i].chunkId != chunkId)
+        i = (i + 1) & chunkIndex->slotMask;
+
+    return &chunkIndex->slot[i];
+}
+
+static IFF_Bool enlargeChunkIndex(IFF_ChunkIndex *chunkIndex)
+{
+    IFF_ChunkIndexSlot *previousSlot = chunkIndex->slot;
+    unsigned int previousSlotsCount = chunkIndex->slotMask + 1;
+    unsigned int slotsCount = previousSlotsCount * 2;
+    unsigned int i;
+
+    if((chunkIndex->slot = (IFF_ChunkIndexSlot*)IFF_allocateIn(chunkIndex->arena, slotsCount * sizeof(IFF_ChunkIndexSlot))) == NULL)
+    {
+        chunkIndex->slot = previousSlot;
+        return FALSE;
+    }
+
+    chunkIndex->slotMask = slotsCount - 1;
+
+    for(i = 0; i < slotsCount; i++)
+        chunkIndex->slot[i].positions = NULL;
+
+    /* Move the slots to their positions in the enlarged table */
+    for(i = 0; i < previousSlotsCount; i++)
+    {
+        if(previousSlot[i].positions != NULL)
+            *getChunkIndexSlot(chunkIndex, previousSlot[i].chunkId) = previousSlot[i];
+    }
+
+    IFF_deallocateIn(chunkIndex->arena, previousSlot);
+    return TRUE;
+}
+
+static IFF_Bool addPosition(IFF_ChunkIndex *chunkIndex, const IFF_ID chunkId, const unsigned int position)
+{
+    IFF_ChunkIndexSlot *slot = getChunkIndexSlot(chunkIndex, chunkId);
+
+    if(slot->positions == NULL)
+    {
+        /* Keep the load factor at most 50%, so that probe sequences stay short */
+        if((chunkIndex->slotsLength + 1) * 2 > chunkIndex->slotMask + 1)
+        {
+            if(!enlargeChunkIndex(chunkIndex))
+                return FALSE;
+
+            slot = getChunkIndexSlot(chunkIndex, chunkId);
+        }
+
+        if((slot->positions = (unsigned int*)IFF_allocateIn(chunkIndex->arena, IFF_INITIAL_POSITIONS_CAPACITY * sizeof(unsigned int))) == NULL)
+            return FALSE;
+
+        slot->chunkId = chunkId;
+        slot->positionsLength = 0;
+        slot->positionsCapacity = IFF_INITIAL_POSITIONS_CAPACITY;
+        chunkIndex->slotsLength++;
+    }
+    else if(slot->positionsLength == slot->positionsCapacity)
+    {
+        /* Double the capacity, so that adding N positions takes a logarithmic amount of reallocations */
+        unsigned int *positions = (unsigned int*)IFF_reallocateIn(chunkIndex->arena, slot->positions, slot->positionsCapacity * sizeof(unsigned int), slot->positionsCapacity * 2 * sizeof(unsigned int));
+
+        if(positions == NULL)
+            return FALSE;
+
+        slot->positions = positions;
+        slot->positionsCapacity *= 2;
+    }
+
+    slot->positions[slot->positionsLength] = position;
+    slot->positionsLength++;
+    return TRUE;
+}
+
+static IFF_ChunkIndex *createChunkIndex(IFF_Arena *arena)
+{
+    IFF_ChunkIndex *chunkIndex = (IFF_ChunkIndex*)IFF_allocateIn(arena, sizeof(IFF_ChunkIndex));
+    unsigned int i;
+
+    if(chunkIndex == NULL)
+        return NULL;
+
+    /* Groups often contain many chunks with the same few chunk ids, so start small and let the table grow */
+    if((chunkIndex->slot = (IFF_ChunkIndexSlot*)IFF_allocateIn(arena, IFF_INITIAL_SLOTS_COUNT * sizeof(IFF_ChunkIndexSlot))) == NULL)
+    {
+        IFF_deallocateIn(arena, chunkIndex);
+        return NULL;
+    }
+
+    chunkIndex->arena = arena;
+
+    chunkIndex->slotMask = IFF_INITIAL_SLOTS_COUNT - 1;
+    chunkIndex->slotsLength = 0;
+
+    for(i = 0; i < IFF_INITIAL_SLOTS_COUNT; i++)
+        chunkIndex->slot[i].positions = NULL;
+
+    return chunkIndex;
+}
+
+static void freeChunkIndex(IFF_ChunkIndex *chunkIndex)
+{
+    unsigned int i;
+
+    for(i = 0; i <= chunkIndex->slotMask; i++)
+        IFF_deallocateIn(chunkIndex->arena, chunkIndex->slot[i].positions);
+
+    IFF_deallocateIn(chunkIndex->arena, chunkIndex->slot);
+    IFF_deallocateIn(chunkIndex->arena, chunkIndex);
+}
+
+static IFF_ChunkIndex *buildChunkIndex(const IFF_Group *group)
+{
+    IFF_ChunkIndex *chunkIndex = createChunkIndex(group->arena);
+    unsigned int i;
+
+    if(chunkIndex == NULL)
+        return NULL;
+
+    for(i = 0; i < group->chunkLength; i++)
+    {
+        if(!addPosition(chunkIndex, group->chunk[i]->chunkId, i))
+        {
+            freeChunkIndex(chunkIndex);
+            return NULL;
+        }
+    }
+
+    return chunkIndex;
+}
+
+IFF_Bool IFF_indexGroup(IFF_Group *group)
+{
+    IFF_freeChunkIndex(group);
+
+    if(group->chunkLength < IFF_CHUNK_INDEX_THRESHOLD)
+        return TRUE;
+    else
+        return (group->chunkIndex = buildChunkIndex(group)) != NULL;
+}
+
+IFF_Bool IFF_getChunkIndexPositions(const IFF_Group *group, const IFF_ID chunkId, const unsigned int **positions, unsigned int *positionsLength)
+{
+    if(group->chunkIndex == NULL)
+        return FALSE;
+    else
+    {
+        IFF_ChunkIndexSlot *slot = getChunkIndexSlot(group->chunkIndex, chunkId);
+
+        *positions = slot->positions;
+        *positionsLength = slot->positions == NULL ? 0 : slot->positionsLength;
+        return TRUE;
+    }
+}
+
+void IFF_updateChunkIndex(IFF_Group *group, const unsigned int index)
+{
+    if(group->chunkIndex == NULL)
+    {
+        /* Index the group as soon as it is large enough, so that lookups never have to build it */
+        if(group->chunkLength == IFF_CHUNK_INDEX_THRESHOLD)
+            IFF_indexGroup(group);
+    }
+    else if(!addPosition(group->chunkIndex, group->chunk[index]->chunkId, index))
+        IFF_freeChunkIndex(group);
+}
+
+void IFF_freeChunkIndex(IFF_Group *group)
+{
+    if(group->chunkIndex != NULL)
+    {
+        freeChunkIndex(group->chunkIndex);
+        group->chunkIndex = NULL;
+    }
+}
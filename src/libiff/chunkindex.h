@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_CHUNKINDEX_H
+#define __IFF_CHUNKINDEX_H
+
+typedef struct IFF_ChunkIndex IFF_ChunkIndex;
+
+#include "ifftypes.h"
+#include "chunk.h"
+#include "group.h"
+
+/**
+ * @brief Refers to the positions of all sub chunks of a group that have a certain chunk id. A slot is free if its positions array is NULL.
+ */
+typedef struct
+{
+    /** A 4 character chunk id */
+    IFF_ID chunkId;
+
+    /** Contains the number of positions */
+    unsigned int positionsLength;
+
+    /** Contains the number of positions for which the array has room */
+    unsigned int positionsCapacity;
+
+    /** The indices of the sub chunks with the chunk id, in ascending order */
+    unsigned int *positions;
+}
+IFF_ChunkIndexSlot;
+
+/**
+ * @brief An index of the sub chunks of a group chunk, which maps chunk ids to the positions of the sub chunks that have them.
+ */
+struct IFF_ChunkIndex
+{
+    /** Number of slots minus one. The amount of slots is always a power of two. */
+    unsigned int slotMask;
+
+    /** Contains the number of slots that are in use */
+    unsigned int slotsLength;
+
+    /** An open-addressing hash table of slots */
+    IFF_ChunkIndexSlot *slot;
+
+    /** Refers to the arena from which the index has been allocated, which is the arena of its group, or NULL if it has been allocated from the heap */
+    IFF_Arena *arena;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Builds the index of a group chunk from its sub chunks, replacing the existing
+ * index. Small groups are not indexed, because scanning them is cheaper. The
+ * index is allocated from the arena of the group.
+ *
+ * The readers and the functions that modify groups keep the index up to date,
+ * so this function only has to be called after modifying the sub chunk array
+ * of a group directly.
+ *
+ * @param group A group chunk instance
+ * @return TRUE if the group has been indexed or is too small to be indexed, or FALSE if the memory for the index cannot be allocated
+ */
+IFF_Bool IFF_indexGroup(IFF_Group *group);
+
+/**
+ * Retrieves the positions of the sub chunks of a group that have the given
+ * chunk id from the index of the group. Lookups do not modify the group, so
+ * that multiple threads can look up chunks in the same group simultaneously.
+ *
+ * The resulting array belongs to the index and remains valid until the group is
+ * modified.
+ *
+ * @param group A group chunk instance
+ * @param chunkId A 4 character chunk id
+ * @param positions Returns an array of sub chunk indices in ascending order, or NULL if there are none
+ * @param positionsLength Returns the length of the positions array
+ * @return TRUE if the group has been indexed, or FALSE if the sub chunks must be scanned instead
+ */
+IFF_Bool IFF_getChunkIndexPositions(const IFF_Group *group, const IFF_ID chunkId, const unsigned int **positions, unsigned int *positionsLength);
+
+/**
+ * Records a sub chunk that has been attached to the end of a group in its index.
+ * The index is built when the group becomes large enough to be indexed, and it
+ * is discarded if it cannot be enlarged.
+ *
+ * @param group A group chunk instance
+ * @param index Index of the attached sub chunk
+ */
+void IFF_updateChunkIndex(IFF_Group *group, const unsigned int index);
+
+/**
+ * Discards the index of a group chunk, so that its sub chunks are scanned.
+ *
+ * @param group A group chunk instance
+ */
+void IFF_freeChunkIndex(IFF_Group *group);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
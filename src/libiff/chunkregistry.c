@@ -22,8 +22,40 @@
 #include "chunkregistry.h"
 #include <stdlib.h>
 #include "id.h"
+#include "error.h"
 #include "rawchunk.h"
 
+/**
+ * @brief A slot in the hash table of a compiled registry. A slot is free if its chunk type is NULL.
+ */
+typedef struct
+{
+    /** A 4 character form type id, or 0 for the global chunk types */
+    IFF_ID formType;
+
+    /** A 4 character chunk id */
+    IFF_ID chunkId;
+
+    /** The chunk type that the (formType, chunkId) pair resolves to */
+    IFF_ChunkType *chunkType;
+}
+IFF_ChunkTypeSlot;
+
+struct IFF_CompiledChunkTypes
+{
+    /** Number of slots in the chunk type table minus one. The amount of slots is always a power of two. */
+    unsigned int chunkTypeSlotMask;
+
+    /** An open-addressing hash table mapping (formType, chunkId) pairs to chunk types */
+    IFF_ChunkTypeSlot *chunkTypeSlot;
+
+    /** Number of slots in the form type table minus one. The amount of slots is always a power of two. */
+    unsigned int formTypeSlotMask;
+
+    /** An open-addressing hash table containing the form types that have their own chunk types. A slot is free if it is 0. */
+    IFF_ID *formTypeSlot;
+};
+
 static int compareFormChunkTypes(const void *a, const void *b)
 {
     const IFF_FormChunkTypes *l = (IFF_FormChunkTypes*)a;
@@ -82,10 +114,56 @@ static IFF_ChunkType *getChunkType(const IFF_ID chunkId, const IFF_ChunkTypesNod
     }
 }
 
+static unsigned int hashIds(const IFF_ID formType, const IFF_ID chunkId)
+{
+    unsigned int hash = (formType * 0x9e3779b1U) ^ chunkId;
+    hash = (hash ^ (hash >> 16)) * 0x85ebca6bU;
+    return hash ^ (hash >> 13);
+}
+
+static IFF_ChunkTypeSlot *getChunkTypeSlot(const IFF_CompiledChunkTypes *compiledChunkTypes, const IFF_ID formType, const IFF_ID chunkId)
+{
+    unsigned int i = hashIds(formType, chunkId) & compiledChunkTypes->chunkTypeSlotMask;
+
+    /* The table is never full, so the probe sequence always ends in a matching or a free slot */
+    while(compiledChunkTypes->chunkTypeSlot[i].chunkType != NULL
+        && (compiledChunkTypes->chunkTypeSlot[i].formType != formType || compiledChunkTypes->chunkTypeSlot[i].chunkId != chunkId))
+        i = (i + 1) & compiledChunkTypes->chunkTypeSlotMask;
+
+    return &compiledChunkTypes->chunkTypeSlot[i];
+}
+
+static IFF_ID *getFormTypeSlot(const IFF_CompiledChunkTypes *compiledChunkTypes, const IFF_ID formType)
+{
+    unsigned int i = hashIds(formType, 0) & compiledChunkTypes->formTypeSlotMask;
+
+    while(compiledChunkTypes->formTypeSlot[i] != 0 && compiledChunkTypes->formTypeSlot[i] != formType)
+        i = (i + 1) & compiledChunkTypes->formTypeSlotMask;
+
+    return &compiledChunkTypes->formTypeSlot[i];
+}
+
+static IFF_ChunkType *findCompiledChunkType(const IFF_ChunkRegistry *chunkRegistry, const IFF_ID formType, const IFF_ID chunkId)
+{
+    const IFF_CompiledChunkTypes *compiledChunkTypes = chunkRegistry->compiledChunkTypes;
+    IFF_ChunkType *result = getChunkTypeSlot(compiledChunkTypes, formType, chunkId)->chunkType;
+
+    /* If the form type has no chunk types of its own, then the global chunk types apply */
+    if(result == NULL && formType != 0 && *getFormTypeSlot(compiledChunkTypes, formType) == 0)
+        result = getChunkTypeSlot(compiledChunkTypes, 0, chunkId)->chunkType;
+
+    if(result == NULL)
+        return chunkRegistry->defaultChunkType;
+    else
+        return result;
+}
+
 IFF_ChunkType *IFF_findChunkType(const IFF_ChunkRegistry *chunkRegistry, const IFF_ID formType, const IFF_ID chunkId)
 {
     if(chunkRegistry == NULL)
         return NULL;
+    else if(chunkRegistry->compiledChunkTypes != NULL)
+        return findCompiledChunkType(chunkRegistry, formType, chunkId);
     else
     {
         /* Search for the requested FORM chunk types */
@@ -103,3 +181,180 @@ IFF_ChunkType *IFF_findChunkType(const IFF_ChunkRegistry *chunkRegistry, const I
             return result;
     }
 }
+
+static IFF_Bool checkChunkTypesNodes(const IFF_ChunkTypesNode *chunkTypesNode, unsigned int *chunkTypesLength)
+{
+    while(chunkTypesNode != NULL)
+    {
+        unsigned int i;
+
+        for(i = 1; i < chunkTypesNode->chunkTypesLength; i++)
+        {
+            IFF_ID previousChunkId = chunkTypesNode->chunkTypes[i - 1].chunkId;
+            IFF_ID chunkId = chunkTypesNode->chunkTypes[i].chunkId;
+
+            if(previousChunkId >= chunkId)
+            {
+                IFF_error("Chunk type: '");
+                IFF_errorId(chunkId);
+
+                if(previousChunkId == chunkId)
+                    IFF_error("' occurs multiple times in the same chunk types node!\n");
+                else
+                {
+                    IFF_error("' is not sorted: it should not follow: '");
+                    IFF_errorId(previousChunkId);
+                    IFF_error("'\n");
+                }
+
+                return FALSE;
+            }
+        }
+
+        *chunkTypesLength += chunkTypesNode->chunkTypesLength;
+        chunkTypesNode = chunkTypesNode->parent;
+    }
+
+    return TRUE;
+}
+
+static IFF_Bool checkChunkRegistry(const IFF_ChunkRegistry *chunkRegistry, unsigned int *chunkTypesLength)
+{
+    unsigned int i;
+
+    *chunkTypesLength = 0;
+
+    for(i = 0; i < chunkRegistry->formChunkTypesLength; i++)
+    {
+        const IFF_FormChunkTypes *formChunkTypes = &chunkRegistry->formChunkTypes[i];
+
+        if(formChunkTypes->formType == 0)
+        {
+            IFF_error("A form type of 0 cannot have its own chunk types!\n");
+            return FALSE;
+        }
+
+        if(i > 0 && chunkRegistry->formChunkTypes[i - 1].formType >= formChunkTypes->formType)
+        {
+            IFF_ID previousFormType = chunkRegistry->formChunkTypes[i - 1].formType;
+
+            IFF_error("Form type: '");
+            IFF_errorId(formChunkTypes->formType);
+
+            if(previousFormType == formChunkTypes->formType)
+                IFF_error("' occurs multiple times in the registry!\n");
+            else
+            {
+                IFF_error("' is not sorted: it should not follow: '");
+                IFF_errorId(previousFormType);
+                IFF_error("'\n");
+            }
+
+            return FALSE;
+        }
+
+        if(!checkChunkTypesNodes(formChunkTypes->chunkTypesNode, chunkTypesLength))
+            return FALSE;
+    }
+
+    return checkChunkTypesNodes(chunkRegistry->globalChunkTypesNode, chunkTypesLength);
+}
+
+static unsigned int computeSlotMask(const unsigned int length)
+{
+    unsigned int slots = 8;
+
+    /* Keep the load factor at most 50% */
+    while(slots < 2 * length)
+        slots *= 2;
+
+    return slots - 1;
+}
+
+static void insertChunkTypes(IFF_CompiledChunkTypes *compiledChunkTypes, const IFF_ID formType, const IFF_ChunkTypesNode *chunkTypesNode)
+{
+    /* Nodes are visited from the nearest to the farthest parent, so that the nearest definition of a chunk id wins, like IFF_findChunkType() does */
+    while(chunkTypesNode != NULL)
+    {
+        unsigned int i;
+
+        for(i = 0; i < chunkTypesNode->chunkTypesLength; i++)
+        {
+            IFF_ChunkTypeSlot *slot = getChunkTypeSlot(compiledChunkTypes, formType, chunkTypesNode->chunkTypes[i].chunkId);
+
+            if(slot->chunkType == NULL)
+            {
+                slot->formType = formType;
+                slot->chunkId = chunkTypesNode->chunkTypes[i].chunkId;
+                slot->chunkType = &chunkTypesNode->chunkTypes[i];
+            }
+        }
+
+        chunkTypesNode = chunkTypesNode->parent;
+    }
+}
+
+IFF_ChunkRegistry *IFF_compileChunkRegistry(const IFF_ChunkRegistry *chunkRegistry)
+{
+    unsigned int chunkTypesLength;
+    IFF_ChunkRegistry *compiledChunkRegistry;
+    IFF_CompiledChunkTypes *compiledChunkTypes;
+    unsigned int i;
+
+    if(!checkChunkRegistry(chunkRegistry, &chunkTypesLength))
+        return NULL;
+
+    compiledChunkRegistry = (IFF_ChunkRegistry*)malloc(sizeof(IFF_ChunkRegistry));
+
+    if(compiledChunkRegistry == NULL)
+        return NULL;
+
+    compiledChunkTypes = (IFF_CompiledChunkTypes*)malloc(sizeof(IFF_CompiledChunkTypes));
+
+    if(compiledChunkTypes == NULL)
+    {
+        free(compiledChunkRegistry);
+        return NULL;
+    }
+
+    compiledChunkTypes->chunkTypeSlotMask = computeSlotMask(chunkTypesLength);
+    compiledChunkTypes->chunkTypeSlot = (IFF_ChunkTypeSlot*)calloc(compiledChunkTypes->chunkTypeSlotMask + 1, sizeof(IFF_ChunkTypeSlot));
+    compiledChunkTypes->formTypeSlotMask = computeSlotMask(chunkRegistry->formChunkTypesLength);
+    compiledChunkTypes->formTypeSlot = (IFF_ID*)calloc(compiledChunkTypes->formTypeSlotMask + 1, sizeof(IFF_ID));
+
+    if(compiledChunkTypes->chunkTypeSlot == NULL || compiledChunkTypes->formTypeSlot == NULL)
+    {
+        free(compiledChunkTypes->chunkTypeSlot);
+        free(compiledChunkTypes->formTypeSlot);
+        free(compiledChunkTypes);
+        free(compiledChunkRegistry);
+        return NULL;
+    }
+
+    /* Resolve the parent chains of every form type and of the global chunk types, which are stored with form type 0 */
+    for(i = 0; i < chunkRegistry->formChunkTypesLength; i++)
+    {
+        const IFF_FormChunkTypes *formChunkTypes = &chunkRegistry->formChunkTypes[i];
+
+        *getFormTypeSlot(compiledChunkTypes, formChunkTypes->formType) = formChunkTypes->formType;
+        insertChunkTypes(compiledChunkTypes, formChunkTypes->formType, formChunkTypes->chunkTypesNode);
+    }
+
+    insertChunkTypes(compiledChunkTypes, 0, chunkRegistry->globalChunkTypesNode);
+
+    *compiledChunkRegistry = *chunkRegistry;
+    compiledChunkRegistry->compiledChunkTypes = compiledChunkTypes;
+
+    return compiledChunkRegistry;
+}
+
+void IFF_freeCompiledChunkRegistry(IFF_ChunkRegistry *chunkRegistry)
+{
+    if(chunkRegistry != NULL)
+    {
+        free(chunkRegistry->compiledChunkTypes->chunkTypeSlot);
+        free(chunkRegistry->compiledChunkTypes->formTypeSlot);
+        free(chunkRegistry->compiledChunkTypes);
+        free(chunkRegistry);
+    }
+}
@@ -26,9 +26,11 @@ typedef struct IFF_ChunkType IFF_ChunkType;
 typedef struct IFF_ChunkTypesNode IFF_ChunkTypesNode;
 typedef struct IFF_FormChunkTypes IFF_FormChunkTypes;
 typedef struct IFF_ChunkRegistry IFF_ChunkRegistry;
+typedef struct IFF_CompiledChunkTypes IFF_CompiledChunkTypes;
 
 #include <stdio.h>
 #include "ifftypes.h"
+#include "stream.h"
 #include "chunk.h"
 
 /**
@@ -43,10 +45,10 @@ struct IFF_ChunkType
     IFF_Chunk *(*createExtensionChunk) (const IFF_ID chunkId, const IFF_Long chunkSize);
 
     /** Function resposible for reading the given chunk */
-    IFF_Bool (*readExtensionChunkFields) (FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+    IFF_Bool (*readExtensionChunkFields) (IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
     /** Function resposible for writing the given chunk */
-    IFF_Bool (*writeExtensionChunkFields) (FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+    IFF_Bool (*writeExtensionChunkFields) (IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
     /** Function resposible for checking the given chunk */
     IFF_Bool (*checkExtensionChunk) (const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry);
@@ -101,6 +103,9 @@ struct IFF_ChunkRegistry
 
     /** Type definition of a chunk that is the default, when no FORM-specific or global identifier matches */
     IFF_ChunkType *defaultChunkType;
+
+    /** Hash table resolving chunk types in constant time. NULL, unless the registry has been produced by IFF_compileChunkRegistry() */
+    IFF_CompiledChunkTypes *compiledChunkTypes;
 };
 
 #ifdef __cplusplus
@@ -117,6 +122,31 @@ extern "C" {
  */
 IFF_ChunkType *IFF_findChunkType(const IFF_ChunkRegistry *chunkRegistry, const IFF_ID formType, const IFF_ID chunkId);
 
+/**
+ * Compiles a chunk registry into a registry whose chunk types are resolved by
+ * a single open-addressing hash table keyed by the form type and chunk id.
+ * The parent chains of all chunk type nodes are resolved in advance, so that
+ * IFF_findChunkType() yields the same chunk types in constant time.
+ *
+ * While compiling, it checks whether the form types and the chunk types in
+ * every node are sorted and unique, so that errors that would otherwise cause
+ * lookups to silently fail are reported up front.
+ *
+ * The original registry and the structures it refers to must remain available
+ * as long as the compiled registry is in use.
+ *
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return A compiled chunk registry that must be freed with IFF_freeCompiledChunkRegistry(), or NULL if the registry is invalid or the compilation failed
+ */
+IFF_ChunkRegistry *IFF_compileChunkRegistry(const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Frees a chunk registry produced by IFF_compileChunkRegistry()
+ *
+ * @param chunkRegistry A compiled chunk registry
+ */
+void IFF_freeCompiledChunkRegistry(IFF_ChunkRegistry *chunkRegistry);
+
 #ifdef __cplusplus
 }
 #endif
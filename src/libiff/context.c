@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "context.h"
+#include "id.h"
+#include "threadlocal.h"
+
+static IFF_THREAD_LOCAL IFF_Context *selectedContext = NULL;
+
+static IFF_THREAD_LOCAL IFF_Bool validateOnRead = FALSE;
+
+void IFF_initContext(IFF_Context *context)
+{
+    context->errorCode = IFF_ERROR_NONE;
+    context->offset = -1;
+    context->chunkPathLength = 0;
+    context->errorCallback = NULL;
+    context->errorData = NULL;
+    context->depth = 0;
+}
+
+IFF_Context *IFF_selectContext(IFF_Context *context)
+{
+    IFF_Context *previousContext = selectedContext;
+    selectedContext = context;
+    return previousContext;
+}
+
+IFF_Context *IFF_getSelectedContext(void)
+{
+    return selectedContext;
+}
+
+IFF_Bool IFF_selectValidateOnRead(const IFF_Bool validate)
+{
+    IFF_Bool previousValidate = validateOnRead;
+    validateOnRead = validate;
+    return previousValidate;
+}
+
+IFF_Bool IFF_getValidateOnRead(void)
+{
+    return validateOnRead;
+}
+
+void IFF_enterChunk(IFF_IOStream *stream, const IFF_ID chunkId)
+{
+    IFF_Context *context = selectedContext;
+
+    if(context != NULL)
+    {
+        if(context->depth < IFF_MAX_CHUNK_PATH_LENGTH)
+        {
+            context->level[context->depth].chunkId = chunkId;
+            context->level[context->depth].stream = stream;
+        }
+
+        context->depth++;
+    }
+}
+
+void IFF_leaveChunk(void)
+{
+    IFF_Context *context = selectedContext;
+
+    if(context != NULL && context->depth > 0)
+        context->depth--;
+}
+
+void IFF_recordError(const IFF_ErrorCode errorCode)
+{
+    IFF_Context *context = selectedContext;
+
+    if(context != NULL && context->errorCode == IFF_ERROR_NONE)
+    {
+        unsigned int i, levelsLength = context->depth < IFF_MAX_CHUNK_PATH_LENGTH ? context->depth : IFF_MAX_CHUNK_PATH_LENGTH;
+
+        context->errorCode = errorCode;
+        context->chunkPathLength = context->depth;
+        context->offset = -1;
+
+        for(i = 0; i < levelsLength; i++)
+            context->chunkPath[i] = context->level[i].chunkId;
+
+        /* The offset is only asked for on the error path, so that the hot path does not pay for it */
+        if(levelsLength > 0 && context->level[levelsLength - 1].stream != NULL)
+        {
+            IFF_IOStream *stream = context->level[levelsLength - 1].stream;
+            context->offset = stream->tell(stream);
+        }
+    }
+}
+
+void IFF_recordContextError(const IFF_Context *errorContext)
+{
+    IFF_Context *context = selectedContext;
+
+    if(context != NULL && context->errorCode == IFF_ERROR_NONE && errorContext->errorCode != IFF_ERROR_NONE)
+    {
+        unsigned int i, levelsLength = context->depth < IFF_MAX_CHUNK_PATH_LENGTH ? context->depth : IFF_MAX_CHUNK_PATH_LENGTH;
+
+        context->errorCode = errorContext->errorCode;
+        context->chunkPathLength = context->depth + errorContext->chunkPathLength;
+        context->offset = errorContext->offset;
+
+        /* The chunk path consists of the chunks being processed, followed by the chunk path of the other context */
+        for(i = 0; i < levelsLength; i++)
+            context->chunkPath[i] = context->level[i].chunkId;
+
+        for(i = 0; i < errorContext->chunkPathLength && levelsLength + i < IFF_MAX_CHUNK_PATH_LENGTH; i++)
+            context->chunkPath[levelsLength + i] = errorContext->chunkPath[i];
+    }
+}
+
+const char *IFF_errorCodeToString(const IFF_ErrorCode errorCode)
+{
+    switch(errorCode)
+    {
+        case IFF_ERROR_NONE:
+            return "no error";
+        case IFF_ERROR_READ:
+            return "read error";
+        case IFF_ERROR_WRITE:
+            return "write error";
+        case IFF_ERROR_INVALID:
+            return "invalid data";
+        case IFF_ERROR_MEMORY:
+            return "out of memory";
+        default:
+            return "unknown error";
+    }
+}
+
+void IFF_printContextError(FILE *file, const IFF_Context *context)
+{
+    unsigned int i, chunkPathLength = context->chunkPathLength < IFF_MAX_CHUNK_PATH_LENGTH ? context->chunkPathLength : IFF_MAX_CHUNK_PATH_LENGTH;
+
+    fprintf(file, "%s", IFF_errorCodeToString(context->errorCode));
+
+    if(chunkPathLength > 0)
+    {
+        fprintf(file, " in: ");
+
+        for(i = 0; i < chunkPathLength; i++)
+        {
+            IFF_ID2 id2;
+            IFF_idToString(context->chunkPath[i], id2);
+            fprintf(file, i == 0 ? "'%.4s'" : " > '%.4s'", id2);
+        }
+
+        if(context->chunkPathLength > chunkPathLength)
+            fprintf(file, " > ...");
+    }
+
+    if(context->offset != -1)
+        fprintf(file, " at offset: %ld", context->offset);
+
+    fprintf(file, "\n");
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_CONTEXT_H
+#define __IFF_CONTEXT_H
+
+typedef struct IFF_Context IFF_Context;
+
+#include <stdio.h>
+#include <stdarg.h>
+#include "ifftypes.h"
+#include "stream.h"
+
+/** Maximum number of enclosing chunks that is remembered. Deeper chunks are still counted, but not stored */
+#define IFF_MAX_CHUNK_PATH_LENGTH 16
+
+/**
+ * @brief Describes the kind of the first error that has occured
+ */
+typedef enum
+{
+    /** No error has occured */
+    IFF_ERROR_NONE = 0,
+
+    /** Data could not be read from a stream, for example because it ends prematurely */
+    IFF_ERROR_READ = 1,
+
+    /** Data could not be written to a stream */
+    IFF_ERROR_WRITE = 2,
+
+    /** The data does not conform to the IFF specification or the chunk type */
+    IFF_ERROR_INVALID = 3,
+
+    /** Memory could not be allocated */
+    IFF_ERROR_MEMORY = 4
+}
+IFF_ErrorCode;
+
+/**
+ * @brief A chunk that is being processed, together with the stream that it is read from or written to
+ */
+typedef struct
+{
+    /** A 4 character chunk ID */
+    IFF_ID chunkId;
+
+    /** The stream that is used to process the chunk, or NULL if the chunk is not read or written */
+    IFF_IOStream *stream;
+}
+IFF_ContextLevel;
+
+/**
+ * @brief Records the first error that occurs in the operations of a thread, so that parsers running in different threads can tell their errors apart.
+ */
+struct IFF_Context
+{
+    /** The kind of the first error that has occured, or IFF_ERROR_NONE */
+    IFF_ErrorCode errorCode;
+
+    /** Stream offset at which the first error has occured, or -1 if it is unknown */
+    long offset;
+
+    /** The IDs of the chunks in which the first error has occured, from the outermost to the innermost chunk */
+    IFF_ID chunkPath[IFF_MAX_CHUNK_PATH_LENGTH];
+
+    /** Contains the number of chunks in which the first error has occured. It may exceed IFF_MAX_CHUNK_PATH_LENGTH */
+    unsigned int chunkPathLength;
+
+    /** Function that receives the error messages, or NULL if the messages should not be formatted at all */
+    void (*errorCallback) (void *data, const char *formatString, va_list ap);
+
+    /** Arbitrary data that is passed to the error callback */
+    void *errorData;
+
+    /** Contains the number of chunks that are currently being processed */
+    unsigned int depth;
+
+    /** The chunks that are currently being processed */
+    IFF_ContextLevel level[IFF_MAX_CHUNK_PATH_LENGTH];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a context, so that it does not contain an error. Error messages
+ * are discarded, unless an error callback is configured afterwards.
+ *
+ * @param context A context instance
+ */
+void IFF_initContext(IFF_Context *context);
+
+/**
+ * Selects the context in which the library records errors for the calling
+ * thread. While a context is selected, error messages are passed to its error
+ * callback instead of IFF_errorCallback, and only formatted if it has one.
+ * Operations in other threads, such as the workers of IFF_readParallel(), do
+ * not report to the context.
+ *
+ * @param context A context instance or NULL to report errors through IFF_errorCallback
+ * @return The context that was selected previously, or NULL if none was selected
+ */
+IFF_Context *IFF_selectContext(IFF_Context *context);
+
+/**
+ * Returns the context that has been selected for the calling thread.
+ *
+ * @return The selected context, or NULL if none was selected
+ */
+IFF_Context *IFF_getSelectedContext(void);
+
+/**
+ * Configures whether the chunks that the calling thread reads from a stream
+ * are checked while they are parsed. When enabled, the chunk IDs, group types,
+ * sub chunk types and chunk sizes are checked as soon as they have been read,
+ * and reading stops at the first violation, without building the rest of the
+ * chunk hierarchy. Lazy, mapped and parallel reads are not affected.
+ *
+ * @param validate TRUE to check chunks while they are read, else FALSE
+ * @return The setting that was selected previously
+ */
+IFF_Bool IFF_selectValidateOnRead(const IFF_Bool validate);
+
+/**
+ * Returns whether the calling thread checks chunks while they are read.
+ *
+ * @return TRUE if chunks are checked while they are read, else FALSE
+ */
+IFF_Bool IFF_getValidateOnRead(void);
+
+/**
+ * Records that the processing of a chunk has started, so that errors can be
+ * attributed to it. Each invocation must be followed by IFF_leaveChunk().
+ *
+ * @param stream The stream that is used to process the chunk, or NULL if the chunk is not read or written
+ * @param chunkId A 4 character chunk ID
+ */
+void IFF_enterChunk(IFF_IOStream *stream, const IFF_ID chunkId);
+
+/**
+ * Records that the processing of the most recently entered chunk has finished.
+ */
+void IFF_leaveChunk(void);
+
+/**
+ * Records an error in the selected context, together with the chunks that are
+ * being processed and the stream offset. Only the first error is recorded. If
+ * no context has been selected, this function does nothing.
+ *
+ * @param errorCode The kind of the error
+ */
+void IFF_recordError(const IFF_ErrorCode errorCode);
+
+/**
+ * Records an error that has been recorded in another context, for example by
+ * a worker thread, as if it has occured in the chunks that are currently being
+ * processed. Only the first error is recorded. If no context has been selected,
+ * this function does nothing.
+ *
+ * @param errorContext A context in which an error has been recorded
+ */
+void IFF_recordContextError(const IFF_Context *errorContext);
+
+/**
+ * Returns a textual description of an error code.
+ *
+ * @param errorCode An error code
+ * @return A string describing the error code
+ */
+const char *IFF_errorCodeToString(const IFF_ErrorCode errorCode);
+
+/**
+ * Prints a description of the error that has been recorded in the given context.
+ *
+ * @param file File to which the description is written
+ * @param context A context instance
+ */
+void IFF_printContextError(FILE *file, const IFF_Context *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
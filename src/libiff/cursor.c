@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "cursor.h"
+#include <string.h>
+#include "error.h"
+#include "context.h"
+
+void IFF_initCursor(IFF_Cursor *cursor, const IFF_UByte *data, const size_t size)
+{
+    cursor->data = data;
+    cursor->size = size;
+    cursor->position = 0;
+}
+
+size_t IFF_getCursorBytesLeft(const IFF_Cursor *cursor)
+{
+    return cursor->size - cursor->position;
+}
+
+IFF_Bool IFF_readCursorBytes(IFF_Cursor *cursor, void *buffer, const size_t size, const IFF_ID chunkId, const char *attributeName)
+{
+    if(size > IFF_getCursorBytesLeft(cursor))
+    {
+        IFF_readError(chunkId, attributeName);
+        return FALSE;
+    }
+    else
+    {
+        memcpy(buffer, cursor->data + cursor->position, size);
+        cursor->position += size;
+        return TRUE;
+    }
+}
+
+IFF_Bool IFF_readCursorUByte(IFF_Cursor *cursor, IFF_UByte *value, const IFF_ID chunkId, const char *attributeName)
+{
+    if(IFF_getCursorBytesLeft(cursor) < sizeof(IFF_UByte))
+    {
+        IFF_readError(chunkId, attributeName);
+        return FALSE;
+    }
+    else
+    {
+        *value = cursor->data[cursor->position];
+        cursor->position++;
+        return TRUE;
+    }
+}
+
+IFF_Bool IFF_readCursorUWord(IFF_Cursor *cursor, IFF_UWord *value, const IFF_ID chunkId, const char *attributeName)
+{
+    if(IFF_getCursorBytesLeft(cursor) < sizeof(IFF_UWord))
+    {
+        IFF_readError(chunkId, attributeName);
+        return FALSE;
+    }
+    else
+    {
+        const IFF_UByte *bytes = cursor->data + cursor->position;
+
+        /* Values are stored in big endian order, so we can compose them regardless of the host byte order */
+        *value = bytes[0] << 8 | bytes[1];
+        cursor->position += sizeof(IFF_UWord);
+        return TRUE;
+    }
+}
+
+IFF_Bool IFF_readCursorWord(IFF_Cursor *cursor, IFF_Word *value, const IFF_ID chunkId, const char *attributeName)
+{
+    return IFF_readCursorUWord(cursor, (IFF_UWord*)value, chunkId, attributeName);
+}
+
+IFF_Bool IFF_readCursorULong(IFF_Cursor *cursor, IFF_ULong *value, const IFF_ID chunkId, const char *attributeName)
+{
+    if(IFF_getCursorBytesLeft(cursor) < sizeof(IFF_ULong))
+    {
+        IFF_readError(chunkId, attributeName);
+        return FALSE;
+    }
+    else
+    {
+        const IFF_UByte *bytes = cursor->data + cursor->position;
+
+        /* Values are stored in big endian order, so we can compose them regardless of the host byte order */
+        *value = (IFF_ULong)bytes[0] << 24 | (IFF_ULong)bytes[1] << 16 | (IFF_ULong)bytes[2] << 8 | (IFF_ULong)bytes[3];
+        cursor->position += sizeof(IFF_ULong);
+        return TRUE;
+    }
+}
+
+IFF_Bool IFF_readCursorLong(IFF_Cursor *cursor, IFF_Long *value, const IFF_ID chunkId, const char *attributeName)
+{
+    return IFF_readCursorULong(cursor, (IFF_ULong*)value, chunkId, attributeName);
+}
+
+IFF_Bool IFF_readCursorId(IFF_Cursor *cursor, IFF_ID *id, const IFF_ID chunkId, const char *attributeName)
+{
+    return IFF_readCursorULong(cursor, id, chunkId, attributeName);
+}
+
+IFF_Bool IFF_skipCursorUnknownBytes(IFF_Cursor *cursor, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Long bytesProcessed)
+{
+    if(bytesProcessed < chunkSize)
+    {
+        size_t bytesToSkip = chunkSize - bytesProcessed;
+
+        if(bytesToSkip > IFF_getCursorBytesLeft(cursor))
+        {
+            IFF_recordError(IFF_ERROR_READ);
+            IFF_error("Cannot skip: %lu bytes in data chunk: '", (unsigned long)bytesToSkip);
+            IFF_errorId(chunkId);
+            IFF_error("'\n");
+            return FALSE;
+        }
+        else
+        {
+            cursor->position += bytesToSkip;
+            return TRUE;
+        }
+    }
+    else
+        return TRUE;
+}
+
+IFF_Bool IFF_readCursorPaddingByte(IFF_Cursor *cursor, const IFF_Long chunkSize, const IFF_ID chunkId)
+{
+    if(chunkSize % 2 != 0) /* Check whether the chunk size is an odd number */
+    {
+        if(IFF_getCursorBytesLeft(cursor) == 0) /* We shouldn't have reached the end of the memory block yet */
+        {
+            IFF_recordError(IFF_ERROR_READ);
+            IFF_error("Unexpected end of file, while reading padding byte of '");
+            IFF_errorId(chunkId);
+            IFF_error("'\n");
+            return FALSE;
+        }
+        else
+        {
+            if(cursor->data[cursor->position] != 0) /* Normally, a padding byte is 0, warn if this is not the case */
+                IFF_error("WARNING: Padding byte is non-zero!\n");
+
+            cursor->position++;
+        }
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_CURSOR_H
+#define __IFF_CURSOR_H
+
+typedef struct IFF_Cursor IFF_Cursor;
+
+#include <stddef.h>
+#include "ifftypes.h"
+
+/**
+ * @brief A read position inside a block of memory containing IFF data, such as a memory mapped file
+ */
+struct IFF_Cursor
+{
+    /** Pointer to the first byte of the memory block */
+    const IFF_UByte *data;
+
+    /** Size of the memory block in bytes */
+    size_t size;
+
+    /** Offset of the next byte that will be read */
+    size_t position;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a cursor that points to the beginning of the given memory block.
+ *
+ * @param cursor A cursor instance
+ * @param data Pointer to the first byte of the memory block
+ * @param size Size of the memory block in bytes
+ */
+void IFF_initCursor(IFF_Cursor *cursor, const IFF_UByte *data, const size_t size);
+
+/**
+ * Returns the amount of bytes that can still be read from the memory block.
+ *
+ * @param cursor A cursor instance
+ * @return The amount of remaining bytes
+ */
+size_t IFF_getCursorBytesLeft(const IFF_Cursor *cursor);
+
+/**
+ * Copies the given amount of bytes from the memory block into a buffer.
+ *
+ * @param cursor A cursor instance
+ * @param buffer Buffer in which the bytes are stored
+ * @param size Amount of bytes to read
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if all bytes have been successfully read, else FALSE
+ */
+IFF_Bool IFF_readCursorBytes(IFF_Cursor *cursor, void *buffer, const size_t size, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Reads an unsigned byte from the memory block.
+ *
+ * @param cursor A cursor instance
+ * @param value Value read from the memory block
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if the value has been successfully read, else FALSE
+ */
+IFF_Bool IFF_readCursorUByte(IFF_Cursor *cursor, IFF_UByte *value, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Reads an unsigned word from the memory block.
+ *
+ * @param cursor A cursor instance
+ * @param value Value read from the memory block
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if the value has been successfully read, else FALSE
+ */
+IFF_Bool IFF_readCursorUWord(IFF_Cursor *cursor, IFF_UWord *value, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Reads a signed word from the memory block.
+ *
+ * @param cursor A cursor instance
+ * @param value Value read from the memory block
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if the value has been successfully read, else FALSE
+ */
+IFF_Bool IFF_readCursorWord(IFF_Cursor *cursor, IFF_Word *value, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Reads an unsigned long from the memory block.
+ *
+ * @param cursor A cursor instance
+ * @param value Value read from the memory block
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if the value has been successfully read, else FALSE
+ */
+IFF_Bool IFF_readCursorULong(IFF_Cursor *cursor, IFF_ULong *value, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Reads a signed long from the memory block.
+ *
+ * @param cursor A cursor instance
+ * @param value Value read from the memory block
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if the value has been successfully read, else FALSE
+ */
+IFF_Bool IFF_readCursorLong(IFF_Cursor *cursor, IFF_Long *value, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Reads an IFF id from the memory block.
+ *
+ * @param cursor A cursor instance
+ * @param id A 4 character IFF id
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if the ID is succesfully read, else FALSE
+ */
+IFF_Bool IFF_readCursorId(IFF_Cursor *cursor, IFF_ID *id, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Skips the remaining data in a chunk that was not processed.
+ *
+ * @param cursor A cursor instance
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param chunkSize Size of the chunk in bytes
+ * @param bytesProcessed Indicates how many bytes in the chunk body were processed
+ * @return TRUE if the data was successfully skipped, else FALSE
+ */
+IFF_Bool IFF_skipCursorUnknownBytes(IFF_Cursor *cursor, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Long bytesProcessed);
+
+/**
+ * Reads a padding byte from a chunk with an odd size.
+ *
+ * @param cursor A cursor instance
+ * @param chunkSize Size of the chunk in bytes
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @return TRUE if the byte has been successfully read, else FALSE
+ */
+IFF_Bool IFF_readCursorPaddingByte(IFF_Cursor *cursor, const IFF_Long chunkSize, const IFF_ID chunkId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -42,5 +42,5 @@ IFF_ChunkTypesNode IFF_globalChunkTypesNode = {
 IFF_ChunkType IFF_defaultChunkType = {0, &IFF_createRawChunk, &IFF_readRawChunk, &IFF_writeRawChunk, &IFF_checkRawChunk, &IFF_freeRawChunk, &IFF_printRawChunk, &IFF_compareRawChunk};
 
 const IFF_ChunkRegistry IFF_defaultChunkRegistry = {
-    0, NULL, &IFF_globalChunkTypesNode, &IFF_defaultChunkType
+    0, NULL, &IFF_globalChunkTypesNode, &IFF_defaultChunkType, NULL
 };
@@ -24,7 +24,7 @@
 #include "chunkregistry.h"
 
 #define IFF_EXTEND_DEFAULT_REGISTRY_WITH_FORM_CHUNK_TYPES(numOfFormChunkTypes, formChunkTypes) \
-    { numOfFormChunkTypes, formChunkTypes, &IFF_globalChunkTypesNode, &IFF_defaultChunkType }
+    { numOfFormChunkTypes, formChunkTypes, &IFF_globalChunkTypesNode, &IFF_defaultChunkType, NULL }
 
 #define IFF_NUM_OF_CHUNK_TYPES 4
 
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "descriptor.h"
+#include <stdlib.h>
+#include <string.h>
+#include "field.h"
+#include "error.h"
+#include "id.h"
+#include "util.h"
+
+/* Bodies up to this size are encoded and decoded without allocating memory */
+#define IFF_DESCRIPTOR_BUFFER_SIZE 128
+
+static size_t getFieldSize(const IFF_FieldType fieldType)
+{
+    switch(fieldType)
+    {
+        case IFF_FIELD_TYPE_UBYTE:
+        case IFF_FIELD_TYPE_CHAR:
+            return sizeof(IFF_UByte);
+        case IFF_FIELD_TYPE_UWORD:
+        case IFF_FIELD_TYPE_WORD:
+            return sizeof(IFF_UWord);
+        case IFF_FIELD_TYPE_ID:
+            return IFF_ID_SIZE;
+        default:
+            return sizeof(IFF_ULong);
+    }
+}
+
+static size_t getFieldsSize(const IFF_ChunkDescriptor *chunkDescriptor)
+{
+    size_t fieldsSize = 0;
+    unsigned int i;
+
+    for(i = 0; i < chunkDescriptor->fieldDescriptorsLength; i++)
+        fieldsSize += getFieldSize(chunkDescriptor->fieldDescriptors[i].fieldType);
+
+    return fieldsSize;
+}
+
+static void *getField(IFF_Chunk *chunk, const IFF_FieldDescriptor *fieldDescriptor)
+{
+    return (char*)chunk + fieldDescriptor->offset;
+}
+
+static const void *getConstField(const IFF_Chunk *chunk, const IFF_FieldDescriptor *fieldDescriptor)
+{
+    return (const char*)chunk + fieldDescriptor->offset;
+}
+
+IFF_Chunk *IFF_createDescribedChunk(const IFF_ChunkDescriptor *chunkDescriptor, const IFF_ID chunkId, const IFF_Long chunkSize)
+{
+    IFF_Chunk *chunk = IFF_createChunk(chunkId, chunkSize, chunkDescriptor->structSize);
+
+    if(chunk != NULL)
+    {
+        unsigned int i;
+
+        for(i = 0; i < chunkDescriptor->fieldDescriptorsLength; i++)
+        {
+            const IFF_FieldDescriptor *fieldDescriptor = &chunkDescriptor->fieldDescriptors[i];
+            memset(getField(chunk, fieldDescriptor), '\0', getFieldSize(fieldDescriptor->fieldType));
+        }
+    }
+
+    return chunk;
+}
+
+static void decodeField(const IFF_FieldDescriptor *fieldDescriptor, const IFF_UByte *data, IFF_Chunk *chunk)
+{
+    void *field = getField(chunk, fieldDescriptor);
+
+    switch(fieldDescriptor->fieldType)
+    {
+        case IFF_FIELD_TYPE_UBYTE:
+        case IFF_FIELD_TYPE_CHAR:
+            *((IFF_UByte*)field) = data[0];
+            break;
+        case IFF_FIELD_TYPE_UWORD:
+            *((IFF_UWord*)field) = (IFF_UWord)(data[0] << 8 | data[1]);
+            break;
+        case IFF_FIELD_TYPE_WORD:
+            *((IFF_Word*)field) = (IFF_Word)(data[0] << 8 | data[1]);
+            break;
+        case IFF_FIELD_TYPE_ULONG:
+            *((IFF_ULong*)field) = (IFF_ULong)data[0] << 24 | (IFF_ULong)data[1] << 16 | (IFF_ULong)data[2] << 8 | (IFF_ULong)data[3];
+            break;
+        case IFF_FIELD_TYPE_LONG:
+            *((IFF_Long*)field) = (IFF_Long)((IFF_ULong)data[0] << 24 | (IFF_ULong)data[1] << 16 | (IFF_ULong)data[2] << 8 | (IFF_ULong)data[3]);
+            break;
+        case IFF_FIELD_TYPE_ID:
+            *((IFF_ID*)field) = (IFF_ID)data[0] << 24 | (IFF_ID)data[1] << 16 | (IFF_ID)data[2] << 8 | (IFF_ID)data[3];
+            break;
+    }
+}
+
+static void encodeField(const IFF_FieldDescriptor *fieldDescriptor, const IFF_Chunk *chunk, IFF_UByte *data)
+{
+    const void *field = getConstField(chunk, fieldDescriptor);
+    IFF_ULong value;
+
+    switch(fieldDescriptor->fieldType)
+    {
+        case IFF_FIELD_TYPE_UBYTE:
+        case IFF_FIELD_TYPE_CHAR:
+            data[0] = *((const IFF_UByte*)field);
+            return;
+        case IFF_FIELD_TYPE_UWORD:
+        case IFF_FIELD_TYPE_WORD:
+            value = *((const IFF_UWord*)field);
+            data[0] = (value >> 8) & 0xff;
+            data[1] = value & 0xff;
+            return;
+        case IFF_FIELD_TYPE_ULONG:
+        case IFF_FIELD_TYPE_LONG:
+        case IFF_FIELD_TYPE_ID:
+            value = *((const IFF_ULong*)field);
+            data[0] = (value >> 24) & 0xff;
+            data[1] = (value >> 16) & 0xff;
+            data[2] = (value >> 8) & 0xff;
+            data[3] = value & 0xff;
+            return;
+    }
+}
+
+static IFF_FieldStatus readField(const IFF_FieldDescriptor *fieldDescriptor, IFF_IOStream *stream, IFF_Chunk *chunk, IFF_Long *bytesProcessed)
+{
+    void *field = getField(chunk, fieldDescriptor);
+
+    switch(fieldDescriptor->fieldType)
+    {
+        case IFF_FIELD_TYPE_UBYTE:
+        case IFF_FIELD_TYPE_CHAR:
+            return IFF_readUByteField(stream, (IFF_UByte*)field, chunk, fieldDescriptor->name, bytesProcessed);
+        case IFF_FIELD_TYPE_UWORD:
+            return IFF_readUWordField(stream, (IFF_UWord*)field, chunk, fieldDescriptor->name, bytesProcessed);
+        case IFF_FIELD_TYPE_WORD:
+            return IFF_readWordField(stream, (IFF_Word*)field, chunk, fieldDescriptor->name, bytesProcessed);
+        case IFF_FIELD_TYPE_ULONG:
+            return IFF_readULongField(stream, (IFF_ULong*)field, chunk, fieldDescriptor->name, bytesProcessed);
+        case IFF_FIELD_TYPE_LONG:
+            return IFF_readLongField(stream, (IFF_Long*)field, chunk, fieldDescriptor->name, bytesProcessed);
+        case IFF_FIELD_TYPE_ID:
+            return IFF_readIdField(stream, (IFF_ID*)field, chunk, fieldDescriptor->name, bytesProcessed);
+        default:
+            return IFF_FIELD_FAILURE;
+    }
+}
+
+static IFF_FieldStatus writeField(const IFF_FieldDescriptor *fieldDescriptor, IFF_IOStream *stream, const IFF_Chunk *chunk, IFF_Long *bytesProcessed)
+{
+    const void *field = getConstField(chunk, fieldDescriptor);
+
+    switch(fieldDescriptor->fieldType)
+    {
+        case IFF_FIELD_TYPE_UBYTE:
+        case IFF_FIELD_TYPE_CHAR:
+            return IFF_writeUByteField(stream, *((const IFF_UByte*)field), chunk, fieldDescriptor->name, bytesProcessed);
+        case IFF_FIELD_TYPE_UWORD:
+            return IFF_writeUWordField(stream, *((const IFF_UWord*)field), chunk, fieldDescriptor->name, bytesProcessed);
+        case IFF_FIELD_TYPE_WORD:
+            return IFF_writeWordField(stream, *((const IFF_Word*)field), chunk, fieldDescriptor->name, bytesProcessed);
+        case IFF_FIELD_TYPE_ULONG:
+            return IFF_writeULongField(stream, *((const IFF_ULong*)field), chunk, fieldDescriptor->name, bytesProcessed);
+        case IFF_FIELD_TYPE_LONG:
+            return IFF_writeLongField(stream, *((const IFF_Long*)field), chunk, fieldDescriptor->name, bytesProcessed);
+        case IFF_FIELD_TYPE_ID:
+            return IFF_writeIdField(stream, *((const IFF_ID*)field), chunk, fieldDescriptor->name, bytesProcessed);
+        default:
+            return IFF_FIELD_FAILURE;
+    }
+}
+
+static IFF_Bool readFieldsOneByOne(const IFF_ChunkDescriptor *chunkDescriptor, IFF_IOStream *stream, IFF_Chunk *chunk, IFF_Long *bytesProcessed)
+{
+    unsigned int i;
+
+    for(i = 0; i < chunkDescriptor->fieldDescriptorsLength; i++)
+    {
+        IFF_FieldStatus status;
+
+        if((status = readField(&chunkDescriptor->fieldDescriptors[i], stream, chunk, bytesProcessed)) != IFF_FIELD_MORE)
+            return IFF_deriveSuccess(status);
+    }
+
+    return TRUE;
+}
+
+static IFF_Bool writeFieldsOneByOne(const IFF_ChunkDescriptor *chunkDescriptor, IFF_IOStream *stream, const IFF_Chunk *chunk, IFF_Long *bytesProcessed)
+{
+    unsigned int i;
+
+    for(i = 0; i < chunkDescriptor->fieldDescriptorsLength; i++)
+    {
+        IFF_FieldStatus status;
+
+        if((status = writeField(&chunkDescriptor->fieldDescriptors[i], stream, chunk, bytesProcessed)) != IFF_FIELD_MORE)
+            return IFF_deriveSuccess(status);
+    }
+
+    return TRUE;
+}
+
+static IFF_Bool fieldsFitInChunk(const size_t fieldsSize, const IFF_Long chunkSize, const IFF_Long bytesProcessed)
+{
+    return bytesProcessed <= chunkSize - (IFF_Long)fieldsSize;
+}
+
+static IFF_UByte *allocateBuffer(IFF_UByte *stackBuffer, const size_t fieldsSize)
+{
+    if(fieldsSize <= IFF_DESCRIPTOR_BUFFER_SIZE)
+        return stackBuffer;
+    else
+        return (IFF_UByte*)malloc(fieldsSize);
+}
+
+static void freeBuffer(IFF_UByte *buffer, const IFF_UByte *stackBuffer)
+{
+    if(buffer != stackBuffer)
+        free(buffer);
+}
+
+IFF_Bool IFF_readDescribedChunkFields(const IFF_ChunkDescriptor *chunkDescriptor, IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+{
+    size_t fieldsSize = getFieldsSize(chunkDescriptor);
+    IFF_UByte stackBuffer[IFF_DESCRIPTOR_BUFFER_SIZE];
+    IFF_UByte *buffer;
+    size_t bytesRead, offset = 0;
+    IFF_Bool status = TRUE;
+    unsigned int i;
+
+    /* A truncated chunk only provides the first fields, so they must be read one by one */
+    if(!fieldsFitInChunk(fieldsSize, chunk->chunkSize, *bytesProcessed)
+        || (buffer = allocateBuffer(stackBuffer, fieldsSize)) == NULL)
+        return readFieldsOneByOne(chunkDescriptor, stream, chunk, bytesProcessed);
+
+    /* Read the entire body at once and decode the fields in a single pass */
+    bytesRead = stream->read(stream, buffer, fieldsSize);
+
+    for(i = 0; i < chunkDescriptor->fieldDescriptorsLength; i++)
+    {
+        const IFF_FieldDescriptor *fieldDescriptor = &chunkDescriptor->fieldDescriptors[i];
+        size_t fieldSize = getFieldSize(fieldDescriptor->fieldType);
+
+        if(offset + fieldSize > bytesRead)
+        {
+            IFF_readError(chunk->chunkId, fieldDescriptor->name);
+            status = FALSE;
+            break;
+        }
+
+        decodeField(fieldDescriptor, buffer + offset, chunk);
+        offset += fieldSize;
+    }
+
+    *bytesProcessed += offset;
+    freeBuffer(buffer, stackBuffer);
+    return status;
+}
+
+IFF_Bool IFF_writeDescribedChunkFields(const IFF_ChunkDescriptor *chunkDescriptor, IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+{
+    size_t fieldsSize = getFieldsSize(chunkDescriptor);
+    IFF_UByte stackBuffer[IFF_DESCRIPTOR_BUFFER_SIZE];
+    IFF_UByte *buffer;
+    size_t bytesWritten, offset = 0;
+    IFF_Bool status = TRUE;
+    unsigned int i;
+
+    if(!fieldsFitInChunk(fieldsSize, chunk->chunkSize, *bytesProcessed)
+        || (buffer = allocateBuffer(stackBuffer, fieldsSize)) == NULL)
+        return writeFieldsOneByOne(chunkDescriptor, stream, chunk, bytesProcessed);
+
+    /* Encode the fields in a single pass and write the entire body at once */
+    for(i = 0; i < chunkDescriptor->fieldDescriptorsLength; i++)
+    {
+        const IFF_FieldDescriptor *fieldDescriptor = &chunkDescriptor->fieldDescriptors[i];
+
+        encodeField(fieldDescriptor, chunk, buffer + offset);
+        offset += getFieldSize(fieldDescriptor->fieldType);
+    }
+
+    bytesWritten = stream->write(stream, buffer, fieldsSize);
+
+    for(i = 0, offset = 0; i < chunkDescriptor->fieldDescriptorsLength; i++)
+    {
+        const IFF_FieldDescriptor *fieldDescriptor = &chunkDescriptor->fieldDescriptors[i];
+        size_t fieldSize = getFieldSize(fieldDescriptor->fieldType);
+
+        if(offset + fieldSize > bytesWritten)
+        {
+            IFF_writeError(chunk->chunkId, fieldDescriptor->name);
+            status = FALSE;
+            break;
+        }
+
+        offset += fieldSize;
+    }
+
+    *bytesProcessed += offset;
+    freeBuffer(buffer, stackBuffer);
+    return status;
+}
+
+IFF_Bool IFF_checkDescribedChunk(const IFF_ChunkDescriptor *chunkDescriptor, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
+{
+    if(chunkDescriptor->checkFields == NULL)
+        return TRUE;
+    else
+        return chunkDescriptor->checkFields(chunk, chunkRegistry);
+}
+
+static void printField(const IFF_FieldDescriptor *fieldDescriptor, const IFF_Chunk *chunk, const unsigned int indentLevel)
+{
+    const void *field = getConstField(chunk, fieldDescriptor);
+
+    switch(fieldDescriptor->fieldType)
+    {
+        case IFF_FIELD_TYPE_UBYTE:
+            IFF_printIndent(stdout, indentLevel, "%s = %u;\n", fieldDescriptor->name, *((const IFF_UByte*)field));
+            break;
+        case IFF_FIELD_TYPE_CHAR:
+            IFF_printIndent(stdout, indentLevel, "%s = %c;\n", fieldDescriptor->name, *((const IFF_UByte*)field));
+            break;
+        case IFF_FIELD_TYPE_UWORD:
+            IFF_printIndent(stdout, indentLevel, "%s = %u;\n", fieldDescriptor->name, *((const IFF_UWord*)field));
+            break;
+        case IFF_FIELD_TYPE_WORD:
+            IFF_printIndent(stdout, indentLevel, "%s = %d;\n", fieldDescriptor->name, *((const IFF_Word*)field));
+            break;
+        case IFF_FIELD_TYPE_ULONG:
+            IFF_printIndent(stdout, indentLevel, "%s = %u;\n", fieldDescriptor->name, *((const IFF_ULong*)field));
+            break;
+        case IFF_FIELD_TYPE_LONG:
+            IFF_printIndent(stdout, indentLevel, "%s = %d;\n", fieldDescriptor->name, *((const IFF_Long*)field));
+            break;
+        case IFF_FIELD_TYPE_ID:
+            IFF_printIndent(stdout, indentLevel, "%s = '", fieldDescriptor->name);
+            IFF_printId(*((const IFF_ID*)field));
+            printf("';\n");
+            break;
+    }
+}
+
+void IFF_printDescribedChunk(const IFF_ChunkDescriptor *chunkDescriptor, const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF_ChunkRegistry *chunkRegistry)
+{
+    unsigned int i;
+
+    for(i = 0; i < chunkDescriptor->fieldDescriptorsLength; i++)
+        printField(&chunkDescriptor->fieldDescriptors[i], chunk, indentLevel);
+}
+
+IFF_Bool IFF_compareDescribedChunk(const IFF_ChunkDescriptor *chunkDescriptor, const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_ChunkRegistry *chunkRegistry)
+{
+    unsigned int i;
+
+    /* Compare field by field, because the padding between the fields is undefined */
+    for(i = 0; i < chunkDescriptor->fieldDescriptorsLength; i++)
+    {
+        const IFF_FieldDescriptor *fieldDescriptor = &chunkDescriptor->fieldDescriptors[i];
+
+        if(memcmp(getConstField(chunk1, fieldDescriptor), getConstField(chunk2, fieldDescriptor), getFieldSize(fieldDescriptor->fieldType)) != 0)
+            return FALSE;
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_DESCRIPTOR_H
+#define __IFF_DESCRIPTOR_H
+
+typedef struct IFF_FieldDescriptor IFF_FieldDescriptor;
+typedef struct IFF_ChunkDescriptor IFF_ChunkDescriptor;
+
+#include <stddef.h>
+#include "ifftypes.h"
+#include "chunk.h"
+#include "chunkregistry.h"
+#include "stream.h"
+
+/**
+ * Enumerates the types of fields that a chunk descriptor can describe
+ */
+typedef enum
+{
+    /** An IFF_UByte that is printed as a number */
+    IFF_FIELD_TYPE_UBYTE = 0,
+    /** An IFF_UByte that is printed as a character */
+    IFF_FIELD_TYPE_CHAR = 1,
+    /** An IFF_UWord */
+    IFF_FIELD_TYPE_UWORD = 2,
+    /** An IFF_Word */
+    IFF_FIELD_TYPE_WORD = 3,
+    /** An IFF_ULong */
+    IFF_FIELD_TYPE_ULONG = 4,
+    /** An IFF_Long */
+    IFF_FIELD_TYPE_LONG = 5,
+    /** A 4 character IFF_ID */
+    IFF_FIELD_TYPE_ID = 6
+}
+IFF_FieldType;
+
+/**
+ * @brief Describes a field of an extension chunk struct and how it is stored in the chunk body
+ */
+struct IFF_FieldDescriptor
+{
+    /** Type of the field */
+    IFF_FieldType fieldType;
+
+    /** Offset of the field in the chunk struct, typically obtained with offsetof() */
+    size_t offset;
+
+    /** Name of the field used for printing and error reporting */
+    const char *name;
+};
+
+/**
+ * @brief Describes an extension chunk whose body consists of a fixed sequence of fields.
+ *
+ * The fields are stored in the chunk body in the order of the descriptors,
+ * without any padding. A chunk whose size is smaller than the size of all
+ * fields is considered truncated: the remaining fields keep their default
+ * value of 0.
+ */
+struct IFF_ChunkDescriptor
+{
+    /** Size of the struct representing the chunk */
+    size_t structSize;
+
+    /** Specifies the number of fields */
+    unsigned int fieldDescriptorsLength;
+
+    /** An array of field descriptors in the order in which the fields are stored */
+    const IFF_FieldDescriptor *fieldDescriptors;
+
+    /** Function that additionally checks the values of the fields, or NULL if all values are valid */
+    IFF_Bool (*checkFields) (const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry);
+};
+
+/**
+ * Defines the seven functions of an IFF_ChunkType for a chunk described by a
+ * chunk descriptor. The functions are named after the given prefix and name,
+ * e.g. prefix##create##name##Chunk(), prefix##read##name() and prefix##compare##name().
+ *
+ * @param prefix Prefix of the function names, e.g. TEST_
+ * @param name Name of the chunk in the function names, e.g. Bye
+ * @param chunkDescriptor A chunk descriptor variable describing the chunk
+ */
+#define IFF_DEFINE_DESCRIBED_CHUNK_FUNCTIONS(prefix, name, chunkDescriptor) \
+    IFF_Chunk *prefix##create##name##Chunk(const IFF_ID chunkId, const IFF_Long chunkSize) \
+    { \
+        return IFF_createDescribedChunk(&chunkDescriptor, chunkId, chunkSize); \
+    } \
+    \
+    IFF_Bool prefix##read##name(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed) \
+    { \
+        return IFF_readDescribedChunkFields(&chunkDescriptor, stream, chunk, chunkRegistry, bytesProcessed); \
+    } \
+    \
+    IFF_Bool prefix##write##name(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed) \
+    { \
+        return IFF_writeDescribedChunkFields(&chunkDescriptor, stream, chunk, chunkRegistry, bytesProcessed); \
+    } \
+    \
+    IFF_Bool prefix##check##name(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry) \
+    { \
+        return IFF_checkDescribedChunk(&chunkDescriptor, chunk, chunkRegistry); \
+    } \
+    \
+    void prefix##free##name(IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry) \
+    { \
+    } \
+    \
+    void prefix##print##name(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF_ChunkRegistry *chunkRegistry) \
+    { \
+        IFF_printDescribedChunk(&chunkDescriptor, chunk, indentLevel, chunkRegistry); \
+    } \
+    \
+    IFF_Bool prefix##compare##name(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_ChunkRegistry *chunkRegistry) \
+    { \
+        return IFF_compareDescribedChunk(&chunkDescriptor, chunk1, chunk2, chunkRegistry); \
+    }
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Creates a chunk described by a chunk descriptor, with all its fields set to 0.
+ *
+ * @param chunkDescriptor Describes the fields of the chunk
+ * @param chunkId A 4 character chunk id
+ * @param chunkSize Size of the chunk body
+ * @return A chunk with the given chunk id and size, or NULL if the memory cannot be allocated
+ */
+IFF_Chunk *IFF_createDescribedChunk(const IFF_ChunkDescriptor *chunkDescriptor, const IFF_ID chunkId, const IFF_Long chunkSize);
+
+/**
+ * Reads the fields of a described chunk. If all fields fit in the chunk, the
+ * body is read with a single read operation and decoded in one pass.
+ * Otherwise, it reads the fields that fit one by one.
+ *
+ * @param chunkDescriptor Describes the fields of the chunk
+ * @param stream An IO stream
+ * @param chunk A chunk created by IFF_createDescribedChunk()
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param bytesProcessed Indicates how many bytes in the chunk body were processed
+ * @return TRUE if the fields have been successfully read, else FALSE
+ */
+IFF_Bool IFF_readDescribedChunkFields(const IFF_ChunkDescriptor *chunkDescriptor, IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+
+/**
+ * Writes the fields of a described chunk. If all fields fit in the chunk, the
+ * body is encoded in one pass and written with a single write operation.
+ * Otherwise, it writes the fields that fit one by one.
+ *
+ * @param chunkDescriptor Describes the fields of the chunk
+ * @param stream An IO stream
+ * @param chunk A described chunk
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param bytesProcessed Indicates how many bytes in the chunk body were processed
+ * @return TRUE if the fields have been successfully written, else FALSE
+ */
+IFF_Bool IFF_writeDescribedChunkFields(const IFF_ChunkDescriptor *chunkDescriptor, IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+
+/**
+ * Checks a described chunk with the check function of the descriptor, if it has any.
+ *
+ * @param chunkDescriptor Describes the fields of the chunk
+ * @param chunk A described chunk
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return TRUE if the chunk is valid, else FALSE
+ */
+IFF_Bool IFF_checkDescribedChunk(const IFF_ChunkDescriptor *chunkDescriptor, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Prints the fields of a described chunk.
+ *
+ * @param chunkDescriptor Describes the fields of the chunk
+ * @param chunk A described chunk
+ * @param indentLevel Indent level of the textual representation
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ */
+void IFF_printDescribedChunk(const IFF_ChunkDescriptor *chunkDescriptor, const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Compares the fields of two described chunks.
+ *
+ * @param chunkDescriptor Describes the fields of the chunks
+ * @param chunk1 Chunk to compare
+ * @param chunk2 Chunk to compare
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return TRUE if the fields of the given chunks are equal, else FALSE
+ */
+IFF_Bool IFF_compareDescribedChunk(const IFF_ChunkDescriptor *chunkDescriptor, const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_ChunkRegistry *chunkRegistry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
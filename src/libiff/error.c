@@ -21,6 +21,7 @@
 
 #include "error.h"
 #include <stdio.h>
+#include "context.h"
 
 void IFF_errorCallbackStderr(const char *formatString, va_list ap)
 {
@@ -31,26 +32,31 @@ void (*IFF_errorCallback) (const char *formatString, va_list ap) = &IFF_errorCal
 
 void IFF_error(const char *formatString, ...)
 {
+    IFF_Context *context = IFF_getSelectedContext();
     va_list ap;
 
     va_start(ap, formatString);
-    IFF_errorCallback(formatString, ap);
+
+    /* If a context has been selected, the message is only formatted if the context asks for it */
+    if(context == NULL)
+        IFF_errorCallback(formatString, ap);
+    else if(context->errorCallback != NULL)
+        context->errorCallback(context->errorData, formatString, ap);
+
     va_end(ap);
 }
 
 void IFF_errorId(const IFF_ID id)
 {
-    unsigned int i;
     IFF_ID2 id2;
 
     IFF_idToString(id, id2);
-
-    for(i = 0; i < IFF_ID_SIZE; i++)
-        IFF_error("%c", id2[i]);
+    IFF_error("%.4s", id2);
 }
 
 void IFF_readError(const IFF_ID chunkId, const char *attributeName)
 {
+    IFF_recordError(IFF_ERROR_READ);
     IFF_error("Error reading '");
     IFF_errorId(chunkId);
     IFF_error("'.%s\n", attributeName);
@@ -58,6 +64,7 @@ void IFF_readError(const IFF_ID chunkId, const char *attributeName)
 
 void IFF_writeError(const IFF_ID chunkId, const char *attributeName)
 {
+    IFF_recordError(IFF_ERROR_WRITE);
     IFF_error("Error writing '");
     IFF_errorId(chunkId);
     IFF_error("'.%s\n", attributeName);
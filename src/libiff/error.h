@@ -43,7 +43,9 @@ extern void (*IFF_errorCallback) (const char *formatString, va_list ap);
 void IFF_errorCallbackStderr(const char *formatString, va_list ap);
 
 /**
- * The error callback function used by the IFF library and derivatives.
+ * The error callback function used by the IFF library and derivatives. If a
+ * context has been selected with IFF_selectContext(), the message is passed to
+ * the error callback of the context instead, or discarded if it has none.
  *
  * @param formatString A format specifier for fprintf()
  */
@@ -57,7 +59,7 @@ void IFF_error(const char *formatString, ...);
 void IFF_errorId(const IFF_ID id);
 
 /**
- * Prints a standard read error message.
+ * Records a read error in the selected context and prints a standard read error message.
  *
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
@@ -65,7 +67,7 @@ void IFF_errorId(const IFF_ID id);
 void IFF_readError(const IFF_ID chunkId, const char *attributeName);
 
 /**
- * Prints a standard write error message.
+ * Records a write error in the selected context and prints a standard write error message.
  *
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
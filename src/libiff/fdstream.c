@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if HAVE_COPY_FILE_RANGE == 1
+#define _GNU_SOURCE /* Exposes the declaration of copy_file_range() */
+#endif
+
+#include "fdstream.h"
+#include <stdio.h>
+#include <errno.h>
+#if HAVE_FCNTL_H == 1
+#include <fcntl.h>
+#endif
+#if HAVE_SYS_SENDFILE_H == 1
+#include <sys/sendfile.h>
+#endif
+#if HAVE_UNISTD_H == 1
+#include <unistd.h>
+#define IFF_FD_READ read
+#define IFF_FD_WRITE write
+#define IFF_FD_SEEK lseek
+#else
+#include <io.h>
+#define IFF_FD_READ _read
+#define IFF_FD_WRITE _write
+#define IFF_FD_SEEK _lseek
+#endif
+
+#define IFF_COPY_BUFFER_SIZE 16384
+
+static size_t readFd(IFF_IOStream *stream, void *buffer, const size_t size)
+{
+    IFF_FdIOStream *fdStream = (IFF_FdIOStream*)stream;
+    size_t bytesRead = 0;
+
+    /* Keep reading until we have all bytes, since a single read operation may return less */
+    while(bytesRead < size)
+    {
+        long status = IFF_FD_READ(fdStream->fd, (IFF_UByte*)buffer + bytesRead, size - bytesRead);
+
+        if(status > 0)
+            bytesRead += status;
+        else if(status == -1 && errno == EINTR)
+            continue;
+        else
+            break; /* End of file or error */
+    }
+
+    return bytesRead;
+}
+
+static size_t writeFd(IFF_IOStream *stream, const void *buffer, const size_t size)
+{
+    IFF_FdIOStream *fdStream = (IFF_FdIOStream*)stream;
+    size_t bytesWritten = 0;
+
+    /* Keep writing until all bytes have been written, since a single write operation may write less */
+    while(bytesWritten < size)
+    {
+        long status = IFF_FD_WRITE(fdStream->fd, (const IFF_UByte*)buffer + bytesWritten, size - bytesWritten);
+
+        if(status > 0)
+            bytesWritten += status;
+        else if(status == -1 && errno == EINTR)
+            continue;
+        else
+            break;
+    }
+
+    return bytesWritten;
+}
+
+static IFF_Bool seekFd(IFF_IOStream *stream, const long offset, const int origin)
+{
+    IFF_FdIOStream *fdStream = (IFF_FdIOStream*)stream;
+    return IFF_FD_SEEK(fdStream->fd, offset, origin) != -1;
+}
+
+static long tellFd(IFF_IOStream *stream)
+{
+    IFF_FdIOStream *fdStream = (IFF_FdIOStream*)stream;
+    return IFF_FD_SEEK(fdStream->fd, 0, SEEK_CUR);
+}
+
+static IFF_Bool isSparseFd(const int fd)
+{
+#if HAVE_FCNTL_H == 1
+    /* In append mode, every write goes to the end of the file regardless of the position, so a hole cannot be left behind */
+    int flags = fcntl(fd, F_GETFL);
+    return flags != -1 && (flags & O_APPEND) == 0;
+#else
+    return FALSE;
+#endif
+}
+
+void IFF_initFdIOStream(IFF_FdIOStream *stream, const int fd)
+{
+    stream->read = &readFd;
+    stream->write = &writeFd;
+    stream->seek = &seekFd;
+    stream->tell = &tellFd;
+    stream->sparse = isSparseFd(fd);
+    stream->fd = fd;
+}
+
+#if HAVE_COPY_FILE_RANGE == 1
+static long copyFdBytesWithCopyFileRange(const int targetFd, const int sourceFd, long size)
+{
+    /* Copy until all bytes have been copied, or the kernel cannot copy between both file descriptors */
+    while(size > 0)
+    {
+        ssize_t status = copy_file_range(sourceFd, NULL, targetFd, NULL, size, 0);
+
+        if(status > 0)
+            size -= status;
+        else if(status == -1 && errno == EINTR)
+            continue;
+        else
+            break;
+    }
+
+    return size;
+}
+#endif
+
+#if HAVE_SENDFILE == 1 && HAVE_SYS_SENDFILE_H == 1
+static long copyFdBytesWithSendfile(const int targetFd, const int sourceFd, long size)
+{
+    while(size > 0)
+    {
+        ssize_t status = sendfile(targetFd, sourceFd, NULL, size);
+
+        if(status > 0)
+            size -= status;
+        else if(status == -1 && errno == EINTR)
+            continue;
+        else
+            break;
+    }
+
+    return size;
+}
+#endif
+
+static long copyFdBytesWithBuffer(IFF_FdIOStream *targetStream, IFF_FdIOStream *sourceStream, long size)
+{
+    IFF_UByte buffer[IFF_COPY_BUFFER_SIZE];
+
+    while(size > 0)
+    {
+        size_t blockSize = size < IFF_COPY_BUFFER_SIZE ? size : IFF_COPY_BUFFER_SIZE;
+
+        if(readFd((IFF_IOStream*)sourceStream, buffer, blockSize) < blockSize
+            || writeFd((IFF_IOStream*)targetStream, buffer, blockSize) < blockSize)
+            break;
+
+        size -= blockSize;
+    }
+
+    return size;
+}
+
+IFF_Bool IFF_copyFdBytes(IFF_FdIOStream *targetStream, IFF_FdIOStream *sourceStream, const long size)
+{
+    long bytesRemaining = size;
+
+    /*
+     * Each method copies as much as it can. The remaining bytes are copied by the
+     * next method, so that an unsupported combination of file descriptors (e.g.
+     * a pipe or a file on another file system) degrades to a buffered copy
+     */
+#if HAVE_COPY_FILE_RANGE == 1
+    bytesRemaining = copyFdBytesWithCopyFileRange(targetStream->fd, sourceStream->fd, bytesRemaining);
+#endif
+#if HAVE_SENDFILE == 1 && HAVE_SYS_SENDFILE_H == 1
+    bytesRemaining = copyFdBytesWithSendfile(targetStream->fd, sourceStream->fd, bytesRemaining);
+#endif
+    bytesRemaining = copyFdBytesWithBuffer(targetStream, sourceStream, bytesRemaining);
+
+    return bytesRemaining == 0;
+}
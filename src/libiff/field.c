@@ -30,7 +30,16 @@ IFF_Bool IFF_deriveSuccess(const IFF_FieldStatus status)
 
 static IFF_Bool fieldDoesNotFitInChunk(const size_t fieldSize, const IFF_Long chunkSize, const IFF_Long bytesProcessed)
 {
-    return bytesProcessed > chunkSize - fieldSize;
+    /* Compute the remaining bytes as a signed value, because an unsigned subtraction wraps if the field is bigger than the chunk */
+    IFF_Long bytesRemaining = chunkSize - bytesProcessed;
+    return bytesRemaining < 0 || fieldSize > (size_t)bytesRemaining;
+}
+
+static IFF_Bool arrayDoesNotFitInChunk(const size_t length, const size_t elementSize, const IFF_Long chunkSize, const IFF_Long bytesProcessed)
+{
+    /* Divide the remaining bytes rather than multiplying the length, so that a huge length cannot overflow */
+    IFF_Long bytesRemaining = chunkSize - bytesProcessed;
+    return bytesRemaining < 0 || length > (size_t)bytesRemaining / elementSize;
 }
 
 static void increaseBytesProcessed(IFF_Long *bytesProcessed, const size_t fieldSize)
@@ -38,13 +47,13 @@ static void increaseBytesProcessed(IFF_Long *bytesProcessed, const size_t fieldS
     *bytesProcessed = *bytesProcessed + fieldSize;
 }
 
-IFF_FieldStatus IFF_readUByteField(FILE *file, IFF_UByte *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_readUByteField(IFF_IOStream *stream, IFF_UByte *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = sizeof(IFF_UByte);
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_readUByte(file, value, chunk->chunkId, attributeName))
+    else if(IFF_readUByte(stream, value, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -53,13 +62,13 @@ IFF_FieldStatus IFF_readUByteField(FILE *file, IFF_UByte *value, const IFF_Chunk
         return IFF_FIELD_FAILURE;
 }
 
-IFF_FieldStatus IFF_writeUByteField(FILE *file, const IFF_UByte value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_writeUByteField(IFF_IOStream *stream, const IFF_UByte value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = sizeof(IFF_UByte);
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_writeUByte(file, value, chunk->chunkId, attributeName))
+    else if(IFF_writeUByte(stream, value, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -68,13 +77,13 @@ IFF_FieldStatus IFF_writeUByteField(FILE *file, const IFF_UByte value, const IFF
         return IFF_FIELD_FAILURE;
 }
 
-IFF_FieldStatus IFF_readUWordField(FILE *file, IFF_UWord *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_readUWordField(IFF_IOStream *stream, IFF_UWord *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = sizeof(IFF_UWord);
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_readUWord(file, value, chunk->chunkId, attributeName))
+    else if(IFF_readUWord(stream, value, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -83,13 +92,13 @@ IFF_FieldStatus IFF_readUWordField(FILE *file, IFF_UWord *value, const IFF_Chunk
         return IFF_FIELD_FAILURE;
 }
 
-IFF_FieldStatus IFF_writeUWordField(FILE *file, const IFF_UWord value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_writeUWordField(IFF_IOStream *stream, const IFF_UWord value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = sizeof(IFF_UWord);
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_writeUWord(file, value, chunk->chunkId, attributeName))
+    else if(IFF_writeUWord(stream, value, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -98,13 +107,13 @@ IFF_FieldStatus IFF_writeUWordField(FILE *file, const IFF_UWord value, const IFF
         return IFF_FIELD_FAILURE;
 }
 
-IFF_FieldStatus IFF_readWordField(FILE *file, IFF_Word *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_readWordField(IFF_IOStream *stream, IFF_Word *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = sizeof(IFF_Word);
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_readWord(file, value, chunk->chunkId, attributeName))
+    else if(IFF_readWord(stream, value, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -113,13 +122,13 @@ IFF_FieldStatus IFF_readWordField(FILE *file, IFF_Word *value, const IFF_Chunk *
         return IFF_FIELD_FAILURE;
 }
 
-IFF_FieldStatus IFF_writeWordField(FILE *file, const IFF_Word value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_writeWordField(IFF_IOStream *stream, const IFF_Word value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = sizeof(IFF_Word);
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_writeWord(file, value, chunk->chunkId, attributeName))
+    else if(IFF_writeWord(stream, value, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -128,13 +137,13 @@ IFF_FieldStatus IFF_writeWordField(FILE *file, const IFF_Word value, const IFF_C
         return IFF_FIELD_FAILURE;
 }
 
-IFF_FieldStatus IFF_readULongField(FILE *file, IFF_ULong *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_readULongField(IFF_IOStream *stream, IFF_ULong *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = sizeof(IFF_ULong);
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_readULong(file, value, chunk->chunkId, attributeName))
+    else if(IFF_readULong(stream, value, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -143,13 +152,13 @@ IFF_FieldStatus IFF_readULongField(FILE *file, IFF_ULong *value, const IFF_Chunk
         return IFF_FIELD_FAILURE;
 }
 
-IFF_FieldStatus IFF_writeULongField(FILE *file, const IFF_ULong value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_writeULongField(IFF_IOStream *stream, const IFF_ULong value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = sizeof(IFF_ULong);
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_writeULong(file, value, chunk->chunkId, attributeName))
+    else if(IFF_writeULong(stream, value, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -158,13 +167,13 @@ IFF_FieldStatus IFF_writeULongField(FILE *file, const IFF_ULong value, const IFF
         return IFF_FIELD_FAILURE;
 }
 
-IFF_FieldStatus IFF_readLongField(FILE *file, IFF_Long *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_readLongField(IFF_IOStream *stream, IFF_Long *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = sizeof(IFF_Long);
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_readLong(file, value, chunk->chunkId, attributeName))
+    else if(IFF_readLong(stream, value, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -173,13 +182,13 @@ IFF_FieldStatus IFF_readLongField(FILE *file, IFF_Long *value, const IFF_Chunk *
         return IFF_FIELD_FAILURE;
 }
 
-IFF_FieldStatus IFF_writeLongField(FILE *file, const IFF_Long value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_writeLongField(IFF_IOStream *stream, const IFF_Long value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = sizeof(IFF_Long);
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_writeLong(file, value, chunk->chunkId, attributeName))
+    else if(IFF_writeLong(stream, value, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -188,13 +197,13 @@ IFF_FieldStatus IFF_writeLongField(FILE *file, const IFF_Long value, const IFF_C
         return IFF_FIELD_FAILURE;
 }
 
-IFF_FieldStatus IFF_readIdField(FILE *file, IFF_ID *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_readIdField(IFF_IOStream *stream, IFF_ID *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = IFF_ID_SIZE;
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_readId(file, value, chunk->chunkId, attributeName))
+    else if(IFF_readId(stream, value, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -203,13 +212,133 @@ IFF_FieldStatus IFF_readIdField(FILE *file, IFF_ID *value, const IFF_Chunk *chun
         return IFF_FIELD_FAILURE;
 }
 
-IFF_FieldStatus IFF_writeIdField(FILE *file, const IFF_ID value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+IFF_FieldStatus IFF_writeIdField(IFF_IOStream *stream, const IFF_ID value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
 {
     size_t fieldSize = IFF_ID_SIZE;
 
     if(fieldDoesNotFitInChunk(fieldSize, chunk->chunkSize, *bytesProcessed))
         return IFF_FIELD_LAST;
-    else if(IFF_writeId(file, value, chunk->chunkId, attributeName))
+    else if(IFF_writeId(stream, value, chunk->chunkId, attributeName))
+    {
+        increaseBytesProcessed(bytesProcessed, fieldSize);
+        return IFF_FIELD_MORE;
+    }
+    else
+        return IFF_FIELD_FAILURE;
+}
+
+IFF_FieldStatus IFF_readUWordArrayField(IFF_IOStream *stream, IFF_UWord *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+{
+    size_t fieldSize = length * sizeof(IFF_UWord);
+
+    if(arrayDoesNotFitInChunk(length, sizeof(IFF_UWord), chunk->chunkSize, *bytesProcessed))
+        return IFF_FIELD_LAST;
+    else if(IFF_readUWordArray(stream, values, length, chunk->chunkId, attributeName))
+    {
+        increaseBytesProcessed(bytesProcessed, fieldSize);
+        return IFF_FIELD_MORE;
+    }
+    else
+        return IFF_FIELD_FAILURE;
+}
+
+IFF_FieldStatus IFF_writeUWordArrayField(IFF_IOStream *stream, const IFF_UWord *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+{
+    size_t fieldSize = length * sizeof(IFF_UWord);
+
+    if(arrayDoesNotFitInChunk(length, sizeof(IFF_UWord), chunk->chunkSize, *bytesProcessed))
+        return IFF_FIELD_LAST;
+    else if(IFF_writeUWordArray(stream, values, length, chunk->chunkId, attributeName))
+    {
+        increaseBytesProcessed(bytesProcessed, fieldSize);
+        return IFF_FIELD_MORE;
+    }
+    else
+        return IFF_FIELD_FAILURE;
+}
+
+IFF_FieldStatus IFF_readWordArrayField(IFF_IOStream *stream, IFF_Word *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+{
+    size_t fieldSize = length * sizeof(IFF_Word);
+
+    if(arrayDoesNotFitInChunk(length, sizeof(IFF_Word), chunk->chunkSize, *bytesProcessed))
+        return IFF_FIELD_LAST;
+    else if(IFF_readWordArray(stream, values, length, chunk->chunkId, attributeName))
+    {
+        increaseBytesProcessed(bytesProcessed, fieldSize);
+        return IFF_FIELD_MORE;
+    }
+    else
+        return IFF_FIELD_FAILURE;
+}
+
+IFF_FieldStatus IFF_writeWordArrayField(IFF_IOStream *stream, const IFF_Word *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+{
+    size_t fieldSize = length * sizeof(IFF_Word);
+
+    if(arrayDoesNotFitInChunk(length, sizeof(IFF_Word), chunk->chunkSize, *bytesProcessed))
+        return IFF_FIELD_LAST;
+    else if(IFF_writeWordArray(stream, values, length, chunk->chunkId, attributeName))
+    {
+        increaseBytesProcessed(bytesProcessed, fieldSize);
+        return IFF_FIELD_MORE;
+    }
+    else
+        return IFF_FIELD_FAILURE;
+}
+
+IFF_FieldStatus IFF_readULongArrayField(IFF_IOStream *stream, IFF_ULong *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+{
+    size_t fieldSize = length * sizeof(IFF_ULong);
+
+    if(arrayDoesNotFitInChunk(length, sizeof(IFF_ULong), chunk->chunkSize, *bytesProcessed))
+        return IFF_FIELD_LAST;
+    else if(IFF_readULongArray(stream, values, length, chunk->chunkId, attributeName))
+    {
+        increaseBytesProcessed(bytesProcessed, fieldSize);
+        return IFF_FIELD_MORE;
+    }
+    else
+        return IFF_FIELD_FAILURE;
+}
+
+IFF_FieldStatus IFF_writeULongArrayField(IFF_IOStream *stream, const IFF_ULong *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+{
+    size_t fieldSize = length * sizeof(IFF_ULong);
+
+    if(arrayDoesNotFitInChunk(length, sizeof(IFF_ULong), chunk->chunkSize, *bytesProcessed))
+        return IFF_FIELD_LAST;
+    else if(IFF_writeULongArray(stream, values, length, chunk->chunkId, attributeName))
+    {
+        increaseBytesProcessed(bytesProcessed, fieldSize);
+        return IFF_FIELD_MORE;
+    }
+    else
+        return IFF_FIELD_FAILURE;
+}
+
+IFF_FieldStatus IFF_readLongArrayField(IFF_IOStream *stream, IFF_Long *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+{
+    size_t fieldSize = length * sizeof(IFF_Long);
+
+    if(arrayDoesNotFitInChunk(length, sizeof(IFF_Long), chunk->chunkSize, *bytesProcessed))
+        return IFF_FIELD_LAST;
+    else if(IFF_readLongArray(stream, values, length, chunk->chunkId, attributeName))
+    {
+        increaseBytesProcessed(bytesProcessed, fieldSize);
+        return IFF_FIELD_MORE;
+    }
+    else
+        return IFF_FIELD_FAILURE;
+}
+
+IFF_FieldStatus IFF_writeLongArrayField(IFF_IOStream *stream, const IFF_Long *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+{
+    size_t fieldSize = length * sizeof(IFF_Long);
+
+    if(arrayDoesNotFitInChunk(length, sizeof(IFF_Long), chunk->chunkSize, *bytesProcessed))
+        return IFF_FIELD_LAST;
+    else if(IFF_writeLongArray(stream, values, length, chunk->chunkId, attributeName))
     {
         increaseBytesProcessed(bytesProcessed, fieldSize);
         return IFF_FIELD_MORE;
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include "chunk.h"
+#include "stream.h"
 
 typedef enum
 {
@@ -45,29 +46,51 @@ extern "C" {
  */
 IFF_Bool IFF_deriveSuccess(const IFF_FieldStatus status);
 
-IFF_FieldStatus IFF_readUByteField(FILE *file, IFF_UByte *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_readUByteField(IFF_IOStream *stream, IFF_UByte *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
-IFF_FieldStatus IFF_writeUByteField(FILE *file, const IFF_UByte value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_writeUByteField(IFF_IOStream *stream, const IFF_UByte value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
-IFF_FieldStatus IFF_readUWordField(FILE *file, IFF_UWord *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_readUWordField(IFF_IOStream *stream, IFF_UWord *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
-IFF_FieldStatus IFF_writeUWordField(FILE *file, const IFF_UWord value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_writeUWordField(IFF_IOStream *stream, const IFF_UWord value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
-IFF_FieldStatus IFF_readWordField(FILE *file, IFF_Word *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_readWordField(IFF_IOStream *stream, IFF_Word *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
-IFF_FieldStatus IFF_writeWordField(FILE *file, const IFF_Word value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_writeWordField(IFF_IOStream *stream, const IFF_Word value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
-IFF_FieldStatus IFF_readULongField(FILE *file, IFF_ULong *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_readULongField(IFF_IOStream *stream, IFF_ULong *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
-IFF_FieldStatus IFF_writeULongField(FILE *file, const IFF_ULong value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_writeULongField(IFF_IOStream *stream, const IFF_ULong value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
-IFF_FieldStatus IFF_readLongField(FILE *file, IFF_Long *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_readLongField(IFF_IOStream *stream, IFF_Long *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
-IFF_FieldStatus IFF_writeLongField(FILE *file, const IFF_Long value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_writeLongField(IFF_IOStream *stream, const IFF_Long value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
-IFF_FieldStatus IFF_readIdField(FILE *file, IFF_ID *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_readIdField(IFF_IOStream *stream, IFF_ID *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
-IFF_FieldStatus IFF_writeIdField(FILE *file, const IFF_ID value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+IFF_FieldStatus IFF_writeIdField(IFF_IOStream *stream, const IFF_ID value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+
+/*
+ * The array variants read or write all elements with a single stream operation.
+ * If the array does not fit in the remainder of the chunk, nothing is read or
+ * written and IFF_FIELD_LAST is returned.
+ */
+
+IFF_FieldStatus IFF_readUWordArrayField(IFF_IOStream *stream, IFF_UWord *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+
+IFF_FieldStatus IFF_writeUWordArrayField(IFF_IOStream *stream, const IFF_UWord *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+
+IFF_FieldStatus IFF_readWordArrayField(IFF_IOStream *stream, IFF_Word *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+
+IFF_FieldStatus IFF_writeWordArrayField(IFF_IOStream *stream, const IFF_Word *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+
+IFF_FieldStatus IFF_readULongArrayField(IFF_IOStream *stream, IFF_ULong *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+
+IFF_FieldStatus IFF_writeULongArrayField(IFF_IOStream *stream, const IFF_ULong *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+
+IFF_FieldStatus IFF_readLongArrayField(IFF_IOStream *stream, IFF_Long *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
+
+IFF_FieldStatus IFF_writeLongArrayField(IFF_IOStream *stream, const IFF_Long *values, const size_t length, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "filestream.h"
+#if HAVE_FCNTL_H == 1
+#include <fcntl.h>
+#endif
+
+static size_t readFile(IFF_IOStream *stream, void *buffer, const size_t size)
+{
+    IFF_FileIOStream *fileStream = (IFF_FileIOStream*)stream;
+    return fread(buffer, sizeof(IFF_UByte), size, fileStream->file);
+}
+
+static size_t writeFile(IFF_IOStream *stream, const void *buffer, const size_t size)
+{
+    IFF_FileIOStream *fileStream = (IFF_FileIOStream*)stream;
+    return fwrite(buffer, sizeof(IFF_UByte), size, fileStream->file);
+}
+
+static IFF_Bool seekFile(IFF_IOStream *stream, const long offset, const int origin)
+{
+    IFF_FileIOStream *fileStream = (IFF_FileIOStream*)stream;
+    return fseek(fileStream->file, offset, origin) == 0;
+}
+
+static long tellFile(IFF_IOStream *stream)
+{
+    IFF_FileIOStream *fileStream = (IFF_FileIOStream*)stream;
+    return ftell(fileStream->file);
+}
+
+static IFF_Bool isSparseFile(FILE *file)
+{
+#if HAVE_FCNTL_H == 1
+    /* In append mode, every write goes to the end of the file regardless of the position, so a hole cannot be left behind */
+    int flags = fcntl(fileno(file), F_GETFL);
+    return flags != -1 && (flags & O_APPEND) == 0;
+#else
+    return FALSE;
+#endif
+}
+
+void IFF_initFileIOStream(IFF_FileIOStream *stream, FILE *file)
+{
+    stream->read = &readFile;
+    stream->write = &writeFile;
+    stream->seek = &seekFile;
+    stream->tell = &tellFile;
+    stream->sparse = isSparseFile(file);
+    stream->file = file;
+}
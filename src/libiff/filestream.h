@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_FILESTREAM_H
+#define __IFF_FILESTREAM_H
+
+typedef struct IFF_FileIOStream IFF_FileIOStream;
+
+#include <stdio.h>
+#include "ifftypes.h"
+#include "stream.h"
+
+/**
+ * @brief A stream that reads from and writes to a file descriptor of the C standard library.
+ */
+struct IFF_FileIOStream
+{
+    /** Function responsible for reading the given amount of bytes into a buffer */
+    size_t (*read) (IFF_IOStream *stream, void *buffer, const size_t size);
+
+    /** Function responsible for writing the given amount of bytes from a buffer */
+    size_t (*write) (IFF_IOStream *stream, const void *buffer, const size_t size);
+
+    /** Function responsible for moving the position of the stream */
+    IFF_Bool (*seek) (IFF_IOStream *stream, const long offset, const int origin);
+
+    /** Function responsible for returning the current position of the stream */
+    long (*tell) (IFF_IOStream *stream);
+
+    /** Indicates whether large zero fillers can be written as holes, which is not the case if the file is opened in append mode */
+    IFF_Bool sparse;
+
+    /** File descriptor of the file */
+    FILE *file;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a stream that reads from and writes to the given file descriptor.
+ * The stream does not take ownership of the file descriptor, so it must be closed by the caller.
+ *
+ * @param stream A file stream instance
+ * @param file File descriptor of the file
+ */
+void IFF_initFileIOStream(IFF_FileIOStream *stream, FILE *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
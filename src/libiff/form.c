@@ -75,19 +75,33 @@ IFF_Chunk *IFF_createUnparsedForm(const IFF_ID chunkId, const IFF_Long chunkSize
     return IFF_createUnparsedGroup(chunkId, chunkSize);
 }
 
-void IFF_addToForm(IFF_Form *form, IFF_Chunk *chunk)
+IFF_Bool IFF_addToForm(IFF_Form *form, IFF_Chunk *chunk)
 {
-    IFF_addToGroup((IFF_Group*)form, chunk);
+    return IFF_addToGroup((IFF_Group*)form, chunk);
 }
 
-IFF_Bool IFF_readForm(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+static IFF_Bool subChunkCheck(const IFF_Group *group, const IFF_Chunk *subChunk)
 {
-    return IFF_readGroup(file, chunk, FORM_GROUPTYPENAME, chunkRegistry, bytesProcessed);
+    if(subChunk->chunkId == IFF_ID_PROP)
+    {
+        IFF_error("ERROR: Element with chunk Id: '");
+        IFF_errorId(subChunk->chunkId);
+        IFF_error("' not allowed in FORM chunk!\n");
+
+        return FALSE;
+    }
+    else
+        return TRUE;
+}
+
+IFF_Bool IFF_readForm(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+{
+    return IFF_readCheckedGroup(stream, chunk, FORM_GROUPTYPENAME, &IFF_checkFormType, &subChunkCheck, chunkRegistry, bytesProcessed);
 }
 
-IFF_Bool IFF_writeForm(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool IFF_writeForm(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
-    return IFF_writeGroup(file, chunk, FORM_GROUPTYPENAME, chunkRegistry, bytesProcessed);
+    return IFF_writeGroup(stream, chunk, FORM_GROUPTYPENAME, chunkRegistry, bytesProcessed);
 }
 
 IFF_Bool IFF_checkFormType(const IFF_ID formType)
@@ -157,20 +171,6 @@ IFF_Bool IFF_checkFormType(const IFF_ID formType)
     return TRUE;
 }
 
-static IFF_Bool subChunkCheck(const IFF_Group *group, const IFF_Chunk *subChunk)
-{
-    if(subChunk->chunkId == IFF_ID_PROP)
-    {
-        IFF_error("ERROR: Element with chunk Id: '");
-        IFF_errorId(subChunk->chunkId);
-        IFF_error("' not allowed in FORM chunk!\n");
-
-        return FALSE;
-    }
-    else
-        return TRUE;
-}
-
 IFF_Bool IFF_checkForm(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
 {
     return IFF_checkGroup((IFF_Group*)chunk, &IFF_checkFormType, &subChunkCheck, chunkRegistry);
@@ -270,35 +270,22 @@ static IFF_Chunk *searchProperty(const IFF_Chunk *chunk, const IFF_ID formType,
         return NULL; /* If the chunk is not (indirectly) in a list, we have no shared properties at all */
     else
     {
-        /* Try requesting the PROP chunk for the given form type */
-        IFF_Prop *prop = IFF_getPropFromList(list, formType);
+        /* Try requesting the chunk from the shared property chunk for the given form type */
+        IFF_Chunk *chunk = IFF_getPropertyFromList(list, formType, chunkId);
 
-        if(prop == NULL)
-            return searchProperty((IFF_Chunk*)list, formType, chunkId); /* If we can't find a shared property chunk with the given form type, try searching for a list higher in the hierarchy */
+        if(chunk == NULL)
+            return searchProperty((IFF_Chunk*)list, formType, chunkId); /* If the requested chunk is not in a PROP chunk of this list, try searching for a list higher in the hierarchy */
         else
-        {
-            /* Try requesting the chunk from the shared property chunk */
-            IFF_Chunk *chunk = IFF_getChunkFromProp(prop, chunkId);
-
-            if(chunk == NULL)
-                return searchProperty((IFF_Chunk*)list, formType, chunkId); /* If the requested chunk is not in the PROP chunk, try searching for a list higher in the hierarchy */
-            else
-                return chunk; /* We have found the requested shared property chunk */
-        }
+            return chunk; /* We have found the requested shared property chunk */
     }
 }
 
 IFF_Chunk *IFF_getDataChunkFromForm(const IFF_Form *form, const IFF_ID chunkId)
 {
-    unsigned int i;
-
-    for(i = 0; i < form->chunkLength; i++)
-    {
-        if(form->chunk[i]->chunkId == chunkId)
-            return form->chunk[i];
-    }
+    IFF_ChunkIterator iterator;
 
-    return NULL;
+    IFF_iterateChunksInForm(&iterator, form, chunkId);
+    return IFF_nextChunkInForm(&iterator);
 }
 
 IFF_Chunk *IFF_getChunkFromForm(const IFF_Form *form, const IFF_ID chunkId)
@@ -315,20 +302,83 @@ IFF_Chunk *IFF_getChunkFromForm(const IFF_Form *form, const IFF_ID chunkId)
 
 IFF_Chunk **IFF_getChunksFromForm(const IFF_Form *form, const IFF_ID chunkId, unsigned int *chunksLength)
 {
-    IFF_Chunk **result = NULL;
-    unsigned int i;
+    IFF_ChunkIterator iterator;
+    IFF_Chunk **result;
+    IFF_Chunk *chunk;
+    unsigned int i, count = 0;
 
     *chunksLength = 0;
 
-    for(i = 0; i < form->chunkLength; i++)
+    IFF_iterateChunksInForm(&iterator, form, chunkId);
+
+    /* Count the matching chunks first, so that the result array is allocated only once */
+    if(iterator.indexed)
+        count = iterator.positionsLength;
+    else
     {
-        if(form->chunk[i]->chunkId == chunkId)
+        for(i = 0; i < form->chunkLength; i++)
         {
-            result = (IFF_Chunk**)realloc(result, (*chunksLength + 1) * sizeof(IFF_Chunk*));
-            result[*chunksLength] = form->chunk[i];
+            if(form->chunk[i]->chunkId == chunkId)
+                count++;
+        }
+    }
+
+    if(count == 0)
+        return NULL;
+
+    result = (IFF_Chunk**)malloc(count * sizeof(IFF_Chunk*));
+
+    if(result != NULL)
+    {
+        while((chunk = IFF_nextChunkInForm(&iterator)) != NULL)
+        {
+            result[*chunksLength] = chunk;
             *chunksLength = *chunksLength + 1;
         }
     }
 
     return result;
 }
+
+void IFF_iterateChunksInForm(IFF_ChunkIterator *iterator, const IFF_Form *form, const IFF_ID chunkId)
+{
+    iterator->form = (IFF_Form*)form;
+    iterator->chunkId = chunkId;
+    iterator->index = 0;
+    iterator->indexed = IFF_getChunkIndexPositions((const IFF_Group*)form, chunkId, &iterator->positions, &iterator->positionsLength);
+}
+
+IFF_Chunk *IFF_nextChunkInForm(IFF_ChunkIterator *iterator)
+{
+    IFF_Group *group = (IFF_Group*)iterator->form;
+
+    if(iterator->indexed)
+    {
+        while(iterator->index < iterator->positionsLength)
+        {
+            IFF_Chunk *chunk = IFF_loadGroupSubChunk(group, iterator->positions[iterator->index]); /* Reads the chunk body first if it was deferred */
+            iterator->index++;
+
+            if(chunk != NULL)
+                return chunk;
+        }
+    }
+    else
+    {
+        while(iterator->index < group->chunkLength)
+        {
+            unsigned int index = iterator->index;
+            iterator->index++;
+
+            if(group->chunk[index]->chunkId == iterator->chunkId)
+            {
+                IFF_Chunk *chunk = IFF_loadGroupSubChunk(group, index); /* Reads the chunk body first if it was deferred */
+
+                if(chunk != NULL)
+                    return chunk;
+            }
+        }
+    }
+
+    return NULL;
+}
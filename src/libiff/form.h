@@ -28,7 +28,12 @@ typedef struct IFF_Form IFF_Form;
 
 #include <stdio.h>
 #include "ifftypes.h"
+#include "stream.h"
+#include "hash.h"
+#include "arena.h"
 #include "chunk.h"
+#include "lazy.h"
+#include "chunkindex.h"
 
 /**
  * @brief A special group chunk, which contains an arbitrary number of group chunks and data chunks.
@@ -44,6 +49,15 @@ struct IFF_Form
     /** Contains the size of the chunk data in bytes */
     IFF_Long chunkSize;
 
+    /** Refers to the chunk type that was resolved when the chunk was read, so that it does not have to be looked up again. NULL if it should be looked up in the registry */
+    IFF_ChunkType *chunkType;
+
+    /** Caches the content hash that has been computed by IFF_hashChunk(). Both halves are 0 if it has not been computed, or if it has been invalidated by a modification */
+    IFF_Hash hash;
+
+    /** Refers to the arena from which the chunk has been allocated, or NULL if it has been allocated from the heap. The memory that belongs to the chunk is allocated from the same arena */
+    IFF_Arena *arena;
+
     /**
      * Contains a form type, which is used for most application file formats as an
      * application file format identifier
@@ -55,8 +69,42 @@ struct IFF_Form
 
     /** An array of chunk pointers referring to the sub chunks */
     IFF_Chunk **chunk;
+
+    /** Contains the number of sub chunks for which the array of chunk pointers has room */
+    unsigned int chunkCapacity;
+
+    /** Keeps track of the sub chunks whose bodies are read on first access, or NULL if all sub chunks have been read */
+    IFF_LazyChunks *lazyChunks;
+
+    /** An index of the sub chunks by chunk id, which is built when the group becomes large enough, or NULL if the sub chunks are scanned */
+    IFF_ChunkIndex *chunkIndex;
 };
 
+/**
+ * @brief Visits the sub chunks of a form that have a certain chunk ID one by one, without allocating memory for the result.
+ */
+typedef struct
+{
+    /** The form whose sub chunks are visited */
+    IFF_Form *form;
+
+    /** The chunk ID of the sub chunks that are visited */
+    IFF_ID chunkId;
+
+    /** Indicates whether the positions are taken from the index of the form, or whether the sub chunks are scanned */
+    IFF_Bool indexed;
+
+    /** Positions of the matching sub chunks in the index of the form */
+    const unsigned int *positions;
+
+    /** Contains the number of positions */
+    unsigned int positionsLength;
+
+    /** Index of the next position, or of the next sub chunk to be scanned */
+    unsigned int index;
+}
+IFF_ChunkIterator;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -98,30 +146,31 @@ IFF_Chunk *IFF_createUnparsedForm(const IFF_ID chunkId, const IFF_Long chunkSize
  *
  * @param form An instance of a FORM chunk
  * @param chunk An arbitrary group or data chunk
+ * @return TRUE if the chunk has been added, or FALSE if the memory for it cannot be allocated. In that case, the chunk remains owned by the caller
  */
-void IFF_addToForm(IFF_Form *form, IFF_Chunk *chunk);
+IFF_Bool IFF_addToForm(IFF_Form *form, IFF_Chunk *chunk);
 
 /**
- * Reads a form chunk and its sub chunks from a file.
+ * Reads a form chunk and its sub chunks from a stream.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk An instance of a form chunk
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the FORM has been successfully read, or FALSE if an error has occured
  */
-IFF_Bool IFF_readForm(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_readForm(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
- * Writes a form chunk and its sub chunks to a file.
+ * Writes a form chunk and its sub chunks to a stream.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk An instance of a form chunk
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the FORM has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeForm(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_writeForm(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
  * Checks whether the given form type conforms to the IFF specification.
@@ -198,6 +247,9 @@ void IFF_updateFormChunkSizes(IFF_Form *form);
 
 /**
  * Retrieves the chunk with the given chunk ID from the given form.
+ * If the chunk was read lazily, its body is read first. Forms with many sub
+ * chunks are indexed by chunk ID when they are read or modified, so that
+ * lookups take constant time.
  *
  * @param form An instance of a form chunk
  * @param chunkId An arbitrary chunk ID
@@ -219,6 +271,7 @@ IFF_Chunk *IFF_getChunkFromForm(const IFF_Form *form, const IFF_ID chunkId);
 
 /**
  * Retrieves all the chunks with the given chunk ID from the given form. The resulting array must be freed by using free().
+ * Chunks that were read lazily are loaded first.
  *
  * @param form An instance of a form chunk
  * @param chunkId An arbitrary chunk ID
@@ -227,6 +280,26 @@ IFF_Chunk *IFF_getChunkFromForm(const IFF_Form *form, const IFF_ID chunkId);
  */
 IFF_Chunk **IFF_getChunksFromForm(const IFF_Form *form, const IFF_ID chunkId, unsigned int *chunksLength);
 
+/**
+ * Initializes an iterator that visits all the chunks with the given chunk ID in
+ * the given form, in the order in which they appear. In contrast to
+ * IFF_getChunksFromForm(), no memory is allocated for the result. The iterator
+ * becomes invalid when the form is modified.
+ *
+ * @param iterator An iterator instance
+ * @param form An instance of a form chunk
+ * @param chunkId An arbitrary chunk ID
+ */
+void IFF_iterateChunksInForm(IFF_ChunkIterator *iterator, const IFF_Form *form, const IFF_ID chunkId);
+
+/**
+ * Retrieves the next chunk of an iterator. Chunks that were read lazily are loaded first.
+ *
+ * @param iterator An iterator instance initialized by IFF_iterateChunksInForm()
+ * @return The next chunk with the requested chunk ID, or NULL if there are no more chunks
+ */
+IFF_Chunk *IFF_nextChunkInForm(IFF_ChunkIterator *iterator);
+
 #ifdef __cplusplus
 }
 #endif
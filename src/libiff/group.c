@@ -28,13 +28,20 @@
 #include "prop.h"
 #include "field.h"
 #include "error.h"
+#include "context.h"
 #include "util.h"
+#include "arena.h"
+
+#define IFF_INITIAL_CHUNK_CAPACITY 4
 
 void IFF_initGroup(IFF_Group *group, const IFF_ID groupType)
 {
     group->groupType = groupType;
     group->chunkLength = 0;
     group->chunk = NULL;
+    group->chunkCapacity = 0;
+    group->lazyChunks = NULL;
+    group->chunkIndex = NULL;
 }
 
 IFF_Group *IFF_createGroup(const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ID groupType)
@@ -57,35 +64,197 @@ IFF_Chunk *IFF_createUnparsedGroup(const IFF_ID chunkId, const IFF_Long chunkSiz
     return (IFF_Chunk*)IFF_createGroup(chunkId, chunkSize, 0);
 }
 
-void IFF_attachToGroup(IFF_Group *group, IFF_Chunk *chunk)
+IFF_Bool IFF_reserveGroup(IFF_Group *group, const unsigned int chunkCapacity)
+{
+    if(chunkCapacity > group->chunkCapacity)
+    {
+        IFF_Chunk **chunk = (IFF_Chunk**)IFF_reallocateIn(group->arena, group->chunk, group->chunkCapacity * sizeof(IFF_Chunk*), chunkCapacity * sizeof(IFF_Chunk*));
+
+        if(chunk == NULL)
+        {
+            IFF_recordError(IFF_ERROR_MEMORY);
+            IFF_error("Cannot allocate memory for: %u sub chunks!\n", chunkCapacity);
+            return FALSE;
+        }
+
+        group->chunk = chunk;
+
+        /* The offsets of lazily read sub chunks must have room for the same amount of elements */
+        if(group->lazyChunks != NULL && !IFF_reserveLazyChunks(group, group->chunkCapacity, chunkCapacity))
+            return FALSE;
+
+        group->chunkCapacity = chunkCapacity;
+    }
+
+    return TRUE;
+}
+
+static void invalidateProperties(IFF_Group *group)
+{
+    /* The chunks of a PROP chunk are shared properties of the list in which it is located */
+    if(group->chunkId == IFF_ID_PROP && group->parent != NULL && group->parent->chunkId == IFF_ID_LIST)
+        IFF_invalidateListPropertyCache((IFF_List*)group->parent);
+}
+
+IFF_Bool IFF_isGroupChunk(const IFF_Chunk *chunk)
+{
+    return chunk->chunkId == IFF_ID_FORM
+        || chunk->chunkId == IFF_ID_CAT
+        || chunk->chunkId == IFF_ID_LIST
+        || chunk->chunkId == IFF_ID_PROP;
+}
+
+IFF_Bool IFF_attachToGroup(IFF_Group *group, IFF_Chunk *chunk)
+{
+    /* Double the capacity when the array is full, so that attaching N sub chunks takes a logarithmic amount of reallocations */
+    if(group->chunkLength < group->chunkCapacity || IFF_reserveGroup(group, group->chunkCapacity == 0 ? IFF_INITIAL_CHUNK_CAPACITY : group->chunkCapacity * 2))
+    {
+        group->chunk[group->chunkLength] = chunk;
+        group->chunkLength++;
+        chunk->parent = group;
+        IFF_updateChunkIndex(group, group->chunkLength - 1);
+        invalidateProperties(group);
+        IFF_invalidateChunkHash((IFF_Chunk*)group);
+        return TRUE;
+    }
+    else
+        return FALSE;
+}
+
+static IFF_Long computePaddedChunkSize(const IFF_Long chunkSize)
+{
+    return IFF_ID_SIZE + sizeof(IFF_Long) + chunkSize + (chunkSize % 2 != 0 ? 1 : 0);
+}
+
+void IFF_propagateChunkSizeDelta(IFF_Group *group, IFF_Long delta)
+{
+    if(group != NULL && delta != 0)
+        IFF_invalidateChunkHash((IFF_Chunk*)group);
+
+    /* Each ancestor grows or shrinks by the change of its padded size, so a padding byte that appears or disappears on one level is carried to the next */
+    while(group != NULL && delta != 0)
+    {
+        IFF_Long previousPaddedChunkSize = computePaddedChunkSize(group->chunkSize);
+
+        group->chunkSize += delta;
+        delta = computePaddedChunkSize(group->chunkSize) - previousPaddedChunkSize;
+        group = group->parent;
+    }
+}
+
+IFF_Bool IFF_addToGroup(IFF_Group *group, IFF_Chunk *chunk)
 {
-    group->chunk = (IFF_Chunk**)realloc(group->chunk, (group->chunkLength + 1) * sizeof(IFF_Chunk*));
-    group->chunk[group->chunkLength] = chunk;
-    group->chunkLength++;
+    if(IFF_attachToGroup(group, chunk))
+    {
+        IFF_propagateChunkSizeDelta(group, computePaddedChunkSize(chunk->chunkSize));
+        return TRUE;
+    }
+    else
+        return FALSE;
+}
+
+IFF_Chunk *IFF_removeFromGroup(IFF_Group *group, const unsigned int index)
+{
+    IFF_Chunk *chunk;
+    unsigned int i;
+
+    /* A lazily read sub chunk is loaded first, so that the caller receives a complete chunk */
+    if(index >= group->chunkLength || (chunk = IFF_loadGroupSubChunk(group, index)) == NULL)
+        return NULL;
+
+    /* Shift the remaining sub chunks and their offsets one position to the left */
+    for(i = index + 1; i < group->chunkLength; i++)
+    {
+        group->chunk[i - 1] = group->chunk[i];
+
+        if(group->lazyChunks != NULL)
+            group->lazyChunks->chunkOffset[i - 1] = group->lazyChunks->chunkOffset[i];
+    }
+
+    group->chunkLength--;
+
+    if(group->lazyChunks != NULL)
+        group->lazyChunks->chunkOffset[group->chunkLength] = -1;
+
+    chunk->parent = NULL;
+    IFF_indexGroup(group);
+    invalidateProperties(group);
+    IFF_invalidateChunkHash((IFF_Chunk*)group);
+    IFF_propagateChunkSizeDelta(group, -computePaddedChunkSize(chunk->chunkSize));
+
+    return chunk;
+}
+
+IFF_Chunk *IFF_replaceInGroup(IFF_Group *group, const unsigned int index, IFF_Chunk *chunk)
+{
+    IFF_Chunk *previousChunk;
+
+    if(index >= group->chunkLength || (previousChunk = IFF_loadGroupSubChunk(group, index)) == NULL)
+        return NULL;
+
+    group->chunk[index] = chunk;
     chunk->parent = group;
+    previousChunk->parent = NULL;
+
+    if(chunk->chunkId != previousChunk->chunkId)
+        IFF_indexGroup(group);
+
+    invalidateProperties(group);
+    IFF_invalidateChunkHash((IFF_Chunk*)group);
+
+    IFF_propagateChunkSizeDelta(group, computePaddedChunkSize(chunk->chunkSize) - computePaddedChunkSize(previousChunk->chunkSize));
+
+    return previousChunk;
+}
+
+void IFF_resizeChunk(IFF_Chunk *chunk, const IFF_Long chunkSize)
+{
+    IFF_Long delta = computePaddedChunkSize(chunkSize) - computePaddedChunkSize(chunk->chunkSize);
+
+    chunk->chunkSize = chunkSize;
+    IFF_invalidateChunkHash(chunk);
+    IFF_propagateChunkSizeDelta(chunk->parent, delta);
 }
 
-void IFF_addToGroup(IFF_Group *group, IFF_Chunk *chunk)
+IFF_Bool IFF_checkReadSubChunk(const IFF_Group *group, const IFF_Chunk *subChunk, IFF_Bool (*subChunkCheck) (const IFF_Group *group, const IFF_Chunk *subChunk), const IFF_ChunkRegistry *chunkRegistry)
 {
-    IFF_attachToGroup(group, chunk);
-    group->chunkSize = IFF_incrementChunkSize(group->chunkSize, chunk);
+    if(subChunkCheck != NULL && !subChunkCheck(group, subChunk))
+    {
+        IFF_recordError(IFF_ERROR_INVALID);
+        return FALSE;
+    }
+
+    /* Nested groups have already checked their own contents while they were read */
+    if(IFF_isGroupChunk(subChunk))
+        return TRUE;
+    else
+        return IFF_checkChunk(subChunk, group->groupType, chunkRegistry);
 }
 
-static IFF_Bool readGroupSubChunks(FILE *file, IFF_Group *group, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+static IFF_Bool readGroupSubChunks(IFF_IOStream *stream, IFF_Group *group, IFF_Bool (*subChunkCheck) (const IFF_Group *group, const IFF_Chunk *subChunk), const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
+    IFF_Bool validate = IFF_getValidateOnRead();
+
     while(*bytesProcessed < group->chunkSize)
     {
         /* Read sub chunk */
-        IFF_Chunk *chunk = IFF_readChunk(file, group->groupType, chunkRegistry);
+        IFF_Chunk *chunk = IFF_readSubChunk(stream, group->groupType, chunkRegistry, group->chunkSize - *bytesProcessed);
 
         if(chunk == NULL)
             return FALSE;
 
         /* Attach chunk to the group */
-        IFF_attachToGroup(group, chunk);
+        if(!IFF_attachToGroup(group, chunk))
+        {
+            IFF_freeChunk(chunk, group->groupType, chunkRegistry);
+            return FALSE;
+        }
 
         /* Increase the bytes processed counter */
         *bytesProcessed = IFF_incrementChunkSize(*bytesProcessed, chunk);
+
+        if(validate && !IFF_checkReadSubChunk(group, chunk, subChunkCheck, chunkRegistry))
+            return FALSE;
     }
 
     if(*bytesProcessed > group->chunkSize)
@@ -94,29 +263,54 @@ static IFF_Bool readGroupSubChunks(FILE *file, IFF_Group *group, const IFF_Chunk
     return TRUE;
 }
 
-IFF_Bool IFF_readGroup(FILE *file, IFF_Chunk *chunk, const char *groupTypeName, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool IFF_readCheckedGroup(IFF_IOStream *stream, IFF_Chunk *chunk, const char *groupTypeName, IFF_Bool (*groupTypeCheck) (const IFF_ID groupType), IFF_Bool (*subChunkCheck) (const IFF_Group *group, const IFF_Chunk *subChunk), const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
     IFF_Group *group = (IFF_Group*)chunk;
     IFF_FieldStatus status;
 
     /* Read group type */
-    if((status = IFF_readIdField(file, &group->groupType, chunk, groupTypeName, bytesProcessed)) != IFF_FIELD_MORE)
+    if((status = IFF_readIdField(stream, &group->groupType, chunk, groupTypeName, bytesProcessed)) != IFF_FIELD_MORE)
+    {
+        /* When validating, a group that is too small to contain a group type is rejected */
+        if(status == IFF_FIELD_LAST && IFF_getValidateOnRead() && !IFF_checkGroupChunkSize(group, IFF_ID_SIZE))
+        {
+            IFF_recordError(IFF_ERROR_INVALID);
+            return FALSE;
+        }
+
         return IFF_deriveSuccess(status);
+    }
+
+    /* When validating, the group type is checked before any sub chunk is read */
+    if(groupTypeCheck != NULL && IFF_getValidateOnRead() && !groupTypeCheck(group->groupType))
+    {
+        IFF_recordError(IFF_ERROR_INVALID);
+        return FALSE;
+    }
 
     /* Keep parsing sub chunks until we have read all bytes */
-    if(!readGroupSubChunks(file, group, chunkRegistry, bytesProcessed))
+    if(!readGroupSubChunks(stream, group, subChunkCheck, chunkRegistry, bytesProcessed))
         return FALSE;
 
     return TRUE;
 }
 
-IFF_Bool IFF_writeGroupSubChunks(FILE *file, const IFF_Group *group, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool IFF_readGroup(IFF_IOStream *stream, IFF_Chunk *chunk, const char *groupTypeName, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+{
+    return IFF_readCheckedGroup(stream, chunk, groupTypeName, NULL, NULL, chunkRegistry, bytesProcessed);
+}
+
+IFF_Bool IFF_writeGroupSubChunks(IFF_IOStream *stream, const IFF_Group *group, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
     unsigned int i;
 
+    /* Sub chunks that have been read lazily must be loaded first. This does not change the contents of the group, only its representation */
+    if(!IFF_loadGroupSubChunks((IFF_Group*)group))
+        return FALSE;
+
     for(i = 0; i < group->chunkLength; i++)
     {
-        if(!IFF_writeChunk(file, group->chunk[i], group->groupType, chunkRegistry))
+        if(!IFF_writeChunk(stream, group->chunk[i], group->groupType, chunkRegistry))
         {
             IFF_error("Error writing chunk!\n");
             return FALSE;
@@ -129,15 +323,15 @@ IFF_Bool IFF_writeGroupSubChunks(FILE *file, const IFF_Group *group, const IFF_C
     return TRUE;
 }
 
-IFF_Bool IFF_writeGroup(FILE *file, const IFF_Chunk *chunk, const char *groupTypeName, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool IFF_writeGroup(IFF_IOStream *stream, const IFF_Chunk *chunk, const char *groupTypeName, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
     const IFF_Group *group = (const IFF_Group*)chunk;
     IFF_FieldStatus status;
 
-    if((status = IFF_writeIdField(file, group->groupType, chunk, groupTypeName, bytesProcessed)) != IFF_FIELD_MORE)
+    if((status = IFF_writeIdField(stream, group->groupType, chunk, groupTypeName, bytesProcessed)) != IFF_FIELD_MORE)
         return IFF_deriveSuccess(status);
 
-    if(!IFF_writeGroupSubChunks(file, group, chunkRegistry, bytesProcessed))
+    if(!IFF_writeGroupSubChunks(stream, group, chunkRegistry, bytesProcessed))
         return FALSE;
 
     return TRUE;
@@ -161,6 +355,9 @@ IFF_Long IFF_checkGroupSubChunks(const IFF_Group *group, IFF_Bool (*subChunkChec
     unsigned int i;
     IFF_Long chunkSize = 0;
 
+    if(!IFF_loadGroupSubChunks((IFF_Group*)group))
+        return -1;
+
     for(i = 0; i < group->chunkLength; i++)
     {
         IFF_Chunk *subChunk = group->chunk[i];
@@ -201,9 +398,17 @@ void IFF_freeGroup(IFF_Group *group, const IFF_ChunkRegistry *chunkRegistry)
     unsigned int i;
 
     for(i = 0; i < group->chunkLength; i++)
-        IFF_freeChunk(group->chunk[i], group->groupType, chunkRegistry);
+    {
+        /* Placeholders of sub chunks that have not been loaded only consist of the common chunk properties */
+        if(IFF_isLazyGroupSubChunk(group, i))
+            IFF_deallocateIn(group->chunk[i]->arena, group->chunk[i]);
+        else
+            IFF_freeChunk(group->chunk[i], group->groupType, chunkRegistry);
+    }
 
-    free(group->chunk);
+    IFF_freeLazyChunks(group);
+    IFF_freeChunkIndex(group);
+    IFF_deallocateIn(group->arena, group->chunk);
 }
 
 void IFF_printGroupType(const char *groupTypeName, const IFF_ID groupType, const unsigned int indentLevel)
@@ -220,7 +425,12 @@ void IFF_printGroupSubChunks(const IFF_Group *group, const unsigned int indentLe
     IFF_printIndent(stdout, indentLevel, "[\n");
 
     for(i = 0; i < group->chunkLength; i++)
-        IFF_printChunk((IFF_Chunk*)group->chunk[i], indentLevel + 1, group->groupType, chunkRegistry);
+    {
+        IFF_Chunk *subChunk = IFF_loadGroupSubChunk((IFF_Group*)group, i);
+
+        if(subChunk != NULL)
+            IFF_printChunk(subChunk, indentLevel + 1, group->groupType, chunkRegistry);
+    }
 
     IFF_printIndent(stdout, indentLevel, "];\n");
 }
@@ -231,12 +441,59 @@ void IFF_printGroup(const IFF_Group *group, const unsigned int indentLevel, cons
     IFF_printGroupSubChunks(group, indentLevel, chunkRegistry);
 }
 
+IFF_Hash IFF_hashGroup(const IFF_Group *group, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_Hasher hasher;
+    unsigned int i;
+
+    IFF_initHasher(&hasher);
+    IFF_updateHasherWithULong(&hasher, group->chunkId);
+    IFF_updateHasherWithULong(&hasher, group->chunkSize);
+    IFF_updateHasherWithULong(&hasher, group->groupType);
+
+    if(group->chunkId == IFF_ID_LIST)
+    {
+        const IFF_List *list = (const IFF_List*)group;
+
+        for(i = 0; i < list->propLength; i++)
+        {
+            IFF_Hash hash = IFF_hashChunk((IFF_Chunk*)list->prop[i], list->contentsType, chunkRegistry);
+            IFF_updateHasherWithULong(&hasher, hash.high);
+            IFF_updateHasherWithULong(&hasher, hash.low);
+        }
+    }
+
+    /* The hash of the group is derived from the hashes of its sub chunks, so that unmodified sub chunks do not have to be hashed again */
+    for(i = 0; i < group->chunkLength; i++)
+    {
+        IFF_Chunk *subChunk = IFF_loadGroupSubChunk((IFF_Group*)group, i);
+
+        if(subChunk == NULL)
+        {
+            /* A sub chunk that cannot be loaded is represented by its header */
+            IFF_updateHasherWithULong(&hasher, group->chunk[i]->chunkId);
+            IFF_updateHasherWithULong(&hasher, group->chunk[i]->chunkSize);
+        }
+        else
+        {
+            IFF_Hash hash = IFF_hashChunk(subChunk, group->groupType, chunkRegistry);
+            IFF_updateHasherWithULong(&hasher, hash.high);
+            IFF_updateHasherWithULong(&hasher, hash.low);
+        }
+    }
+
+    return IFF_finishHasher(&hasher);
+}
+
 IFF_Bool IFF_compareGroup(const IFF_Group *group1, const IFF_Group *group2, const IFF_ChunkRegistry *chunkRegistry)
 {
     if(group1->groupType == group2->groupType && group1->chunkLength == group2->chunkLength)
     {
         unsigned int i;
 
+        if(!IFF_loadGroupSubChunks((IFF_Group*)group1) || !IFF_loadGroupSubChunks((IFF_Group*)group2))
+            return FALSE;
+
         for(i = 0; i < group1->chunkLength; i++)
         {
             if(!IFF_compareChunk(group1->chunk[i], group2->chunk[i], group1->groupType, chunkRegistry))
@@ -249,22 +506,134 @@ IFF_Bool IFF_compareGroup(const IFF_Group *group1, const IFF_Group *group2, cons
         return FALSE;
 }
 
-IFF_Form **IFF_searchFormsInGroup(IFF_Group *group, const IFF_ID *formTypes, const unsigned int formTypesLength, unsigned int *formsLength)
+/**
+ * @brief A small set of form types. A bit mask of hashed form types rejects most non-matching form types without comparing them one by one.
+ */
+typedef struct
+{
+    /** An array of 4 character form type IDs */
+    const IFF_ID *formTypes;
+
+    /** Length of the form types array */
+    unsigned int formTypesLength;
+
+    /** Has a bit set for each form type in the array */
+    unsigned int mask;
+}
+IFF_FormTypeSet;
+
+static unsigned int getFormTypeBit(const IFF_ID formType)
+{
+    return 1U << ((formType * 0x9e3779b1U) >> 27);
+}
+
+static void initFormTypeSet(IFF_FormTypeSet *formTypeSet, const IFF_ID *formTypes, const unsigned int formTypesLength)
 {
-    IFF_Form **forms = NULL;
     unsigned int i;
 
-    *formsLength = 0;
+    formTypeSet->formTypes = formTypes;
+    formTypeSet->formTypesLength = formTypesLength;
+    formTypeSet->mask = 0;
+
+    for(i = 0; i < formTypesLength; i++)
+        formTypeSet->mask |= getFormTypeBit(formTypes[i]);
+}
+
+static IFF_Bool containsFormType(const IFF_FormTypeSet *formTypeSet, const IFF_ID formType)
+{
+    if((formTypeSet->mask & getFormTypeBit(formType)) != 0)
+    {
+        unsigned int i;
+
+        for(i = 0; i < formTypeSet->formTypesLength; i++)
+        {
+            if(formTypeSet->formTypes[i] == formType)
+                return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static IFF_Bool visitFormsInChunk(IFF_Chunk *chunk, const IFF_FormTypeSet *formTypeSet, IFF_Bool (*visitForm) (void *data, IFF_Form *form), void *data);
+
+static IFF_Bool visitFormsInGroup(IFF_Group *group, const IFF_FormTypeSet *formTypeSet, IFF_Bool (*visitForm) (void *data, IFF_Form *form), void *data)
+{
+    unsigned int i;
 
     for(i = 0; i < group->chunkLength; i++)
     {
-        unsigned int resultLength;
-        IFF_Form **result = IFF_searchFormsFromArray(group->chunk[i], formTypes, formTypesLength, &resultLength);
+        if(!visitFormsInChunk(group->chunk[i], formTypeSet, visitForm, data))
+            return FALSE;
+    }
 
-        forms = IFF_mergeFormArray(forms, formsLength, result, resultLength);
+    return TRUE;
+}
+
+static IFF_Bool visitFormsInChunk(IFF_Chunk *chunk, const IFF_FormTypeSet *formTypeSet, IFF_Bool (*visitForm) (void *data, IFF_Form *form), void *data)
+{
+    switch(chunk->chunkId)
+    {
+        case IFF_ID_FORM:
+            /* A form that is what we look for is visited, but not searched into */
+            if(containsFormType(formTypeSet, ((IFF_Form*)chunk)->formType))
+                return visitForm(data, (IFF_Form*)chunk);
+            else
+                return visitFormsInGroup((IFF_Group*)chunk, formTypeSet, visitForm, data);
+        case IFF_ID_CAT:
+        case IFF_ID_LIST:
+            return visitFormsInGroup((IFF_Group*)chunk, formTypeSet, visitForm, data);
+        default:
+            return TRUE;
     }
+}
+
+/**
+ * @brief Collects the forms that have been found by a search. When no array has been provided, the forms are only counted.
+ */
+typedef struct
+{
+    /** An array in which the forms are stored, or NULL to count them */
+    IFF_Form **forms;
 
-    return forms;
+    /** Contains the number of forms that have been found */
+    unsigned int formsLength;
+}
+IFF_FormCollector;
+
+static IFF_Bool collectForm(void *data, IFF_Form *form)
+{
+    IFF_FormCollector *formCollector = (IFF_FormCollector*)data;
+
+    if(formCollector->forms != NULL)
+        formCollector->forms[formCollector->formsLength] = form;
+
+    formCollector->formsLength++;
+    return TRUE;
+}
+
+IFF_Form **IFF_searchFormsInGroup(IFF_Group *group, const IFF_ID *formTypes, const unsigned int formTypesLength, unsigned int *formsLength)
+{
+    IFF_FormTypeSet formTypeSet;
+    IFF_FormCollector formCollector;
+
+    initFormTypeSet(&formTypeSet, formTypes, formTypesLength);
+
+    /* Count the forms first, so that the result array is allocated only once */
+    formCollector.forms = NULL;
+    formCollector.formsLength = 0;
+    visitFormsInGroup(group, &formTypeSet, &collectForm, &formCollector);
+
+    *formsLength = 0;
+
+    if(formCollector.formsLength == 0 || (formCollector.forms = (IFF_Form**)malloc(formCollector.formsLength * sizeof(IFF_Form*))) == NULL)
+        return NULL;
+
+    formCollector.formsLength = 0;
+    visitFormsInGroup(group, &formTypeSet, &collectForm, &formCollector);
+
+    *formsLength = formCollector.formsLength;
+    return formCollector.forms;
 }
 
 IFF_Long IFF_incrementChunkSize(const IFF_Long chunkSize, const IFF_Chunk *chunk)
@@ -280,12 +649,16 @@ IFF_Long IFF_incrementChunkSize(const IFF_Long chunkSize, const IFF_Chunk *chunk
 
 void IFF_updateGroupChunkSizes(IFF_Group *group)
 {
+    IFF_Long previousChunkSize = group->chunkSize;
     unsigned int i;
 
     group->chunkSize = IFF_ID_SIZE;
 
     for(i = 0; i < group->chunkLength; i++)
         group->chunkSize = IFF_incrementChunkSize(group->chunkSize, group->chunk[i]);
+
+    if(group->chunkSize != previousChunkSize)
+        IFF_invalidateChunkHash((IFF_Chunk*)group);
 }
 
 IFF_Form **IFF_searchFormsFromArray(IFF_Chunk *chunk, const IFF_ID *formTypes, const unsigned int formTypesLength, unsigned int *formsLength)
@@ -311,6 +684,37 @@ IFF_Form **IFF_searchForms(IFF_Chunk *chunk, const IFF_ID formType, unsigned int
     return IFF_searchFormsFromArray(chunk, formTypes, 1, formsLength);
 }
 
+IFF_Bool IFF_forEachFormFromArray(IFF_Chunk *chunk, const IFF_ID *formTypes, const unsigned int formTypesLength, IFF_Bool (*visitForm) (void *data, IFF_Form *form), void *data)
+{
+    IFF_FormTypeSet formTypeSet;
+
+    initFormTypeSet(&formTypeSet, formTypes, formTypesLength);
+    return visitFormsInChunk(chunk, &formTypeSet, visitForm, data);
+}
+
+IFF_Bool IFF_forEachForm(IFF_Chunk *chunk, const IFF_ID formType, IFF_Bool (*visitForm) (void *data, IFF_Form *form), void *data)
+{
+    return IFF_forEachFormFromArray(chunk, &formType, 1, visitForm, data);
+}
+
+static IFF_Bool keepFirstForm(void *data, IFF_Form *form)
+{
+    *((IFF_Form**)data) = form;
+    return FALSE; /* Stop the search after the first match */
+}
+
+IFF_Form *IFF_findFirstFormFromArray(IFF_Chunk *chunk, const IFF_ID *formTypes, const unsigned int formTypesLength)
+{
+    IFF_Form *form = NULL;
+    IFF_forEachFormFromArray(chunk, formTypes, formTypesLength, &keepFirstForm, &form);
+    return form;
+}
+
+IFF_Form *IFF_findFirstForm(IFF_Chunk *chunk, const IFF_ID formType)
+{
+    return IFF_findFirstFormFromArray(chunk, &formType, 1);
+}
+
 void IFF_updateChunkSizes(IFF_Chunk *chunk)
 {
     /* Check whether the given chunk is a group chunk and update the sizes */
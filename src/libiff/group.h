@@ -26,7 +26,12 @@ typedef struct IFF_Group IFF_Group;
 
 #include <stdio.h>
 #include "ifftypes.h"
+#include "stream.h"
+#include "hash.h"
+#include "arena.h"
 #include "chunk.h"
+#include "lazy.h"
+#include "chunkindex.h"
 #include "form.h"
 
 #ifdef __cplusplus
@@ -47,6 +52,15 @@ struct IFF_Group
     /** Contains the size of the chunk data in bytes */
     IFF_Long chunkSize;
 
+    /** Refers to the chunk type that was resolved when the chunk was read, so that it does not have to be looked up again. NULL if it should be looked up in the registry */
+    IFF_ChunkType *chunkType;
+
+    /** Caches the content hash that has been computed by IFF_hashChunk(). Both halves are 0 if it has not been computed, or if it has been invalidated by a modification */
+    IFF_Hash hash;
+
+    /** Refers to the arena from which the chunk has been allocated, or NULL if it has been allocated from the heap. The memory that belongs to the chunk is allocated from the same arena */
+    IFF_Arena *arena;
+
     /** Could be either a formType or a contentsType */
     IFF_ID groupType;
 
@@ -55,6 +69,15 @@ struct IFF_Group
 
     /** An array of chunk pointers referring to the sub chunks */
     IFF_Chunk **chunk;
+
+    /** Contains the number of sub chunks for which the array of chunk pointers has room */
+    unsigned int chunkCapacity;
+
+    /** Keeps track of the sub chunks whose bodies are read on first access, or NULL if all sub chunks have been read */
+    IFF_LazyChunks *lazyChunks;
+
+    /** An index of the sub chunks by chunk id, which is built when the group becomes large enough, or NULL if the sub chunks are scanned */
+    IFF_ChunkIndex *chunkIndex;
 };
 
 /**
@@ -98,57 +121,153 @@ IFF_Group *IFF_createEmptyGroup(const IFF_ID chunkId, const IFF_ID groupType);
  */
 IFF_Chunk *IFF_createUnparsedGroup(const IFF_ID chunkId, const IFF_Long chunkSize);
 
+/**
+ * Ensures that the given group has room for at least the given number of sub
+ * chunks, so that they can be attached without enlarging the array of chunk
+ * pointers in between. Builders that know the number of sub chunks in advance
+ * can use this function to allocate the array only once.
+ *
+ * @param group An instance of a group chunk
+ * @param chunkCapacity The number of sub chunks for which the group should have room
+ * @return TRUE if the group has room for the given number of sub chunks, else FALSE
+ */
+IFF_Bool IFF_reserveGroup(IFF_Group *group, const unsigned int chunkCapacity);
+
+/**
+ * Checks whether a chunk is a group chunk: a FORM, CAT, LIST or PROP.
+ *
+ * @param chunk An arbitrary chunk
+ * @return TRUE if the chunk is a group chunk, else FALSE
+ */
+IFF_Bool IFF_isGroupChunk(const IFF_Chunk *chunk);
+
 /**
  * Attaches a chunk to the body of the given group.
  *
  * @param group An instance of a group chunk
  * @param chunk An arbitrary group or data chunk
+ * @return TRUE if the chunk has been attached, or FALSE if the memory for it cannot be allocated. In that case, the chunk remains owned by the caller
  */
-void IFF_attachToGroup(IFF_Group *group, IFF_Chunk *chunk);
+IFF_Bool IFF_attachToGroup(IFF_Group *group, IFF_Chunk *chunk);
 
 /**
  * Adds a chunk to the body of the given group. This function also increments the
- * chunk size and chunk length counter.
+ * chunk length counter and the chunk sizes of the group and all its ancestors.
  *
  * @param group An instance of a group chunk
  * @param chunk An arbitrary group or data chunk
+ * @return TRUE if the chunk has been added, or FALSE if the memory for it cannot be allocated. In that case, the chunk remains owned by the caller
+ */
+IFF_Bool IFF_addToGroup(IFF_Group *group, IFF_Chunk *chunk);
+
+/**
+ * Adds the given amount of bytes to the chunk size of the given group and
+ * applies the resulting change to the chunk sizes of all its ancestors. Because
+ * a padding byte may appear or disappear on every level, the change is
+ * recomputed for each ancestor. This takes time proportional to the depth of
+ * the group, rather than to the amount of sub chunks of its ancestors.
+ *
+ * @param group An instance of a group chunk, or NULL
+ * @param delta Amount of bytes to add to the chunk size, which may be negative
+ */
+void IFF_propagateChunkSizeDelta(IFF_Group *group, IFF_Long delta);
+
+/**
+ * Removes the sub chunk at the given index from the given group and updates the
+ * chunk sizes of the group and all its ancestors. The removed chunk is detached
+ * from the group and must be freed by the caller.
+ *
+ * @param group An instance of a group chunk
+ * @param index Index of the sub chunk to remove
+ * @return The removed chunk or NULL if the index is out of bounds or the chunk cannot be loaded
+ */
+IFF_Chunk *IFF_removeFromGroup(IFF_Group *group, const unsigned int index);
+
+/**
+ * Replaces the sub chunk at the given index of the given group by another chunk
+ * and updates the chunk sizes of the group and all its ancestors. The replaced
+ * chunk is detached from the group and must be freed by the caller.
+ *
+ * @param group An instance of a group chunk
+ * @param index Index of the sub chunk to replace
+ * @param chunk An arbitrary group or data chunk
+ * @return The replaced chunk or NULL if the index is out of bounds or the chunk cannot be loaded
+ */
+IFF_Chunk *IFF_replaceInGroup(IFF_Group *group, const unsigned int index, IFF_Chunk *chunk);
+
+/**
+ * Changes the chunk size of the given chunk and updates the chunk sizes of all
+ * the group chunks in which it is located.
+ *
+ * @param chunk An arbitrary group or data chunk
+ * @param chunkSize The new size of the chunk data
+ */
+void IFF_resizeChunk(IFF_Chunk *chunk, const IFF_Long chunkSize);
+
+/**
+ * Reads a group chunk and its sub chunks from a stream.
+ *
+ * @param stream An I/O stream
+ * @param chunk An instance of a group chunk
+ * @param groupTypeName Specifies what the group type is called. Could be 'formType' or 'contentsType'
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param bytesProcessed Indicates how many bytes in the chunk body were processed
+ * @return TRUE if the group has been successfully read, or FALSE if an error has occured
  */
-void IFF_addToGroup(IFF_Group *group, IFF_Chunk *chunk);
+IFF_Bool IFF_readGroup(IFF_IOStream *stream, IFF_Chunk *chunk, const char *groupTypeName, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
- * Reads a group chunk and its sub chunks from a file.
+ * Reads a group chunk and its sub chunks from a stream. If validate-on-read
+ * has been enabled with IFF_selectValidateOnRead(), the group type and each
+ * sub chunk are checked as soon as they have been read, and reading stops at
+ * the first violation.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk An instance of a group chunk
  * @param groupTypeName Specifies what the group type is called. Could be 'formType' or 'contentsType'
+ * @param groupTypeCheck Pointer to a function, which checks the groupType for its validity, or NULL to skip the check
+ * @param subChunkCheck Pointer to a function, which checks an individual sub chunk for its validity, or NULL to skip the check
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the group has been successfully read, or FALSE if an error has occured
  */
-IFF_Bool IFF_readGroup(FILE *file, IFF_Chunk *chunk, const char *groupTypeName, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_readCheckedGroup(IFF_IOStream *stream, IFF_Chunk *chunk, const char *groupTypeName, IFF_Bool (*groupTypeCheck) (const IFF_ID groupType), IFF_Bool (*subChunkCheck) (const IFF_Group *group, const IFF_Chunk *subChunk), const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
- * Writes all sub chunks inside a group to a file.
+ * Checks a sub chunk that has just been read into a group. Nested groups
+ * check their own contents while they are read, so only the contents of data
+ * chunks are checked here.
  *
- * @param file File descriptor of the file
+ * @param group An instance of a group chunk
+ * @param subChunk A sub chunk of the group
+ * @param subChunkCheck Pointer to a function, which checks an individual sub chunk for its validity, or NULL to skip the check
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return TRUE if the sub chunk is valid, else FALSE
+ */
+IFF_Bool IFF_checkReadSubChunk(const IFF_Group *group, const IFF_Chunk *subChunk, IFF_Bool (*subChunkCheck) (const IFF_Group *group, const IFF_Chunk *subChunk), const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Writes all sub chunks inside a group to a stream.
+ *
+ * @param stream An I/O stream
  * @param group An instance of a group chunk
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the sub chunks have been successfully written, else FALSE
  */
-IFF_Bool IFF_writeGroupSubChunks(FILE *file, const IFF_Group *group, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_writeGroupSubChunks(IFF_IOStream *stream, const IFF_Group *group, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
- * Writes a group chunk and its sub chunks to a file.
+ * Writes a group chunk and its sub chunks to a stream.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk An instance of a group chunk
  * @param groupTypeName Specifies what the group type is called. Could be 'formType' or 'contentsType'
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the group has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeGroup(FILE *file, const IFF_Chunk *chunk, const char *groupTypeName, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_writeGroup(IFF_IOStream *stream, const IFF_Chunk *chunk, const char *groupTypeName, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
  * Checks whether the given chunk size matches the chunk size of the group
@@ -216,6 +335,17 @@ void IFF_printGroupSubChunks(const IFF_Group *group, const unsigned int indentLe
  */
 void IFF_printGroup(const IFF_Group *group, const unsigned int indentLevel, const char *groupTypeName, const IFF_ChunkRegistry *chunkRegistry);
 
+/**
+ * Computes the content hash of a group from its chunk ID, chunk size, group
+ * type and the hashes of its sub chunks. The PROP chunks of a LIST are
+ * included as well. It is invoked by IFF_hashChunk(), which caches the result.
+ *
+ * @param group An instance of a group chunk
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return The hash of the group
+ */
+IFF_Hash IFF_hashGroup(const IFF_Group *group, const IFF_ChunkRegistry *chunkRegistry);
+
 /**
  * Checks whether the given group chunks' contents is equal to each other.
  *
@@ -275,6 +405,53 @@ IFF_Form **IFF_searchFormsFromArray(IFF_Chunk *chunk, const IFF_ID *formTypes, c
  */
 IFF_Form **IFF_searchForms(IFF_Chunk *chunk, const IFF_ID formType, unsigned int *formsLength);
 
+/**
+ * Recursively visits all FORMs with the given form types in a chunk hierarchy,
+ * in the order in which they appear, without allocating memory. A FORM that
+ * has one of the given form types is not searched into.
+ *
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param formTypes An array of 4 character form identifiers
+ * @param formTypesLength Length of the form types array
+ * @param visitForm Pointer to a function that is invoked for every matching form. It returns FALSE to stop the search
+ * @param data Arbitrary data that is passed to the visitForm function
+ * @return TRUE if all matching forms have been visited, or FALSE if the search has been stopped
+ */
+IFF_Bool IFF_forEachFormFromArray(IFF_Chunk *chunk, const IFF_ID *formTypes, const unsigned int formTypesLength, IFF_Bool (*visitForm) (void *data, IFF_Form *form), void *data);
+
+/**
+ * Recursively visits all FORMs with the given form type in a chunk hierarchy,
+ * in the order in which they appear, without allocating memory.
+ *
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param formType A 4 character form identifier
+ * @param visitForm Pointer to a function that is invoked for every matching form. It returns FALSE to stop the search
+ * @param data Arbitrary data that is passed to the visitForm function
+ * @return TRUE if all matching forms have been visited, or FALSE if the search has been stopped
+ */
+IFF_Bool IFF_forEachForm(IFF_Chunk *chunk, const IFF_ID formType, IFF_Bool (*visitForm) (void *data, IFF_Form *form), void *data);
+
+/**
+ * Searches for the first FORM with one of the given form types in a chunk
+ * hierarchy. The search stops as soon as it has been found.
+ *
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param formTypes An array of 4 character form identifiers
+ * @param formTypesLength Length of the form types array
+ * @return The first form having one of the given form types, or NULL if there is none
+ */
+IFF_Form *IFF_findFirstFormFromArray(IFF_Chunk *chunk, const IFF_ID *formTypes, const unsigned int formTypesLength);
+
+/**
+ * Searches for the first FORM with the given form type in a chunk hierarchy.
+ * The search stops as soon as it has been found.
+ *
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param formType A 4 character form identifier
+ * @return The first form having the given form type, or NULL if there is none
+ */
+IFF_Form *IFF_findFirstForm(IFF_Chunk *chunk, const IFF_ID formType);
+
 /**
  * Recalculates the chunk size of the given chunk and recursively updates the chunk sizes of the parent group chunks.
  *
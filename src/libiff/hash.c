@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "hash.h"
+
+#define ROTATE_LEFT(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
+
+/* The two halves use the constants of MurmurHash3, and are mixed into each other after each word */
+
+static void hashWord(IFF_Hasher *hasher, IFF_ULong word)
+{
+    IFF_ULong high = word * 0x85ebca6bU, low = word * 0xcc9e2d51U;
+
+    high = ROTATE_LEFT(high, 16) * 0xc2b2ae35U;
+    low = ROTATE_LEFT(low, 15) * 0x1b873593U;
+
+    hasher->high ^= high;
+    hasher->high = ROTATE_LEFT(hasher->high, 17) * 5 + 0x561ccd1bU;
+
+    hasher->low ^= low;
+    hasher->low = ROTATE_LEFT(hasher->low, 13) * 5 + 0xe6546b64U;
+
+    hasher->high += hasher->low;
+    hasher->low += hasher->high;
+}
+
+static IFF_ULong finishWord(IFF_ULong value)
+{
+    value ^= value >> 16;
+    value *= 0x85ebca6bU;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35U;
+    value ^= value >> 16;
+    return value;
+}
+
+void IFF_initHasher(IFF_Hasher *hasher)
+{
+    hasher->high = 0x9e3779b9U;
+    hasher->low = 0x7f4a7c15U;
+    hasher->tail = 0;
+    hasher->tailLength = 0;
+    hasher->length = 0;
+}
+
+void IFF_updateHasher(IFF_Hasher *hasher, const void *data, const size_t size)
+{
+    const IFF_UByte *bytes = (const IFF_UByte*)data;
+    size_t i = 0;
+
+    hasher->length += (IFF_ULong)size;
+
+    /* Complete the word that was left incomplete by the previous update */
+    while(hasher->tailLength > 0 && i < size)
+    {
+        hasher->tail = (hasher->tail << 8) | bytes[i];
+        hasher->tailLength++;
+        i++;
+
+        if(hasher->tailLength == 4)
+        {
+            hashWord(hasher, hasher->tail);
+            hasher->tail = 0;
+            hasher->tailLength = 0;
+        }
+    }
+
+    /* Hash complete words. They are composed in big-endian order, so that the hash does not depend on the platform */
+    for(; i + 4 <= size; i += 4)
+        hashWord(hasher, ((IFF_ULong)bytes[i] << 24) | ((IFF_ULong)bytes[i + 1] << 16) | ((IFF_ULong)bytes[i + 2] << 8) | bytes[i + 3]);
+
+    /* Keep the remaining bytes until the word is completed */
+    for(; i < size; i++)
+    {
+        hasher->tail = (hasher->tail << 8) | bytes[i];
+        hasher->tailLength++;
+    }
+}
+
+void IFF_updateHasherWithULong(IFF_Hasher *hasher, const IFF_ULong value)
+{
+    if(hasher->tailLength == 0)
+    {
+        hasher->length += 4;
+        hashWord(hasher, value);
+    }
+    else
+    {
+        IFF_UByte bytes[4];
+
+        bytes[0] = (IFF_UByte)(value >> 24);
+        bytes[1] = (IFF_UByte)(value >> 16);
+        bytes[2] = (IFF_UByte)(value >> 8);
+        bytes[3] = (IFF_UByte)value;
+
+        IFF_updateHasher(hasher, bytes, 4);
+    }
+}
+
+IFF_Hash IFF_finishHasher(const IFF_Hasher *hasher)
+{
+    IFF_ULong high = hasher->high, low = hasher->low;
+    IFF_Hash hash;
+
+    if(hasher->tailLength > 0)
+    {
+        IFF_ULong tail = hasher->tail * 0xcc9e2d51U;
+        low ^= ROTATE_LEFT(tail, 15) * 0x1b873593U;
+        high ^= tail;
+    }
+
+    /* The length distinguishes an incomplete word from one with leading zero bytes */
+    high ^= hasher->length;
+    low ^= hasher->length;
+
+    high += low;
+    low += high;
+
+    high = finishWord(high);
+    low = finishWord(low);
+
+    high += low;
+    low += high;
+
+    hash.high = high;
+    hash.low = low;
+
+    return hash;
+}
+
+IFF_Bool IFF_compareHash(const IFF_Hash hash1, const IFF_Hash hash2)
+{
+    return hash1.high == hash2.high && hash1.low == hash2.low;
+}
+
+static size_t readHash(IFF_IOStream *stream, void *buffer, const size_t size)
+{
+    return 0;
+}
+
+static size_t writeHash(IFF_IOStream *stream, const void *buffer, const size_t size)
+{
+    IFF_updateHasher(&((IFF_HashIOStream*)stream)->hasher, buffer, size);
+    return size;
+}
+
+static IFF_Bool seekHash(IFF_IOStream *stream, const long offset, const int origin)
+{
+    return FALSE;
+}
+
+static long tellHash(IFF_IOStream *stream)
+{
+    return ((IFF_HashIOStream*)stream)->hasher.length;
+}
+
+void IFF_initHashIOStream(IFF_HashIOStream *stream)
+{
+    stream->read = &readHash;
+    stream->write = &writeHash;
+    stream->seek = &seekHash;
+    stream->tell = &tellHash;
+    stream->sparse = FALSE;
+    IFF_initHasher(&stream->hasher);
+}
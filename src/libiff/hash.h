@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_HASH_H
+#define __IFF_HASH_H
+
+typedef struct IFF_HashIOStream IFF_HashIOStream;
+
+#include <stddef.h>
+#include "ifftypes.h"
+#include "stream.h"
+
+/**
+ * @brief A 64-bit non-cryptographic content hash, consisting of two 32-bit halves
+ */
+typedef struct
+{
+    /** The upper 32 bits of the hash */
+    IFF_ULong high;
+
+    /** The lower 32 bits of the hash */
+    IFF_ULong low;
+}
+IFF_Hash;
+
+/**
+ * @brief Computes a hash over a sequence of bytes that may be provided in arbitrary portions
+ */
+typedef struct
+{
+    /** The state of the upper half of the hash */
+    IFF_ULong high;
+
+    /** The state of the lower half of the hash */
+    IFF_ULong low;
+
+    /** The bytes of an incomplete 32-bit word, that are kept until the word is completed */
+    IFF_ULong tail;
+
+    /** Contains the amount of bytes in the incomplete 32-bit word */
+    unsigned int tailLength;
+
+    /** Contains the total amount of bytes that have been hashed, modulo 2^32 */
+    IFF_ULong length;
+}
+IFF_Hasher;
+
+/**
+ * @brief A stream that hashes everything that is written to it, so that a chunk can be hashed by writing it
+ */
+struct IFF_HashIOStream
+{
+    /** Function responsible for reading the given amount of bytes into a buffer. Reading is not supported */
+    size_t (*read) (IFF_IOStream *stream, void *buffer, const size_t size);
+
+    /** Function responsible for hashing the given amount of bytes from a buffer */
+    size_t (*write) (IFF_IOStream *stream, const void *buffer, const size_t size);
+
+    /** Function responsible for moving the position of the stream. Seeking is not supported */
+    IFF_Bool (*seek) (IFF_IOStream *stream, const long offset, const int origin);
+
+    /** Function responsible for returning the amount of bytes that have been written */
+    long (*tell) (IFF_IOStream *stream);
+
+    /** Indicates whether large zero fillers can be written as holes, which is never the case for hashes */
+    IFF_Bool sparse;
+
+    /** The hasher that receives the written bytes */
+    IFF_Hasher hasher;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a hasher, so that it has not hashed any bytes.
+ *
+ * @param hasher A hasher instance
+ */
+void IFF_initHasher(IFF_Hasher *hasher);
+
+/**
+ * Adds the given bytes to the hash.
+ *
+ * @param hasher A hasher instance
+ * @param data Pointer to the first byte to hash
+ * @param size Amount of bytes to hash
+ */
+void IFF_updateHasher(IFF_Hasher *hasher, const void *data, const size_t size);
+
+/**
+ * Adds a 32-bit value to the hash, in big-endian byte order.
+ *
+ * @param hasher A hasher instance
+ * @param value A 32-bit value
+ */
+void IFF_updateHasherWithULong(IFF_Hasher *hasher, const IFF_ULong value);
+
+/**
+ * Computes the hash of all the bytes that have been added. The hasher itself
+ * is not modified, so that more bytes can be added afterwards.
+ *
+ * @param hasher A hasher instance
+ * @return The hash of the bytes that have been added
+ */
+IFF_Hash IFF_finishHasher(const IFF_Hasher *hasher);
+
+/**
+ * Checks whether two hashes are equal.
+ *
+ * @param hash1 Hash to compare
+ * @param hash2 Hash to compare
+ * @return TRUE if the hashes are equal, else FALSE
+ */
+IFF_Bool IFF_compareHash(const IFF_Hash hash1, const IFF_Hash hash2);
+
+/**
+ * Initializes a stream that hashes all bytes that are written to it.
+ *
+ * @param stream A hash stream instance
+ */
+void IFF_initHashIOStream(IFF_HashIOStream *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
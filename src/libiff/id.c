@@ -24,14 +24,14 @@
 #include "io.h"
 #include "error.h"
 
-IFF_Bool IFF_readId(FILE *file, IFF_ID *id, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_readId(IFF_IOStream *stream, IFF_ID *id, const IFF_ID chunkId, const char *attributeName)
 {
-    return IFF_readULong(file, id, chunkId, attributeName);
+    return IFF_readULong(stream, id, chunkId, attributeName);
 }
 
-IFF_Bool IFF_writeId(FILE *file, const IFF_ID id, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_writeId(IFF_IOStream *stream, const IFF_ID id, const IFF_ID chunkId, const char *attributeName)
 {
-    return IFF_writeULong(file, id, chunkId, attributeName);
+    return IFF_writeULong(stream, id, chunkId, attributeName);
 }
 
 void IFF_idToString(const IFF_ID id, IFF_ID2 id2)
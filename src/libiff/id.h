@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include "ifftypes.h"
+#include "stream.h"
 
 #define IFF_MAKEID(a, b, c, d) ( (a) << 24 | (b) << 16 | (c) << 8 | (d) )
 
@@ -34,26 +35,26 @@ extern "C" {
 #endif
 
 /**
- * Reads an IFF id from a file
+ * Reads an IFF id from a stream
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param id A 4 character IFF id
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the ID is succesfully read, else FALSE
  */
-IFF_Bool IFF_readId(FILE *file, IFF_ID *id, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_readId(IFF_IOStream *stream, IFF_ID *id, const IFF_ID chunkId, const char *attributeName);
 
 /**
- * Writes an IFF id to a file
+ * Writes an IFF id to a stream
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param id A 4 character IFF id
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the ID is succesfully written, else FALSE
  */
-IFF_Bool IFF_writeId(FILE *file, const IFF_ID id, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_writeId(IFF_IOStream *stream, const IFF_ID id, const IFF_ID chunkId, const char *attributeName);
 
 /**
  * Converts a given ID to a string representation
@@ -27,6 +27,11 @@
 #include "cat.h"
 #include "list.h"
 #include "error.h"
+#include "context.h"
+#include "mapped.h"
+#include "filestream.h"
+#include "memorystream.h"
+#include "group.h"
 #include "defaultregistry.h"
 
 static const IFF_ChunkRegistry *selectChunkRegistry(const IFF_ChunkRegistry *chunkRegistry)
@@ -37,29 +42,60 @@ static const IFF_ChunkRegistry *selectChunkRegistry(const IFF_ChunkRegistry *chu
         return chunkRegistry;
 }
 
-IFF_Chunk *IFF_readFd(FILE *file, const IFF_ChunkRegistry *chunkRegistry)
+static IFF_Chunk *checkMainChunk(IFF_IOStream *stream, IFF_Chunk *chunk)
 {
-    IFF_Chunk *chunk;
-    int byte;
-
-    /* Read the chunk */
-    chunk = IFF_readChunk(file, 0, selectChunkRegistry(chunkRegistry));
+    IFF_UByte byte;
 
     if(chunk == NULL)
     {
+        IFF_recordError(IFF_ERROR_INVALID); /* Only recorded if a more specific error has not been recorded yet */
         IFF_error("ERROR: cannot open main chunk!\n");
         return NULL;
     }
 
     /* We should have reached the EOF now */
 
-    if((byte = fgetc(file)) != EOF)
+    if(stream->read(stream, &byte, sizeof(IFF_UByte)) == sizeof(IFF_UByte))
         IFF_error("WARNING: Trailing IFF contents found: %d!\n", byte);
 
     /* Return the parsed main chunk */
     return chunk;
 }
 
+static IFF_Bool checkMainChunkId(const IFF_ID chunkId)
+{
+    /* The main chunk must be of ID: FORM, CAT or LIST */
+
+    if(chunkId != IFF_ID_FORM &&
+       chunkId != IFF_ID_CAT &&
+       chunkId != IFF_ID_LIST)
+    {
+        IFF_recordError(IFF_ERROR_INVALID);
+        IFF_error("Not a valid IFF-85 file: First bytes should start with either: 'FORM', 'CAT ' or 'LIST'\n");
+        return FALSE;
+    }
+    else
+        return TRUE;
+}
+
+IFF_Chunk *IFF_readStream(IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry)
+{
+    return checkMainChunk(stream, IFF_readChunk(stream, 0, selectChunkRegistry(chunkRegistry)));
+}
+
+IFF_Chunk *IFF_readLazyStream(IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry)
+{
+    return checkMainChunk(stream, IFF_readLazyChunk(stream, 0, selectChunkRegistry(chunkRegistry)));
+}
+
+IFF_Chunk *IFF_readFd(FILE *file, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_FileIOStream stream;
+
+    IFF_initFileIOStream(&stream, file);
+    return IFF_readStream((IFF_IOStream*)&stream, chunkRegistry);
+}
+
 IFF_Chunk *IFF_readFile(const char *filename, const IFF_ChunkRegistry *chunkRegistry)
 {
     IFF_Chunk *chunk;
@@ -68,6 +104,7 @@ IFF_Chunk *IFF_readFile(const char *filename, const IFF_ChunkRegistry *chunkRegi
     /* Open the IFF file */
     if(file == NULL)
     {
+        IFF_recordError(IFF_ERROR_READ);
         IFF_error("ERROR: cannot open file: %s\n", filename);
         return NULL;
     }
@@ -82,6 +119,84 @@ IFF_Chunk *IFF_readFile(const char *filename, const IFF_ChunkRegistry *chunkRegi
     return chunk;
 }
 
+static IFF_Chunk *readMappedData(const IFF_UByte *data, const size_t size, const IFF_ChunkRegistry *chunkRegistry, const IFF_Bool borrowRawChunkData, IFF_Executor executor, void *executorData)
+{
+    IFF_Cursor cursor;
+    IFF_Chunk *chunk;
+
+    IFF_initCursor(&cursor, data, size);
+
+    /* Parse the main chunk */
+    if(executor == NULL)
+        chunk = IFF_readMappedChunk(&cursor, 0, selectChunkRegistry(chunkRegistry), borrowRawChunkData);
+    else
+        chunk = IFF_readParallelChunk(&cursor, 0, selectChunkRegistry(chunkRegistry), borrowRawChunkData, executor, executorData);
+
+    if(chunk == NULL)
+    {
+        IFF_recordError(IFF_ERROR_INVALID); /* Only recorded if a more specific error has not been recorded yet */
+        IFF_error("ERROR: cannot open main chunk!\n");
+    }
+    else if(IFF_getCursorBytesLeft(&cursor) > 0) /* We should have reached the end of the file now */
+        IFF_error("WARNING: Trailing IFF contents found: %d!\n", data[cursor.position]);
+
+    /* Return the chunk */
+    return chunk;
+}
+
+IFF_Chunk *IFF_readMappedFile(const IFF_MappedFile *mappedFile, const IFF_ChunkRegistry *chunkRegistry)
+{
+    return readMappedData(mappedFile->data, mappedFile->size, chunkRegistry, TRUE, NULL, NULL);
+}
+
+IFF_Chunk *IFF_readMapped(const char *filename, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_MappedFile mappedFile;
+    IFF_Chunk *chunk;
+
+    /* Map the IFF file into memory */
+    if(!IFF_openMappedFile(&mappedFile, filename))
+        return NULL;
+
+    /* Parse the main chunk. Raw chunk data is copied, because the mapping does not outlive this function */
+    chunk = readMappedData(mappedFile.data, mappedFile.size, chunkRegistry, FALSE, NULL, NULL);
+
+    /* Release the mapping */
+    IFF_closeMappedFile(&mappedFile);
+
+    /* Return the chunk */
+    return chunk;
+}
+
+IFF_Chunk *IFF_readBuffer(const IFF_UByte *data, const size_t size, const IFF_ChunkRegistry *chunkRegistry)
+{
+    return readMappedData(data, size, chunkRegistry, FALSE, NULL, NULL);
+}
+
+IFF_Chunk *IFF_readParallelBuffer(const IFF_UByte *data, const size_t size, const IFF_ChunkRegistry *chunkRegistry, IFF_Executor executor, void *executorData)
+{
+    return readMappedData(data, size, chunkRegistry, FALSE, executor, executorData);
+}
+
+IFF_Chunk *IFF_readParallel(const char *filename, const IFF_ChunkRegistry *chunkRegistry, const unsigned int numOfThreads)
+{
+    IFF_MappedFile mappedFile;
+    IFF_Chunk *chunk;
+    unsigned int executorData = numOfThreads;
+
+    /* Map the IFF file into memory, so that every thread can read its own part */
+    if(!IFF_openMappedFile(&mappedFile, filename))
+        return NULL;
+
+    chunk = readMappedData(mappedFile.data, mappedFile.size, chunkRegistry, FALSE, IFF_executeInThreads, &executorData);
+
+    /* Release the mapping */
+    IFF_closeMappedFile(&mappedFile);
+
+    /* Return the chunk */
+    return chunk;
+}
+
 IFF_Chunk *IFF_read(const char *filename, const IFF_ChunkRegistry *chunkRegistry)
 {
     if(filename == NULL)
@@ -90,9 +205,112 @@ IFF_Chunk *IFF_read(const char *filename, const IFF_ChunkRegistry *chunkRegistry
         return IFF_readFile(filename, chunkRegistry);
 }
 
+IFF_Chunk *IFF_readInArena(const char *filename, const IFF_ChunkRegistry *chunkRegistry, IFF_Arena *arena)
+{
+    IFF_Arena *previousArena = IFF_selectArena(arena);
+    IFF_Chunk *chunk = IFF_read(filename, chunkRegistry);
+    IFF_selectArena(previousArena);
+    return chunk;
+}
+
+IFF_Chunk *IFF_readBufferInArena(const IFF_UByte *data, const size_t size, const IFF_ChunkRegistry *chunkRegistry, IFF_Arena *arena)
+{
+    IFF_Arena *previousArena = IFF_selectArena(arena);
+    IFF_Chunk *chunk = IFF_readBuffer(data, size, chunkRegistry);
+    IFF_selectArena(previousArena);
+    return chunk;
+}
+
+static IFF_Chunk *readValidatedMainChunk(IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+
+    /* The ID of the main chunk is checked before its body is read */
+    if(!IFF_readChunkHeader(stream, &chunkId, &chunkSize) || !checkMainChunkId(chunkId))
+        return NULL;
+
+    return IFF_readChunkBody(stream, chunkId, chunkSize, 0, chunkRegistry);
+}
+
+IFF_Chunk *IFF_readValidatedStream(IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_Bool previousValidate = IFF_selectValidateOnRead(TRUE);
+    IFF_Chunk *chunk = readValidatedMainChunk(stream, selectChunkRegistry(chunkRegistry));
+    IFF_selectValidateOnRead(previousValidate);
+    return checkMainChunk(stream, chunk);
+}
+
+IFF_Chunk *IFF_readValidated(const char *filename, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_FileIOStream stream;
+    IFF_Chunk *chunk;
+    FILE *file;
+
+    if(filename == NULL)
+        file = stdin;
+    else if((file = fopen(filename, "rb")) == NULL)
+    {
+        IFF_recordError(IFF_ERROR_READ);
+        IFF_error("ERROR: cannot open file: %s\n", filename);
+        return NULL;
+    }
+
+    IFF_initFileIOStream(&stream, file);
+    chunk = IFF_readValidatedStream((IFF_IOStream*)&stream, chunkRegistry);
+
+    if(filename != NULL)
+        fclose(file);
+
+    return chunk;
+}
+
+IFF_Bool IFF_visitStream(IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry, const IFF_Visitor *visitor, void *data)
+{
+    if(IFF_visitChunk(stream, 0, selectChunkRegistry(chunkRegistry), visitor, data) == IFF_FIELD_FAILURE)
+    {
+        IFF_error("ERROR: cannot visit main chunk!\n");
+        return FALSE;
+    }
+    else
+        return TRUE;
+}
+
+IFF_Bool IFF_visit(const char *filename, const IFF_ChunkRegistry *chunkRegistry, const IFF_Visitor *visitor, void *data)
+{
+    IFF_FileIOStream stream;
+    IFF_Bool status;
+    FILE *file;
+
+    if(filename == NULL)
+        file = stdin;
+    else if((file = fopen(filename, "rb")) == NULL)
+    {
+        IFF_recordError(IFF_ERROR_READ);
+        IFF_error("ERROR: cannot open file: %s\n", filename);
+        return FALSE;
+    }
+
+    IFF_initFileIOStream(&stream, file);
+    status = IFF_visitStream((IFF_IOStream*)&stream, chunkRegistry, visitor, data);
+
+    if(filename != NULL)
+        fclose(file);
+
+    return status;
+}
+
+IFF_Bool IFF_writeStream(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
+{
+    return IFF_writeChunk(stream, chunk, 0, selectChunkRegistry(chunkRegistry));
+}
+
 IFF_Bool IFF_writeFd(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
 {
-    return IFF_writeChunk(file, chunk, 0, selectChunkRegistry(chunkRegistry));
+    IFF_FileIOStream stream;
+
+    IFF_initFileIOStream(&stream, file);
+    return IFF_writeStream((IFF_IOStream*)&stream, chunk, chunkRegistry);
 }
 
 IFF_Bool IFF_writeFile(const char *filename, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
@@ -102,6 +320,7 @@ IFF_Bool IFF_writeFile(const char *filename, const IFF_Chunk *chunk, const IFF_C
 
     if(file == NULL)
     {
+        IFF_recordError(IFF_ERROR_WRITE);
         IFF_error("ERROR: cannot open file: %s\n", filename);
         return FALSE;
     }
@@ -111,6 +330,32 @@ IFF_Bool IFF_writeFile(const char *filename, const IFF_Chunk *chunk, const IFF_C
     return status;
 }
 
+IFF_Bool IFF_writeBuffer(const IFF_Chunk *chunk, IFF_UByte **data, size_t *size, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_MemoryIOStream stream;
+    IFF_Long totalSize = IFF_incrementChunkSize(0, chunk);
+
+    /* Pre-size the buffer from the chunk size, so that no reallocations are needed when the chunk sizes are up to date */
+    if(!IFF_initGrowableMemoryIOStream(&stream, totalSize > 0 ? totalSize : 0))
+    {
+        IFF_recordError(IFF_ERROR_MEMORY);
+        IFF_error("ERROR: cannot allocate output buffer!\n");
+        return FALSE;
+    }
+
+    if(IFF_writeStream((IFF_IOStream*)&stream, chunk, chunkRegistry))
+    {
+        *data = stream.data;
+        *size = stream.position;
+        return TRUE;
+    }
+    else
+    {
+        free(stream.data);
+        return FALSE;
+    }
+}
+
 IFF_Bool IFF_write(const char *filename, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
 {
     if(filename == NULL)
@@ -126,17 +371,16 @@ void IFF_free(IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
 
 IFF_Bool IFF_check(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
 {
-    /* The main chunk must be of ID: FORM, CAT or LIST */
+    return checkMainChunkId(chunk->chunkId)
+        && IFF_checkChunk(chunk, 0, selectChunkRegistry(chunkRegistry));
+}
 
-    if(chunk->chunkId != IFF_ID_FORM &&
-       chunk->chunkId != IFF_ID_CAT &&
-       chunk->chunkId != IFF_ID_LIST)
-    {
-        IFF_error("Not a valid IFF-85 file: First bytes should start with either: 'FORM', 'CAT ' or 'LIST'\n");
-        return FALSE;
-    }
-    else
-        return IFF_checkChunk(chunk, 0, selectChunkRegistry(chunkRegistry));
+IFF_Bool IFF_checkParallel(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, const unsigned int numOfThreads)
+{
+    unsigned int executorData = numOfThreads;
+
+    return checkMainChunkId(chunk->chunkId)
+        && IFF_checkParallelChunk(chunk, 0, selectChunkRegistry(chunkRegistry), IFF_executeInThreads, &executorData);
 }
 
 void IFF_print(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF_ChunkRegistry *chunkRegistry)
@@ -144,6 +388,11 @@ void IFF_print(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF
     IFF_printChunk(chunk, indentLevel, 0, selectChunkRegistry(chunkRegistry));
 }
 
+IFF_Hash IFF_hash(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
+{
+    return IFF_hashChunk(chunk, 0, selectChunkRegistry(chunkRegistry));
+}
+
 IFF_Bool IFF_compare(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_ChunkRegistry *chunkRegistry)
 {
     return IFF_compareChunk(chunk1, chunk2, 0, selectChunkRegistry(chunkRegistry));
@@ -24,11 +24,38 @@
 
 #include "ifftypes.h"
 #include "chunk.h"
+#include "stream.h"
+#include "mapped.h"
+#include "arena.h"
+#include "context.h"
+#include "visitor.h"
+#include "parallel.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Reads an IFF file from a given stream. The resulting chunk must be freed using IFF_free().
+ *
+ * @param stream An I/O stream, such as an IFF_FileIOStream, IFF_FdIOStream or IFF_MemoryIOStream
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return A chunk hierarchy derived from the IFF stream, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readStream(IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Reads an IFF file from a given seekable stream, but defers reading the bodies
+ * of the chunks that are not groups until they are accessed, for example by
+ * IFF_getChunkFromForm(). The stream must remain valid until the chunks that are
+ * needed have been accessed, or until the resulting chunk has been freed with IFF_free().
+ *
+ * @param stream A seekable I/O stream, such as an IFF_FileIOStream or an IFF_MemoryIOStream referring to a mapped file
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return A chunk hierarchy derived from the IFF stream, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readLazyStream(IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry);
+
 /**
  * Reads an IFF file from a given file descriptor. The resulting chunk must be freed using IFF_free().
  *
@@ -47,6 +74,69 @@ IFF_Chunk *IFF_readFd(FILE *file, const IFF_ChunkRegistry *chunkRegistry);
  */
 IFF_Chunk *IFF_readFile(const char *filename, const IFF_ChunkRegistry *chunkRegistry);
 
+/**
+ * Reads an IFF file from a file with the given filename by mapping it into memory.
+ * The chunk hierarchy is parsed directly from the mapped memory, so that no
+ * read operations are required for the individual fields after the file has
+ * been mapped. The resulting chunk must be freed using IFF_free().
+ *
+ * @param filename Filename of the file
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return A chunk hierarchy derived from the IFF file, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readMapped(const char *filename, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Reads an IFF file from a file that has been mapped into memory with
+ * IFF_openMappedFile(). In contrast to IFF_readMapped(), the data of raw chunks
+ * is not copied, but refers to the mapped memory. As a consequence, the mapped
+ * file must remain open until the resulting chunk has been freed using IFF_free(),
+ * and the data of its raw chunks must not be modified.
+ *
+ * @param mappedFile A file that has been mapped into memory
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return A chunk hierarchy derived from the IFF file, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readMappedFile(const IFF_MappedFile *mappedFile, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Reads an IFF file from a block of memory. The chunk hierarchy is parsed
+ * directly from memory and the data of raw chunks is copied, so that the memory
+ * block can be discarded afterwards. The resulting chunk must be freed using IFF_free().
+ *
+ * @param data Pointer to the first byte of the memory block
+ * @param size Size of the memory block in bytes
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return A chunk hierarchy derived from the IFF data, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readBuffer(const IFF_UByte *data, const size_t size, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Reads an IFF file from a block of memory, like IFF_readBuffer(). If the main
+ * chunk is a CAT or LIST, its members are parsed independently by the given executor.
+ * The resulting chunk must be freed using IFF_free().
+ *
+ * @param data Pointer to the first byte of the memory block
+ * @param size Size of the memory block in bytes
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param executor Executor that parses the members of the main chunk, such as IFF_executeInThreads()
+ * @param executorData Arbitrary data that configures the executor
+ * @return A chunk hierarchy derived from the IFF data, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readParallelBuffer(const IFF_UByte *data, const size_t size, const IFF_ChunkRegistry *chunkRegistry, IFF_Executor executor, void *executorData);
+
+/**
+ * Reads an IFF file with the given filename by mapping it into memory. If the
+ * main chunk is a CAT or LIST, its members are parsed by a number of threads.
+ * The resulting chunk must be freed using IFF_free().
+ *
+ * @param filename Filename of the file
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param numOfThreads Number of threads that parse the members, or 0 to use the number of online processors
+ * @return A chunk hierarchy derived from the IFF file, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readParallel(const char *filename, const IFF_ChunkRegistry *chunkRegistry, const unsigned int numOfThreads);
+
 /**
  * Reads an IFF file from a file with the given filename or from the standard input when no filename was provided.
  * The resulting chunk must be freed using IFF_free().
@@ -57,6 +147,96 @@ IFF_Chunk *IFF_readFile(const char *filename, const IFF_ChunkRegistry *chunkRegi
  */
 IFF_Chunk *IFF_read(const char *filename, const IFF_ChunkRegistry *chunkRegistry);
 
+/**
+ * Reads an IFF file from a given stream and checks whether it conforms to the
+ * IFF specification while it is parsed, so that a separate IFF_check() is not
+ * needed. The chunk IDs, group types, sub chunk types and chunk sizes are
+ * checked as soon as they have been read, and reading stops at the first
+ * violation without building the rest of the chunk hierarchy. The resulting
+ * chunk must be freed using IFF_free().
+ *
+ * @param stream An I/O stream, such as an IFF_FileIOStream, IFF_FdIOStream or IFF_MemoryIOStream
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return A valid chunk hierarchy derived from the IFF stream, or NULL if an error occurs or the stream does not conform to the IFF specification
+ */
+IFF_Chunk *IFF_readValidatedStream(IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Reads an IFF file like IFF_readValidatedStream() from a file with the given
+ * filename or from the standard input when no filename was provided.
+ * The resulting chunk must be freed using IFF_free().
+ *
+ * @param filename Filename of the file or NULL to read from the standard input
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return A valid chunk hierarchy derived from the IFF file, or NULL if an error occurs or the file does not conform to the IFF specification
+ */
+IFF_Chunk *IFF_readValidated(const char *filename, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Reads an IFF file, like IFF_read(), but allocates the nodes, sub chunk arrays
+ * and chunk bodies of the resulting chunk hierarchy from the given arena. The
+ * resulting chunk must not be freed with IFF_free(). Instead, it is released
+ * along with all other allocations in the arena by IFF_resetArena() or IFF_freeArena().
+ *
+ * The arena is selected with IFF_selectArena() while the file is read. Without
+ * thread local storage, this function is therefore not reentrant: it must not
+ * be called by multiple threads simultaneously.
+ *
+ * @param filename Filename of the file or NULL to read from the standard input
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param arena An arena from which the chunk hierarchy is allocated
+ * @return A chunk hierarchy derived from the IFF file, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readInArena(const char *filename, const IFF_ChunkRegistry *chunkRegistry, IFF_Arena *arena);
+
+/**
+ * Reads an IFF file from a block of memory, like IFF_readBuffer(), but allocates
+ * the resulting chunk hierarchy from the given arena. The resulting chunk must
+ * not be freed with IFF_free(), but is released by IFF_resetArena() or IFF_freeArena().
+ * Like IFF_readInArena(), it is not reentrant without thread local storage.
+ *
+ * @param data Pointer to the first byte of the memory block
+ * @param size Size of the memory block in bytes
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param arena An arena from which the chunk hierarchy is allocated
+ * @return A chunk hierarchy derived from the IFF data, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readBufferInArena(const IFF_UByte *data, const size_t size, const IFF_ChunkRegistry *chunkRegistry, IFF_Arena *arena);
+
+/**
+ * Traverses the IFF contents of a given stream without building a chunk
+ * hierarchy, by invoking the callbacks of the given visitor for each chunk.
+ *
+ * @param stream An I/O stream, such as an IFF_FileIOStream, IFF_FdIOStream or IFF_MemoryIOStream
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param visitor A visitor containing the callbacks that should be invoked
+ * @param data Arbitrary data that is passed to the callbacks of the visitor
+ * @return TRUE if the contents have been traversed completely or the visitor stopped the traversal, or FALSE if an error occurs
+ */
+IFF_Bool IFF_visitStream(IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry, const IFF_Visitor *visitor, void *data);
+
+/**
+ * Traverses an IFF file from a file with the given filename or from the standard
+ * input when no filename was provided, like IFF_visitStream().
+ *
+ * @param filename Filename of the file or NULL to read from the standard input
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param visitor A visitor containing the callbacks that should be invoked
+ * @param data Arbitrary data that is passed to the callbacks of the visitor
+ * @return TRUE if the contents have been traversed completely or the visitor stopped the traversal, or FALSE if an error occurs
+ */
+IFF_Bool IFF_visit(const char *filename, const IFF_ChunkRegistry *chunkRegistry, const IFF_Visitor *visitor, void *data);
+
+/**
+ * Writes an IFF file to a given stream.
+ *
+ * @param stream An I/O stream, such as an IFF_FileIOStream, IFF_FdIOStream or IFF_MemoryIOStream
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return TRUE if the IFF file has been successfully written, else FALSE
+ */
+IFF_Bool IFF_writeStream(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry);
+
 /**
  * Writes an IFF file to a given file descriptor.
  *
@@ -77,6 +257,20 @@ IFF_Bool IFF_writeFd(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry
  */
 IFF_Bool IFF_writeFile(const char *filename, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry);
 
+/**
+ * Writes an IFF file to a newly allocated block of memory. The size of the
+ * memory block is derived from the chunk size of the given chunk, so that it is
+ * allocated only once if the chunk sizes are up to date. The resulting memory
+ * block must be freed with free().
+ *
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param data Pointer to the memory block containing the IFF data, if the chunk has been successfully written
+ * @param size Size of the resulting memory block in bytes
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return TRUE if the IFF file has been successfully written, else FALSE
+ */
+IFF_Bool IFF_writeBuffer(const IFF_Chunk *chunk, IFF_UByte **data, size_t *size, const IFF_ChunkRegistry *chunkRegistry);
+
 /**
  * Writes an IFF file to a file with the given filename or to the standard output if no filename was provided.
  *
@@ -104,6 +298,19 @@ void IFF_free(IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry);
  */
 IFF_Bool IFF_check(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry);
 
+/**
+ * Checks whether an IFF file conforms to the IFF specification, like IFF_check(),
+ * but checks the members of CATs and LISTs by a number of threads. The messages
+ * of the members are reported in document order, so that the verdict and the
+ * output are the same as those of IFF_check().
+ *
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param numOfThreads Number of threads that check the members, or 0 to use the number of online processors
+ * @return TRUE if the IFF file conforms to the IFF specification, else FALSE
+ */
+IFF_Bool IFF_checkParallel(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, const unsigned int numOfThreads);
+
 /**
  * Displays a textual representation of an IFF file on the standard output.
  *
@@ -114,7 +321,9 @@ IFF_Bool IFF_check(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistr
 void IFF_print(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF_ChunkRegistry *chunkRegistry);
 
 /**
- * Checks whether two given IFF files are equal.
+ * Checks whether two given IFF files are equal. If the hashes of both chunk
+ * hierarchies have been computed with IFF_hash() and differ, the contents are
+ * not compared.
  *
  * @param chunk1 Chunk hierarchy to compare
  * @param chunk2 Chunk hierarchy to compare
@@ -123,6 +332,17 @@ void IFF_print(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF
  */
 IFF_Bool IFF_compare(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_ChunkRegistry *chunkRegistry);
 
+/**
+ * Computes a 64-bit content hash of an IFF file, which can be used as a key to
+ * find duplicates. The hashes of the chunks are cached, so that hashing a
+ * hierarchy again only rehashes the chunks that have been modified since.
+ *
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return The hash of the IFF file
+ */
+IFF_Hash IFF_hash(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry);
+
 #ifdef __cplusplus
 }
 #endif
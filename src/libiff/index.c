@@ -0,0 +1,492 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "index.h"
+#include <stdlib.h>
+#include "io.h"
+#include "id.h"
+#include "form.h"
+#include "cat.h"
+#include "list.h"
+#include "prop.h"
+#include "visitor.h"
+#include "filestream.h"
+#include "defaultregistry.h"
+#include "error.h"
+#include "context.h"
+
+#define IFF_INITIAL_ENTRY_CAPACITY 16
+
+/* Every entry is serialized as: chunkId, chunkSize, groupType, formType, offset (high and low 32 bits) and parent */
+#define IFF_INDEX_ENTRY_SIZE (7 * 4)
+
+/* The source length is serialized as its high and low 32 bits */
+#define IFF_SOURCE_LENGTH_SIZE (2 * 4)
+
+#define IFF_CHUNK_HEADER_SIZE (IFF_ID_SIZE + (long)sizeof(IFF_Long))
+
+typedef struct
+{
+    IFF_Index *index;
+    IFF_IOStream *stream;
+    int current;
+    IFF_Bool failed;
+}
+IndexBuilder;
+
+static IFF_Index *createIndex(void)
+{
+    IFF_Index *index = (IFF_Index*)malloc(sizeof(IFF_Index));
+
+    if(index != NULL)
+    {
+        index->entryLength = 0;
+        index->entry = NULL;
+        index->entryCapacity = 0;
+        index->sourceLength = 0;
+    }
+
+    return index;
+}
+
+static IFF_Bool reserveIndex(IFF_Index *index, const unsigned int entryCapacity)
+{
+    if(entryCapacity > index->entryCapacity)
+    {
+        IFF_IndexEntry *entry = (IFF_IndexEntry*)realloc(index->entry, entryCapacity * sizeof(IFF_IndexEntry));
+
+        if(entry == NULL)
+        {
+            IFF_error("Cannot allocate memory for: %u index entries!\n", entryCapacity);
+            return FALSE;
+        }
+
+        index->entry = entry;
+        index->entryCapacity = entryCapacity;
+    }
+
+    return TRUE;
+}
+
+static IFF_IndexEntry *addIndexEntry(IFF_Index *index)
+{
+    /* Double the capacity when the array is full, like the sub chunk arrays of groups */
+    if(index->entryLength < index->entryCapacity || reserveIndex(index, index->entryCapacity == 0 ? IFF_INITIAL_ENTRY_CAPACITY : index->entryCapacity * 2))
+    {
+        index->entryLength++;
+        return &index->entry[index->entryLength - 1];
+    }
+    else
+        return NULL;
+}
+
+static IFF_Bool isGroupChunk(const IFF_ID chunkId)
+{
+    return chunkId == IFF_ID_FORM || chunkId == IFF_ID_CAT || chunkId == IFF_ID_LIST || chunkId == IFF_ID_PROP;
+}
+
+static IFF_VisitAction visitChunkHeader(void *data, const IFF_ID formType, const IFF_ID chunkId, const IFF_Long chunkSize)
+{
+    IndexBuilder *builder = (IndexBuilder*)data;
+    long offset = builder->stream->tell(builder->stream);
+    IFF_IndexEntry *entry;
+
+    if(offset == -1)
+    {
+        IFF_error("Cannot determine the offset of chunk: '");
+        IFF_errorId(chunkId);
+        IFF_error("', the stream must be seekable!\n");
+        builder->failed = TRUE;
+        return IFF_VISIT_STOP;
+    }
+
+    if((entry = addIndexEntry(builder->index)) == NULL)
+    {
+        builder->failed = TRUE;
+        return IFF_VISIT_STOP;
+    }
+
+    /* The chunk header has already been read */
+    entry->chunkId = chunkId;
+    entry->chunkSize = chunkSize;
+    entry->groupType = 0;
+    entry->formType = formType;
+    entry->offset = offset - IFF_CHUNK_HEADER_SIZE;
+    entry->parent = builder->current;
+
+    if(isGroupChunk(chunkId))
+    {
+        builder->current = builder->index->entryLength - 1;
+        return IFF_VISIT_DESCEND;
+    }
+    else
+        return IFF_VISIT_SKIP;
+}
+
+static IFF_VisitAction beginGroup(void *data, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ID groupType)
+{
+    IndexBuilder *builder = (IndexBuilder*)data;
+    builder->index->entry[builder->current].groupType = groupType;
+    return IFF_VISIT_DESCEND;
+}
+
+static IFF_Bool endGroup(void *data, const IFF_ID chunkId, const IFF_ID groupType)
+{
+    IndexBuilder *builder = (IndexBuilder*)data;
+    builder->current = builder->index->entry[builder->current].parent;
+    return TRUE;
+}
+
+IFF_Index *IFF_buildIndex(IFF_IOStream *stream)
+{
+    IFF_Visitor visitor = { visitChunkHeader, beginGroup, endGroup, NULL };
+    IndexBuilder builder;
+
+    builder.index = createIndex();
+    builder.stream = stream;
+    builder.current = -1;
+    builder.failed = FALSE;
+
+    if(builder.index == NULL)
+        return NULL;
+
+    if(IFF_visitChunk(stream, 0, &IFF_defaultChunkRegistry, &visitor, &builder) == IFF_FIELD_FAILURE || builder.failed)
+    {
+        IFF_freeIndex(builder.index);
+        return NULL;
+    }
+
+    /* The main chunk is the first entry. Its padding byte is included */
+    if(builder.index->entryLength > 0)
+    {
+        const IFF_IndexEntry *mainEntry = &builder.index->entry[0];
+        builder.index->sourceLength = mainEntry->offset + IFF_CHUNK_HEADER_SIZE + mainEntry->chunkSize + mainEntry->chunkSize % 2;
+    }
+
+    return builder.index;
+}
+
+IFF_Index *IFF_buildIndexFromFile(const char *filename)
+{
+    IFF_FileIOStream stream;
+    IFF_Index *index;
+    FILE *file = fopen(filename, "rb");
+
+    if(file == NULL)
+    {
+        IFF_error("ERROR: cannot open file: %s\n", filename);
+        return NULL;
+    }
+
+    IFF_initFileIOStream(&stream, file);
+    index = IFF_buildIndex((IFF_IOStream*)&stream);
+    fclose(file);
+
+    return index;
+}
+
+static long composeOffset(const IFF_ULong offsetHigh, const IFF_ULong offsetLow)
+{
+    /* Shift in two steps, so that the expression remains valid if long is only 32 bits wide */
+    return (long)((((unsigned long)offsetHigh << 16) << 16) | offsetLow);
+}
+
+static IFF_Bool readIndexEntry(IFF_IOStream *stream, IFF_IndexEntry *entry)
+{
+    IFF_ULong offsetHigh, offsetLow;
+    IFF_Long parent;
+
+    if(!IFF_readId(stream, &entry->chunkId, IFF_ID_ENTR, "chunkId")
+        || !IFF_readLong(stream, &entry->chunkSize, IFF_ID_ENTR, "chunkSize")
+        || !IFF_readId(stream, &entry->groupType, IFF_ID_ENTR, "groupType")
+        || !IFF_readId(stream, &entry->formType, IFF_ID_ENTR, "formType")
+        || !IFF_readULong(stream, &offsetHigh, IFF_ID_ENTR, "offsetHigh")
+        || !IFF_readULong(stream, &offsetLow, IFF_ID_ENTR, "offsetLow")
+        || !IFF_readLong(stream, &parent, IFF_ID_ENTR, "parent"))
+        return FALSE;
+
+    entry->offset = composeOffset(offsetHigh, offsetLow);
+    entry->parent = parent;
+
+    return TRUE;
+}
+
+static IFF_Bool readSourceLength(IFF_IOStream *stream, long *sourceLength)
+{
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+    IFF_ULong sourceLengthHigh, sourceLengthLow;
+
+    if(!IFF_readId(stream, &chunkId, IFF_ID_INDX, "chunkId")
+        || !IFF_readLong(stream, &chunkSize, IFF_ID_SLEN, "chunkSize"))
+        return FALSE;
+
+    if(chunkId != IFF_ID_SLEN || chunkSize != IFF_SOURCE_LENGTH_SIZE)
+    {
+        IFF_error("ERROR: the index does not contain a valid source length!\n");
+        return FALSE;
+    }
+
+    if(!IFF_readULong(stream, &sourceLengthHigh, IFF_ID_SLEN, "sourceLengthHigh")
+        || !IFF_readULong(stream, &sourceLengthLow, IFF_ID_SLEN, "sourceLengthLow"))
+        return FALSE;
+
+    *sourceLength = composeOffset(sourceLengthHigh, sourceLengthLow);
+    return TRUE;
+}
+
+static IFF_Bool entryFitsInSource(const IFF_IndexEntry *entry, const long sourceLength)
+{
+    /* Compare in a way that cannot overflow, since the offsets and sizes originate from an untrusted file */
+    return entry->offset >= 0
+        && entry->chunkSize >= 0
+        && entry->offset <= sourceLength - IFF_CHUNK_HEADER_SIZE
+        && entry->chunkSize <= sourceLength - IFF_CHUNK_HEADER_SIZE - entry->offset;
+}
+
+IFF_Index *IFF_readIndex(IFF_IOStream *stream)
+{
+    IFF_ID chunkId, formType, entriesId;
+    IFF_Long chunkSize, entriesSize;
+    long sourceLength;
+    IFF_Index *index;
+    unsigned int i, entryLength;
+
+    if(!IFF_readId(stream, &chunkId, IFF_ID_FORM, "chunkId")
+        || !IFF_readLong(stream, &chunkSize, IFF_ID_FORM, "chunkSize")
+        || !IFF_readId(stream, &formType, IFF_ID_FORM, "formType"))
+        return NULL;
+
+    if(chunkId != IFF_ID_FORM || formType != IFF_ID_INDX)
+    {
+        IFF_error("ERROR: the stream does not contain a valid index!\n");
+        return NULL;
+    }
+
+    if(!readSourceLength(stream, &sourceLength)
+        || !IFF_readId(stream, &entriesId, IFF_ID_INDX, "chunkId")
+        || !IFF_readLong(stream, &entriesSize, IFF_ID_ENTR, "chunkSize"))
+        return NULL;
+
+    if(entriesId != IFF_ID_ENTR || entriesSize < 0 || entriesSize % IFF_INDEX_ENTRY_SIZE != 0)
+    {
+        IFF_error("ERROR: the stream does not contain a valid index!\n");
+        return NULL;
+    }
+
+    if((index = createIndex()) == NULL)
+        return NULL;
+
+    index->sourceLength = sourceLength;
+
+    entryLength = entriesSize / IFF_INDEX_ENTRY_SIZE;
+
+    if(!reserveIndex(index, entryLength))
+    {
+        IFF_freeIndex(index);
+        return NULL;
+    }
+
+    for(i = 0; i < entryLength; i++)
+    {
+        IFF_IndexEntry *entry = &index->entry[i];
+
+        if(!readIndexEntry(stream, entry))
+        {
+            IFF_freeIndex(index);
+            return NULL;
+        }
+
+        /* A group entry must precede the entries of its sub chunks */
+        if(entry->parent < -1 || entry->parent >= (int)i)
+        {
+            IFF_error("ERROR: index entry: %u refers to an invalid parent: %d\n", i, entry->parent);
+            IFF_freeIndex(index);
+            return NULL;
+        }
+
+        if(!entryFitsInSource(entry, sourceLength))
+        {
+            IFF_error("ERROR: index entry: %u refers to a chunk beyond the source length: %ld\n", i, sourceLength);
+            IFF_freeIndex(index);
+            return NULL;
+        }
+
+        index->entryLength++;
+    }
+
+    return index;
+}
+
+IFF_Index *IFF_readIndexFile(const char *filename)
+{
+    IFF_FileIOStream stream;
+    IFF_Index *index;
+    FILE *file = fopen(filename, "rb");
+
+    if(file == NULL)
+    {
+        IFF_error("ERROR: cannot open file: %s\n", filename);
+        return NULL;
+    }
+
+    IFF_initFileIOStream(&stream, file);
+    index = IFF_readIndex((IFF_IOStream*)&stream);
+    fclose(file);
+
+    return index;
+}
+
+static IFF_Bool writeIndexEntry(IFF_IOStream *stream, const IFF_IndexEntry *entry)
+{
+    unsigned long offset = (unsigned long)entry->offset;
+
+    return IFF_writeId(stream, entry->chunkId, IFF_ID_ENTR, "chunkId")
+        && IFF_writeLong(stream, entry->chunkSize, IFF_ID_ENTR, "chunkSize")
+        && IFF_writeId(stream, entry->groupType, IFF_ID_ENTR, "groupType")
+        && IFF_writeId(stream, entry->formType, IFF_ID_ENTR, "formType")
+        && IFF_writeULong(stream, (IFF_ULong)((offset >> 16) >> 16), IFF_ID_ENTR, "offsetHigh")
+        && IFF_writeULong(stream, (IFF_ULong)(offset & 0xffffffffUL), IFF_ID_ENTR, "offsetLow")
+        && IFF_writeLong(stream, entry->parent, IFF_ID_ENTR, "parent");
+}
+
+static IFF_Bool writeSourceLength(IFF_IOStream *stream, const long sourceLength)
+{
+    unsigned long length = (unsigned long)sourceLength;
+
+    return IFF_writeId(stream, IFF_ID_SLEN, IFF_ID_SLEN, "chunkId")
+        && IFF_writeLong(stream, IFF_SOURCE_LENGTH_SIZE, IFF_ID_SLEN, "chunkSize")
+        && IFF_writeULong(stream, (IFF_ULong)((length >> 16) >> 16), IFF_ID_SLEN, "sourceLengthHigh")
+        && IFF_writeULong(stream, (IFF_ULong)(length & 0xffffffffUL), IFF_ID_SLEN, "sourceLengthLow");
+}
+
+IFF_Bool IFF_writeIndex(IFF_IOStream *stream, const IFF_Index *index)
+{
+    IFF_Long entriesSize = index->entryLength * IFF_INDEX_ENTRY_SIZE;
+    unsigned int i;
+
+    if(!IFF_writeId(stream, IFF_ID_FORM, IFF_ID_FORM, "chunkId")
+        || !IFF_writeLong(stream, IFF_ID_SIZE + IFF_CHUNK_HEADER_SIZE + IFF_SOURCE_LENGTH_SIZE + IFF_CHUNK_HEADER_SIZE + entriesSize, IFF_ID_FORM, "chunkSize")
+        || !IFF_writeId(stream, IFF_ID_INDX, IFF_ID_FORM, "formType")
+        || !writeSourceLength(stream, index->sourceLength)
+        || !IFF_writeId(stream, IFF_ID_ENTR, IFF_ID_ENTR, "chunkId")
+        || !IFF_writeLong(stream, entriesSize, IFF_ID_ENTR, "chunkSize"))
+        return FALSE;
+
+    for(i = 0; i < index->entryLength; i++)
+    {
+        if(!writeIndexEntry(stream, &index->entry[i]))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+IFF_Bool IFF_writeIndexFile(const char *filename, const IFF_Index *index)
+{
+    IFF_FileIOStream stream;
+    IFF_Bool status;
+    FILE *file = fopen(filename, "wb");
+
+    if(file == NULL)
+    {
+        IFF_error("Cannot open file: %s\n", filename);
+        return FALSE;
+    }
+
+    IFF_initFileIOStream(&stream, file);
+    status = IFF_writeIndex((IFF_IOStream*)&stream, index);
+    fclose(file);
+
+    return status;
+}
+
+void IFF_freeIndex(IFF_Index *index)
+{
+    free(index->entry);
+    free(index);
+}
+
+const IFF_IndexEntry *IFF_findIndexEntry(const IFF_Index *index, const IFF_IndexEntry *parent, const IFF_ID chunkId, const IFF_ID groupType, const unsigned int n)
+{
+    unsigned int i, first, matches = 0;
+    int parentIndex;
+
+    /* The sub chunks of a group are stored after the group entry */
+    if(parent == NULL)
+    {
+        first = 0;
+        parentIndex = -1;
+    }
+    else
+    {
+        parentIndex = parent - index->entry;
+        first = parentIndex + 1;
+    }
+
+    for(i = first; i < index->entryLength; i++)
+    {
+        const IFF_IndexEntry *entry = &index->entry[i];
+
+        /* Entries of a group are contiguous, so we can stop when we have left it */
+        if(parent != NULL && entry->parent < parentIndex)
+            break;
+
+        if((parent == NULL || entry->parent == parentIndex) && entry->chunkId == chunkId && (groupType == 0 || entry->groupType == groupType))
+        {
+            if(matches == n)
+                return entry;
+
+            matches++;
+        }
+    }
+
+    return NULL;
+}
+
+IFF_Chunk *IFF_readIndexedChunk(IFF_IOStream *stream, const IFF_IndexEntry *entry, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+
+    if(!stream->seek(stream, entry->offset, SEEK_SET))
+    {
+        IFF_error("Cannot seek to chunk: '");
+        IFF_errorId(entry->chunkId);
+        IFF_error("' at offset: %ld\n", entry->offset);
+        return NULL;
+    }
+
+    if(!IFF_readChunkHeader(stream, &chunkId, &chunkSize))
+        return NULL;
+
+    /* If the contents have changed since the index was built, the offset may refer to something else */
+    if(chunkId != entry->chunkId || chunkSize != entry->chunkSize)
+    {
+        IFF_recordError(IFF_ERROR_INVALID);
+        IFF_error("ERROR: the chunk at offset: %ld does not match its index entry: '", entry->offset);
+        IFF_errorId(entry->chunkId);
+        IFF_error("' with size: %d\n", entry->chunkSize);
+        return NULL;
+    }
+
+    return IFF_readChunkBody(stream, chunkId, chunkSize, entry->formType, chunkRegistry == NULL ? &IFF_defaultChunkRegistry : chunkRegistry);
+}
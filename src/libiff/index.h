@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_INDEX_H
+#define __IFF_INDEX_H
+
+typedef struct IFF_IndexEntry IFF_IndexEntry;
+typedef struct IFF_Index IFF_Index;
+
+#include "ifftypes.h"
+#include "id.h"
+#include "stream.h"
+#include "chunk.h"
+#include "chunkregistry.h"
+
+#define IFF_ID_INDX IFF_MAKEID('I', 'N', 'D', 'X')
+#define IFF_ID_ENTR IFF_MAKEID('E', 'N', 'T', 'R')
+#define IFF_ID_SLEN IFF_MAKEID('S', 'L', 'E', 'N')
+
+/**
+ * @brief Describes the location of a chunk in an IFF stream
+ */
+struct IFF_IndexEntry
+{
+    /** Contains the 4 character ID of the chunk */
+    IFF_ID chunkId;
+
+    /** Contains the size of the chunk data in bytes */
+    IFF_Long chunkSize;
+
+    /** Contains the form type or contents type if the chunk is a group chunk, otherwise 0 */
+    IFF_ID groupType;
+
+    /** Contains the group type of the enclosing group, which is the scope in which the chunk must be read. 0 is used for the main chunk */
+    IFF_ID formType;
+
+    /** Offset of the chunk header from the start of the stream */
+    long offset;
+
+    /** Index of the entry of the enclosing group, or -1 for the main chunk. Following these references yields the path to the chunk */
+    int parent;
+};
+
+/**
+ * @brief A table of contents of an IFF stream that makes it possible to seek to a chunk without parsing the chunks preceding it.
+ * The entries are stored in the order in which the chunks appear in the stream, so a group entry always precedes the entries of its sub chunks.
+ */
+struct IFF_Index
+{
+    /** Contains the number of entries in the index */
+    unsigned int entryLength;
+
+    /** An array of index entries */
+    IFF_IndexEntry *entry;
+
+    /** Contains the number of entries for which the array has room */
+    unsigned int entryCapacity;
+
+    /** Offset of the end of the main chunk in the stream from which the index was built. Every indexed chunk is located before it */
+    long sourceLength;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Builds an index of the main chunk in a given seekable stream. Only the chunk
+ * headers are read. The bodies of data chunks are skipped by seeking.
+ * The resulting index must be freed with IFF_freeIndex().
+ *
+ * @param stream A seekable I/O stream positioned at the start of the IFF contents
+ * @return An index of all chunks in the stream, or NULL if an error occurs
+ */
+IFF_Index *IFF_buildIndex(IFF_IOStream *stream);
+
+/**
+ * Builds an index of the IFF file with the given filename.
+ * The resulting index must be freed with IFF_freeIndex().
+ *
+ * @param filename Filename of the IFF file
+ * @return An index of all chunks in the file, or NULL if an error occurs
+ */
+IFF_Index *IFF_buildIndexFromFile(const char *filename);
+
+/**
+ * Reads a serialized index from a given stream, as written by IFF_writeIndex().
+ * An index is rejected if any of its entries refers to a chunk that does not
+ * fit within the source length that has been recorded in it.
+ * The resulting index must be freed with IFF_freeIndex().
+ *
+ * @param stream An I/O stream
+ * @return The index that has been read, or NULL if an error occurs
+ */
+IFF_Index *IFF_readIndex(IFF_IOStream *stream);
+
+/**
+ * Reads a serialized index from a sidecar file with the given filename.
+ * The resulting index must be freed with IFF_freeIndex().
+ *
+ * @param filename Filename of the index file
+ * @return The index that has been read, or NULL if an error occurs
+ */
+IFF_Index *IFF_readIndexFile(const char *filename);
+
+/**
+ * Serializes an index to a given stream. The index is stored as an IFF file
+ * consisting of a 'INDX' FORM with a 'SLEN' chunk, which contains the source
+ * length, followed by an 'ENTR' chunk, which contains the entries in big-endian
+ * byte order.
+ *
+ * @param stream An I/O stream
+ * @param index An index
+ * @return TRUE if the index has been successfully written, else FALSE
+ */
+IFF_Bool IFF_writeIndex(IFF_IOStream *stream, const IFF_Index *index);
+
+/**
+ * Serializes an index to a sidecar file with the given filename.
+ *
+ * @param filename Filename of the index file
+ * @param index An index
+ * @return TRUE if the index has been successfully written, else FALSE
+ */
+IFF_Bool IFF_writeIndexFile(const char *filename, const IFF_Index *index);
+
+/**
+ * Frees an index and all its entries.
+ *
+ * @param index An index
+ */
+void IFF_freeIndex(IFF_Index *index);
+
+/**
+ * Searches for the n-th entry of a chunk with the given chunk ID and group type.
+ *
+ * @param index An index
+ * @param parent Entry of the group in which the chunk is directly located, or NULL to search the entire index
+ * @param chunkId A 4 character chunk id
+ * @param groupType A form type or contents type that the chunk should have, or 0 to match any chunk
+ * @param n Number of matching entries that should be passed over, 0 returns the first matching entry
+ * @return The requested entry, or NULL if it can't be found
+ */
+const IFF_IndexEntry *IFF_findIndexEntry(const IFF_Index *index, const IFF_IndexEntry *parent, const IFF_ID chunkId, const IFF_ID groupType, const unsigned int n);
+
+/**
+ * Reads the chunk that an index entry refers to by seeking to its offset. The
+ * chunk header at that offset must match the chunk ID and chunk size of the
+ * entry, otherwise the index is considered stale and no chunk is read. The
+ * resulting chunk has no parent, so shared properties from enclosing lists are
+ * not available. The resulting chunk must be freed using IFF_freeChunk() with
+ * the formType of the entry, or IFF_free() if the chunk is a group chunk.
+ *
+ * @param stream A seekable I/O stream referring to the IFF contents from which the index was built
+ * @param entry An index entry
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType, or NULL to use the default registry
+ * @return The chunk hierarchy of the entry, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readIndexedChunk(IFF_IOStream *stream, const IFF_IndexEntry *entry, const IFF_ChunkRegistry *chunkRegistry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
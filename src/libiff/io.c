@@ -20,28 +20,25 @@
  */
 
 #include "io.h"
-#include <stdlib.h>
+#include <string.h>
 #include "error.h"
+#include "context.h"
+#include "byteswap.h"
 
-IFF_Bool IFF_readUByte(FILE *file, IFF_UByte *value, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_readUByte(IFF_IOStream *stream, IFF_UByte *value, const IFF_ID chunkId, const char *attributeName)
 {
-    int byte = fgetc(file);
-
-    if(byte == EOF)
+    if(stream->read(stream, value, sizeof(IFF_UByte)) == sizeof(IFF_UByte))
+        return TRUE;
+    else
     {
         IFF_readError(chunkId, attributeName);
         return FALSE;
     }
-    else
-    {
-        *value = byte;
-        return TRUE;
-    }
 }
 
-IFF_Bool IFF_writeUByte(FILE *file, const IFF_UByte value, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_writeUByte(IFF_IOStream *stream, const IFF_UByte value, const IFF_ID chunkId, const char *attributeName)
 {
-    if(fputc(value, file) == EOF)
+    if(stream->write(stream, &value, sizeof(IFF_UByte)) < sizeof(IFF_UByte))
     {
         IFF_writeError(chunkId, attributeName);
         return FALSE;
@@ -50,11 +47,11 @@ IFF_Bool IFF_writeUByte(FILE *file, const IFF_UByte value, const IFF_ID chunkId,
         return TRUE;
 }
 
-IFF_Bool IFF_readUWord(FILE *file, IFF_UWord *value, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_readUWord(IFF_IOStream *stream, IFF_UWord *value, const IFF_ID chunkId, const char *attributeName)
 {
     IFF_UWord readUWord;
 
-    if(fread(&readUWord, sizeof(IFF_UWord), 1, file) == 1)
+    if(stream->read(stream, &readUWord, sizeof(IFF_UWord)) == sizeof(IFF_UWord))
     {
 #if IFF_BIG_ENDIAN == 1
         *value = readUWord;
@@ -72,7 +69,7 @@ IFF_Bool IFF_readUWord(FILE *file, IFF_UWord *value, const IFF_ID chunkId, const
     }
 }
 
-IFF_Bool IFF_writeUWord(FILE *file, const IFF_UWord value, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_writeUWord(IFF_IOStream *stream, const IFF_UWord value, const IFF_ID chunkId, const char *attributeName)
 {
 #if IFF_BIG_ENDIAN == 1
     IFF_UWord writeUWord = value;
@@ -81,7 +78,7 @@ IFF_Bool IFF_writeUWord(FILE *file, const IFF_UWord value, const IFF_ID chunkId,
     IFF_UWord writeUWord = (value & 0xff) << 8 | (value & 0xff00) >> 8;
 #endif
 
-    if(fwrite(&writeUWord, sizeof(IFF_UWord), 1, file) == 1)
+    if(stream->write(stream, &writeUWord, sizeof(IFF_UWord)) == sizeof(IFF_UWord))
         return TRUE;
     else
     {
@@ -90,11 +87,11 @@ IFF_Bool IFF_writeUWord(FILE *file, const IFF_UWord value, const IFF_ID chunkId,
     }
 }
 
-IFF_Bool IFF_readWord(FILE *file, IFF_Word *value, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_readWord(IFF_IOStream *stream, IFF_Word *value, const IFF_ID chunkId, const char *attributeName)
 {
     IFF_Word readWord;
 
-    if(fread(&readWord, sizeof(IFF_Word), 1, file) == 1)
+    if(stream->read(stream, &readWord, sizeof(IFF_Word)) == sizeof(IFF_Word))
     {
 #if IFF_BIG_ENDIAN == 1
         *value = readWord;
@@ -111,7 +108,7 @@ IFF_Bool IFF_readWord(FILE *file, IFF_Word *value, const IFF_ID chunkId, const c
     }
 }
 
-IFF_Bool IFF_writeWord(FILE *file, const IFF_Word value, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_writeWord(IFF_IOStream *stream, const IFF_Word value, const IFF_ID chunkId, const char *attributeName)
 {
 #if IFF_BIG_ENDIAN == 1
     IFF_Word writeWord = value;
@@ -119,7 +116,7 @@ IFF_Bool IFF_writeWord(FILE *file, const IFF_Word value, const IFF_ID chunkId, c
     IFF_Word writeWord = (value & 0xff) << 8 | (value & 0xff00) >> 8;
 #endif
 
-    if(fwrite(&writeWord, sizeof(IFF_Word), 1, file) == 1)
+    if(stream->write(stream, &writeWord, sizeof(IFF_Word)) == sizeof(IFF_Word))
         return TRUE;
     else
     {
@@ -128,11 +125,11 @@ IFF_Bool IFF_writeWord(FILE *file, const IFF_Word value, const IFF_ID chunkId, c
     }
 }
 
-IFF_Bool IFF_readULong(FILE *file, IFF_ULong *value, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_readULong(IFF_IOStream *stream, IFF_ULong *value, const IFF_ID chunkId, const char *attributeName)
 {
     IFF_ULong readValue;
 
-    if(fread(&readValue, sizeof(IFF_ULong), 1, file) == 1)
+    if(stream->read(stream, &readValue, sizeof(IFF_ULong)) == sizeof(IFF_ULong))
     {
 #if IFF_BIG_ENDIAN == 1
         *value = readValue;
@@ -149,7 +146,7 @@ IFF_Bool IFF_readULong(FILE *file, IFF_ULong *value, const IFF_ID chunkId, const
     }
 }
 
-IFF_Bool IFF_writeULong(FILE *file, const IFF_ULong value, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_writeULong(IFF_IOStream *stream, const IFF_ULong value, const IFF_ID chunkId, const char *attributeName)
 {
 #if IFF_BIG_ENDIAN == 1
     IFF_ULong writeValue = value;
@@ -158,7 +155,7 @@ IFF_Bool IFF_writeULong(FILE *file, const IFF_ULong value, const IFF_ID chunkId,
     IFF_ULong writeValue = (value & 0xff) << 24 | (value & 0xff00) << 8 | (value & 0xff0000) >> 8 | (value & 0xff000000) >> 24;
 #endif
 
-    if(fwrite(&writeValue, sizeof(IFF_ULong), 1, file) == 1)
+    if(stream->write(stream, &writeValue, sizeof(IFF_ULong)) == sizeof(IFF_ULong))
         return TRUE;
     else
     {
@@ -167,11 +164,11 @@ IFF_Bool IFF_writeULong(FILE *file, const IFF_ULong value, const IFF_ID chunkId,
     }
 }
 
-IFF_Bool IFF_readLong(FILE *file, IFF_Long *value, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_readLong(IFF_IOStream *stream, IFF_Long *value, const IFF_ID chunkId, const char *attributeName)
 {
     IFF_Long readValue;
 
-    if(fread(&readValue, sizeof(IFF_Long), 1, file) == 1)
+    if(stream->read(stream, &readValue, sizeof(IFF_Long)) == sizeof(IFF_Long))
     {
 #if IFF_BIG_ENDIAN == 1
         *value = readValue;
@@ -188,7 +185,7 @@ IFF_Bool IFF_readLong(FILE *file, IFF_Long *value, const IFF_ID chunkId, const c
     }
 }
 
-IFF_Bool IFF_writeLong(FILE *file, const IFF_Long value, const IFF_ID chunkId, const char *attributeName)
+IFF_Bool IFF_writeLong(IFF_IOStream *stream, const IFF_Long value, const IFF_ID chunkId, const char *attributeName)
 {
 #if IFF_BIG_ENDIAN == 1
     IFF_Long writeValue = value;
@@ -197,7 +194,63 @@ IFF_Bool IFF_writeLong(FILE *file, const IFF_Long value, const IFF_ID chunkId, c
     IFF_Long writeValue = (value & 0xff) << 24 | (value & 0xff00) << 8 | (value & 0xff0000) >> 8 | (value & 0xff000000) >> 24;
 #endif
 
-    if(fwrite(&writeValue, sizeof(IFF_Long), 1, file) == 1)
+    if(stream->write(stream, &writeValue, sizeof(IFF_Long)) == sizeof(IFF_Long))
+        return TRUE;
+    else
+    {
+        IFF_writeError(chunkId, attributeName);
+        return FALSE;
+    }
+}
+
+static IFF_Bool readArray(IFF_IOStream *stream, void *values, const size_t size, const IFF_ID chunkId, const char *attributeName)
+{
+    if(stream->read(stream, values, size) == size)
+        return TRUE;
+    else
+    {
+        IFF_readError(chunkId, attributeName);
+        return FALSE;
+    }
+}
+
+IFF_Bool IFF_readUWordArray(IFF_IOStream *stream, IFF_UWord *values, const size_t length, const IFF_ID chunkId, const char *attributeName)
+{
+    if(readArray(stream, values, length * sizeof(IFF_UWord), chunkId, attributeName))
+    {
+        IFF_swapUWords(values, length);
+        return TRUE;
+    }
+    else
+        return FALSE;
+}
+
+IFF_Bool IFF_readWordArray(IFF_IOStream *stream, IFF_Word *values, const size_t length, const IFF_ID chunkId, const char *attributeName)
+{
+    return IFF_readUWordArray(stream, (IFF_UWord*)values, length, chunkId, attributeName);
+}
+
+IFF_Bool IFF_readULongArray(IFF_IOStream *stream, IFF_ULong *values, const size_t length, const IFF_ID chunkId, const char *attributeName)
+{
+    if(readArray(stream, values, length * sizeof(IFF_ULong), chunkId, attributeName))
+    {
+        IFF_swapULongs(values, length);
+        return TRUE;
+    }
+    else
+        return FALSE;
+}
+
+IFF_Bool IFF_readLongArray(IFF_IOStream *stream, IFF_Long *values, const size_t length, const IFF_ID chunkId, const char *attributeName)
+{
+    return IFF_readULongArray(stream, (IFF_ULong*)values, length, chunkId, attributeName);
+}
+
+#define SWAP_BUFFER_SIZE 4096
+
+static IFF_Bool writeArrayBlock(IFF_IOStream *stream, const void *block, const size_t size, const IFF_ID chunkId, const char *attributeName)
+{
+    if(stream->write(stream, block, size) == size)
         return TRUE;
     else
     {
@@ -206,13 +259,97 @@ IFF_Bool IFF_writeLong(FILE *file, const IFF_Long value, const IFF_ID chunkId, c
     }
 }
 
-IFF_Bool IFF_skipUnknownBytes(FILE *file, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Long bytesProcessed)
+IFF_Bool IFF_writeUWordArray(IFF_IOStream *stream, const IFF_UWord *values, const size_t length, const IFF_ID chunkId, const char *attributeName)
+{
+#if IFF_BIG_ENDIAN == 1
+    return writeArrayBlock(stream, values, length * sizeof(IFF_UWord), chunkId, attributeName);
+#else
+    /* The values cannot be swapped in place, so they are swapped block by block in a buffer */
+    IFF_UWord buffer[SWAP_BUFFER_SIZE / sizeof(IFF_UWord)];
+    const size_t bufferLength = SWAP_BUFFER_SIZE / sizeof(IFF_UWord);
+    size_t i;
+
+    for(i = 0; i < length; i += bufferLength)
+    {
+        size_t blockLength = length - i < bufferLength ? length - i : bufferLength;
+
+        memcpy(buffer, values + i, blockLength * sizeof(IFF_UWord));
+        IFF_swapUWords(buffer, blockLength);
+
+        if(!writeArrayBlock(stream, buffer, blockLength * sizeof(IFF_UWord), chunkId, attributeName))
+            return FALSE;
+    }
+
+    return TRUE;
+#endif
+}
+
+IFF_Bool IFF_writeWordArray(IFF_IOStream *stream, const IFF_Word *values, const size_t length, const IFF_ID chunkId, const char *attributeName)
+{
+    return IFF_writeUWordArray(stream, (const IFF_UWord*)values, length, chunkId, attributeName);
+}
+
+IFF_Bool IFF_writeULongArray(IFF_IOStream *stream, const IFF_ULong *values, const size_t length, const IFF_ID chunkId, const char *attributeName)
+{
+#if IFF_BIG_ENDIAN == 1
+    return writeArrayBlock(stream, values, length * sizeof(IFF_ULong), chunkId, attributeName);
+#else
+    IFF_ULong buffer[SWAP_BUFFER_SIZE / sizeof(IFF_ULong)];
+    const size_t bufferLength = SWAP_BUFFER_SIZE / sizeof(IFF_ULong);
+    size_t i;
+
+    for(i = 0; i < length; i += bufferLength)
+    {
+        size_t blockLength = length - i < bufferLength ? length - i : bufferLength;
+
+        memcpy(buffer, values + i, blockLength * sizeof(IFF_ULong));
+        IFF_swapULongs(buffer, blockLength);
+
+        if(!writeArrayBlock(stream, buffer, blockLength * sizeof(IFF_ULong), chunkId, attributeName))
+            return FALSE;
+    }
+
+    return TRUE;
+#endif
+}
+
+IFF_Bool IFF_writeLongArray(IFF_IOStream *stream, const IFF_Long *values, const size_t length, const IFF_ID chunkId, const char *attributeName)
+{
+    return IFF_writeULongArray(stream, (const IFF_ULong*)values, length, chunkId, attributeName);
+}
+
+#define DISCARD_BUFFER_SIZE 512
+
+static IFF_Bool discardBytes(IFF_IOStream *stream, long bytesToSkip)
+{
+    IFF_UByte buffer[DISCARD_BUFFER_SIZE];
+
+    /* Streams that are not seekable, such as pipes, require us to read the bytes that we want to skip */
+    while(bytesToSkip > 0)
+    {
+        size_t size = bytesToSkip < DISCARD_BUFFER_SIZE ? bytesToSkip : DISCARD_BUFFER_SIZE;
+
+        if(stream->read(stream, buffer, size) < size)
+            return FALSE;
+
+        bytesToSkip -= size;
+    }
+
+    return TRUE;
+}
+
+IFF_Bool IFF_skipBytes(IFF_IOStream *stream, const long bytesToSkip)
+{
+    return stream->seek(stream, bytesToSkip, SEEK_CUR) || discardBytes(stream, bytesToSkip);
+}
+
+IFF_Bool IFF_skipUnknownBytes(IFF_IOStream *stream, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Long bytesProcessed)
 {
     if(bytesProcessed < chunkSize)
     {
         long bytesToSkip = chunkSize - bytesProcessed;
 
-        if(fseek(file, bytesToSkip, SEEK_CUR) == 0)
+        if(IFF_skipBytes(stream, bytesToSkip))
         {
             IFF_error("Cannot skip: %d bytes in data chunk: '", bytesToSkip);
             IFF_errorId(chunkId);
@@ -220,43 +357,99 @@ IFF_Bool IFF_skipUnknownBytes(FILE *file, const IFF_ID chunkId, const IFF_Long c
             return TRUE;
         }
         else
+        {
+            IFF_recordError(IFF_ERROR_READ);
             return FALSE;
+        }
     }
     else
         return TRUE;
 }
 
-IFF_Bool IFF_writeZeroFillerBytes(FILE *file, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Long bytesProcessed)
+#define ZERO_PAGE_SIZE 4096
+
+/* Fillers of at least this size are written as a hole, if possible */
+#define SPARSE_FILLER_SIZE 65536
+
+static const IFF_UByte zeroPage[ZERO_PAGE_SIZE] = { 0 };
+
+static IFF_Bool writeZeroPages(IFF_IOStream *stream, long bytesToWrite)
+{
+    while(bytesToWrite > 0)
+    {
+        size_t size = bytesToWrite < ZERO_PAGE_SIZE ? bytesToWrite : ZERO_PAGE_SIZE;
+
+        if(stream->write(stream, zeroPage, size) < size)
+            return FALSE;
+
+        bytesToWrite -= size;
+    }
+
+    return TRUE;
+}
+
+static IFF_Bool isAtEndOfStream(IFF_IOStream *stream, const long position)
+{
+    return stream->seek(stream, 0, SEEK_END) && stream->tell(stream) == position;
+}
+
+static IFF_Bool writeHole(IFF_IOStream *stream, const long bytesToWrite)
+{
+    long position = stream->tell(stream);
+
+    /*
+     * Seeking beyond the end of a file leaves a hole that reads as zeros and
+     * occupies no disk blocks. Seeking over existing data would keep that
+     * data, so this only works when we are at the end of the stream. Writing
+     * the last byte extends the file to its full size.
+     */
+    if(position != -1 && isAtEndOfStream(stream, position)
+        && stream->seek(stream, bytesToWrite - 1, SEEK_CUR)
+        && stream->write(stream, zeroPage, 1) == 1)
+        return TRUE;
+    else
+    {
+        /* Return to the original position, so that the zeros can be written instead */
+        if(position != -1)
+            stream->seek(stream, position, SEEK_SET);
+
+        return FALSE;
+    }
+}
+
+IFF_Bool IFF_writeZeroFillerBytes(IFF_IOStream *stream, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Long bytesProcessed)
 {
     if(bytesProcessed < chunkSize)
     {
-        size_t bytesToSkip = chunkSize - bytesProcessed;
-        IFF_UByte *emptyData = (IFF_UByte*)calloc(bytesToSkip, sizeof(IFF_UByte));
-        IFF_Bool status = fwrite(emptyData, sizeof(IFF_UByte), bytesToSkip, file) == bytesToSkip;
+        long bytesToWrite = chunkSize - bytesProcessed;
 
-        if(!status)
+        if(stream->sparse && bytesToWrite >= SPARSE_FILLER_SIZE && writeHole(stream, bytesToWrite))
+            return TRUE;
+        else if(writeZeroPages(stream, bytesToWrite))
+            return TRUE;
+        else
         {
-            IFF_error("Cannot write: %u zero bytes in data chunk: '", bytesToSkip);
+            IFF_recordError(IFF_ERROR_WRITE);
+            IFF_error("Cannot write: %ld zero bytes in data chunk: '", bytesToWrite);
             IFF_errorId(chunkId);
             IFF_error("'\n");
+            return FALSE;
         }
-
-        free(emptyData);
-        return status;
     }
     else
         return TRUE;
 }
 
-IFF_Bool IFF_readPaddingByte(FILE *file, const IFF_Long chunkSize, const IFF_ID chunkId)
+IFF_Bool IFF_readPaddingByte(IFF_IOStream *stream, const IFF_Long chunkSize, const IFF_ID chunkId)
 {
     if(chunkSize % 2 != 0) /* Check whether the chunk size is an odd number */
     {
-        int byte = fgetc(file); /* Read padding byte */
+        IFF_UByte byte;
 
-        if(byte == EOF) /* We shouldn't have reached the EOF yet */
+        if(stream->read(stream, &byte, sizeof(IFF_UByte)) < sizeof(IFF_UByte)) /* Read padding byte. We shouldn't have reached the EOF yet */
         {
-            IFF_error("Unexpected end of file, while reading padding byte of '");
+            IFF_recordError(IFF_ERROR_READ);
+            IFF_error("Unexpected end of stream, while reading padding byte of '");
             IFF_errorId(chunkId);
             IFF_error("'\n");
             return FALSE;
@@ -268,12 +461,15 @@ IFF_Bool IFF_readPaddingByte(FILE *file, const IFF_Long chunkSize, const IFF_ID
     return TRUE;
 }
 
-IFF_Bool IFF_writePaddingByte(FILE *file, const IFF_Long chunkSize, const IFF_ID chunkId)
+IFF_Bool IFF_writePaddingByte(IFF_IOStream *stream, const IFF_Long chunkSize, const IFF_ID chunkId)
 {
     if(chunkSize % 2 != 0) /* Check whether the chunk size is an odd number */
     {
-        if(fputc('\0', file) == EOF)
+        IFF_UByte byte = '\0';
+
+        if(stream->write(stream, &byte, sizeof(IFF_UByte)) < sizeof(IFF_UByte))
         {
+            IFF_recordError(IFF_ERROR_WRITE);
             IFF_error("Cannot write padding byte of '");
             IFF_errorId(chunkId);
             IFF_error("'\n");
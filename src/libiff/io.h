@@ -24,162 +24,273 @@
 
 #include <stdio.h>
 #include "ifftypes.h"
+#include "stream.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
- * Reads an unsigned byte from a file.
+ * Reads an unsigned byte from a stream.
  *
- * @param file File descriptor of the file
- * @param value Value read from the file
+ * @param stream An I/O stream
+ * @param value Value read from the stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the value has been successfully read, else FALSE
  */
-IFF_Bool IFF_readUByte(FILE *file, IFF_UByte *value, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_readUByte(IFF_IOStream *stream, IFF_UByte *value, const IFF_ID chunkId, const char *attributeName);
 
 /**
- * Writes an unsigned byte to a file.
+ * Writes an unsigned byte to a stream.
  *
- * @param file File descriptor of the file
- * @param value Value written to the file
+ * @param stream An I/O stream
+ * @param value Value written to the stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the value has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeUByte(FILE *file, const IFF_UByte value, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_writeUByte(IFF_IOStream *stream, const IFF_UByte value, const IFF_ID chunkId, const char *attributeName);
 
 /**
- * Reads an unsigned word from a file.
+ * Reads an unsigned word from a stream.
  *
- * @param file File descriptor of the file
- * @param value Value read from the file
+ * @param stream An I/O stream
+ * @param value Value read from the stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the value has been successfully read, else FALSE
  */
-IFF_Bool IFF_readUWord(FILE *file, IFF_UWord *value, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_readUWord(IFF_IOStream *stream, IFF_UWord *value, const IFF_ID chunkId, const char *attributeName);
 
 /**
- * Writes an unsigned word to a file.
+ * Writes an unsigned word to a stream.
  *
- * @param file File descriptor of the file
- * @param value Value written to the file
+ * @param stream An I/O stream
+ * @param value Value written to the stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the value has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeUWord(FILE *file, const IFF_UWord value, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_writeUWord(IFF_IOStream *stream, const IFF_UWord value, const IFF_ID chunkId, const char *attributeName);
 
 /**
- * Reads a signed word from a file.
+ * Reads a signed word from a stream.
  *
- * @param file File descriptor of the file
- * @param value Value read from the file
+ * @param stream An I/O stream
+ * @param value Value read from the stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the value has been successfully read, else FALSE
  */
-IFF_Bool IFF_readWord(FILE *file, IFF_Word *value, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_readWord(IFF_IOStream *stream, IFF_Word *value, const IFF_ID chunkId, const char *attributeName);
 
 /**
- * Writes a signed word to a file.
+ * Writes a signed word to a stream.
  *
- * @param file File descriptor of the file
- * @param value Value written to the file
+ * @param stream An I/O stream
+ * @param value Value written to the stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the value has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeWord(FILE *file, const IFF_Word value, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_writeWord(IFF_IOStream *stream, const IFF_Word value, const IFF_ID chunkId, const char *attributeName);
 
 /**
- * Reads an unsigned long from a file.
+ * Reads an unsigned long from a stream.
  *
- * @param file File descriptor of the file
- * @param value Value read from the file
+ * @param stream An I/O stream
+ * @param value Value read from the stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the value has been successfully read, else FALSE
  */
-IFF_Bool IFF_readULong(FILE *file, IFF_ULong *value, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_readULong(IFF_IOStream *stream, IFF_ULong *value, const IFF_ID chunkId, const char *attributeName);
 
 /**
- * Writes an unsigned long to a file.
+ * Writes an unsigned long to a stream.
  *
- * @param file File descriptor of the file
- * @param value Value read from the file
+ * @param stream An I/O stream
+ * @param value Value read from the stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the value has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeULong(FILE *file, const IFF_ULong value, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_writeULong(IFF_IOStream *stream, const IFF_ULong value, const IFF_ID chunkId, const char *attributeName);
 
 /**
- * Reads a signed long from a file.
+ * Reads a signed long from a stream.
  *
- * @param file File descriptor of the file
- * @param value Value read from the file
+ * @param stream An I/O stream
+ * @param value Value read from the stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the value has been successfully read, else FALSE
  */
-IFF_Bool IFF_readLong(FILE *file, IFF_Long *value, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_readLong(IFF_IOStream *stream, IFF_Long *value, const IFF_ID chunkId, const char *attributeName);
 
 /**
- * Writes a signed long to a file.
+ * Writes a signed long to a stream.
  *
- * @param file File descriptor of the file
- * @param value Value read from the file
+ * @param stream An I/O stream
+ * @param value Value read from the stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param attributeName The name of the attribute that is examined (used for error reporting)
  * @return TRUE if the value has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeLong(FILE *file, const IFF_Long value, const IFF_ID chunkId, const char *attributeName);
+IFF_Bool IFF_writeLong(IFF_IOStream *stream, const IFF_Long value, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Reads an array of big-endian unsigned words from a stream with a single read
+ * operation and converts them to host byte order in one pass.
+ *
+ * @param stream An I/O stream
+ * @param values An array that receives the values read from the stream
+ * @param length Number of values to read
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if all values have been successfully read, else FALSE
+ */
+IFF_Bool IFF_readUWordArray(IFF_IOStream *stream, IFF_UWord *values, const size_t length, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Writes an array of unsigned words to a stream in big-endian byte order.
+ *
+ * @param stream An I/O stream
+ * @param values An array of values to write
+ * @param length Number of values to write
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if all values have been successfully written, else FALSE
+ */
+IFF_Bool IFF_writeUWordArray(IFF_IOStream *stream, const IFF_UWord *values, const size_t length, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Reads an array of big-endian signed words from a stream with a single read
+ * operation and converts them to host byte order in one pass.
+ *
+ * @param stream An I/O stream
+ * @param values An array that receives the values read from the stream
+ * @param length Number of values to read
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if all values have been successfully read, else FALSE
+ */
+IFF_Bool IFF_readWordArray(IFF_IOStream *stream, IFF_Word *values, const size_t length, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Writes an array of signed words to a stream in big-endian byte order.
+ *
+ * @param stream An I/O stream
+ * @param values An array of values to write
+ * @param length Number of values to write
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if all values have been successfully written, else FALSE
+ */
+IFF_Bool IFF_writeWordArray(IFF_IOStream *stream, const IFF_Word *values, const size_t length, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Reads an array of big-endian unsigned longs from a stream with a single read
+ * operation and converts them to host byte order in one pass.
+ *
+ * @param stream An I/O stream
+ * @param values An array that receives the values read from the stream
+ * @param length Number of values to read
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if all values have been successfully read, else FALSE
+ */
+IFF_Bool IFF_readULongArray(IFF_IOStream *stream, IFF_ULong *values, const size_t length, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Writes an array of unsigned longs to a stream in big-endian byte order.
+ *
+ * @param stream An I/O stream
+ * @param values An array of values to write
+ * @param length Number of values to write
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if all values have been successfully written, else FALSE
+ */
+IFF_Bool IFF_writeULongArray(IFF_IOStream *stream, const IFF_ULong *values, const size_t length, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Reads an array of big-endian signed longs from a stream with a single read
+ * operation and converts them to host byte order in one pass.
+ *
+ * @param stream An I/O stream
+ * @param values An array that receives the values read from the stream
+ * @param length Number of values to read
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if all values have been successfully read, else FALSE
+ */
+IFF_Bool IFF_readLongArray(IFF_IOStream *stream, IFF_Long *values, const size_t length, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Writes an array of signed longs to a stream in big-endian byte order.
+ *
+ * @param stream An I/O stream
+ * @param values An array of values to write
+ * @param length Number of values to write
+ * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
+ * @param attributeName The name of the attribute that is examined (used for error reporting)
+ * @return TRUE if all values have been successfully written, else FALSE
+ */
+IFF_Bool IFF_writeLongArray(IFF_IOStream *stream, const IFF_Long *values, const size_t length, const IFF_ID chunkId, const char *attributeName);
+
+/**
+ * Skips the given amount of bytes in a stream. If the stream is not seekable,
+ * the bytes are read and discarded.
+ *
+ * @param stream An I/O stream
+ * @param bytesToSkip Amount of bytes to skip
+ * @return TRUE if the bytes have been successfully skipped, else FALSE
+ */
+IFF_Bool IFF_skipBytes(IFF_IOStream *stream, const long bytesToSkip);
 
 /**
  * Skips the remaining data in a chunk that was not processed.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param chunkSize Size of the chunk in bytes
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the data was successfully skipped, else FALSE
  */
-IFF_Bool IFF_skipUnknownBytes(FILE *file, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Long bytesProcessed);
+IFF_Bool IFF_skipUnknownBytes(IFF_IOStream *stream, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Long bytesProcessed);
 
 /**
  * Writes 0-filler bytes for the remainder of the data in a chunk.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @param chunkSize Size of the chunk in bytes
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the data was successfully written, else FALSE
  */
-IFF_Bool IFF_writeZeroFillerBytes(FILE *file, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Long bytesProcessed);
+IFF_Bool IFF_writeZeroFillerBytes(IFF_IOStream *stream, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Long bytesProcessed);
 
 /**
  * Reads a padding byte from a chunk with an odd size.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunkSize Size of the chunk in bytes
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @return TRUE if the byte has been successfully read, else FALSE
  */
-IFF_Bool IFF_readPaddingByte(FILE *file, const IFF_Long chunkSize, const IFF_ID chunkId);
+IFF_Bool IFF_readPaddingByte(IFF_IOStream *stream, const IFF_Long chunkSize, const IFF_ID chunkId);
 
 /**
  * Writes a padding byte to a chunk with an odd size.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunkSize Size of the chunk in bytes
  * @param chunkId A 4 character chunk id in which the operation takes place (used for error reporting)
  * @return TRUE if the byte has been successfully written, else FALSE
  */
-IFF_Bool IFF_writePaddingByte(FILE *file, const IFF_Long chunkSize, const IFF_ID chunkId);
+IFF_Bool IFF_writePaddingByte(IFF_IOStream *stream, const IFF_Long chunkSize, const IFF_ID chunkId);
 
 #ifdef __cplusplus
 }
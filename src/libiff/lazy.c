@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "lazy.h"
+#include "io.h"
+#include "id.h"
+#include "form.h"
+#include "cat.h"
+#include "list.h"
+#include "prop.h"
+#include "field.h"
+#include "arena.h"
+#include "error.h"
+#include "context.h"
+
+#define ID_EMPTY IFF_MAKEID(' ', ' ', ' ', ' ')
+
+static IFF_Bool createLazyChunks(IFF_Group *group, IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_LazyChunks *lazyChunks = (IFF_LazyChunks*)IFF_allocateIn(group->arena, sizeof(IFF_LazyChunks));
+
+    if(lazyChunks == NULL)
+        return FALSE;
+
+    lazyChunks->stream = stream;
+    lazyChunks->chunkRegistry = chunkRegistry;
+    lazyChunks->chunkOffset = NULL;
+    group->lazyChunks = lazyChunks;
+
+    /* Sub chunks that have already been attached are all loaded */
+    if(IFF_reserveLazyChunks(group, 0, group->chunkCapacity))
+        return TRUE;
+    else
+    {
+        IFF_freeLazyChunks(group);
+        return FALSE;
+    }
+}
+
+IFF_Bool IFF_reserveLazyChunks(IFF_Group *group, const unsigned int previousCapacity, const unsigned int chunkCapacity)
+{
+    IFF_LazyChunks *lazyChunks = group->lazyChunks;
+
+    if(chunkCapacity > previousCapacity)
+    {
+        long *chunkOffset = (long*)IFF_reallocateIn(group->arena, lazyChunks->chunkOffset, previousCapacity * sizeof(long), chunkCapacity * sizeof(long));
+        unsigned int i;
+
+        if(chunkOffset == NULL)
+        {
+            IFF_recordError(IFF_ERROR_MEMORY);
+            IFF_error("Cannot allocate memory for the offsets of: %u sub chunks!\n", chunkCapacity);
+            return FALSE;
+        }
+
+        for(i = previousCapacity; i < chunkCapacity; i++)
+            chunkOffset[i] = -1;
+
+        lazyChunks->chunkOffset = chunkOffset;
+    }
+
+    return TRUE;
+}
+
+static IFF_Bool isGroupChunkType(const IFF_ChunkType *chunkType)
+{
+    return chunkType->readExtensionChunkFields == &IFF_readForm || chunkType->readExtensionChunkFields == &IFF_readProp
+        || chunkType->readExtensionChunkFields == &IFF_readCAT || chunkType->readExtensionChunkFields == &IFF_readList;
+}
+
+static IFF_Chunk *deferChunk(IFF_IOStream *stream, const IFF_ID chunkId, const IFF_Long chunkSize, long *chunkOffset)
+{
+    /* Remember where the body starts, so that we can come back to it when it is accessed */
+    if((*chunkOffset = stream->tell(stream)) == -1)
+    {
+        IFF_recordError(IFF_ERROR_READ);
+        IFF_error("Cannot determine the offset of chunk: '");
+        IFF_errorId(chunkId);
+        IFF_error("', the stream must be seekable!\n");
+        return NULL;
+    }
+
+    if(!IFF_skipBytes(stream, chunkSize + (chunkSize % 2)))
+    {
+        IFF_recordError(IFF_ERROR_READ);
+        IFF_error("Cannot skip the body of chunk: '");
+        IFF_errorId(chunkId);
+        IFF_error("'\n");
+        return NULL;
+    }
+
+    /* The placeholder only consists of the common chunk properties */
+    return IFF_createChunk(chunkId, chunkSize, sizeof(IFF_Chunk));
+}
+
+static IFF_Chunk *readLazyGroupChunk(IFF_IOStream *stream, IFF_ChunkType *chunkType, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry);
+
+static IFF_Bool attachSubChunk(IFF_IOStream *stream, IFF_Group *group, IFF_Chunk *subChunk, const long chunkOffset, const IFF_ChunkRegistry *chunkRegistry)
+{
+    /* PROP chunks inside a LIST are stored separately */
+    if(group->chunkId == IFF_ID_LIST && subChunk->chunkId == IFF_ID_PROP)
+        return IFF_attachPropToList((IFF_List*)group, (IFF_Prop*)subChunk);
+    else if(chunkOffset == -1)
+        return IFF_attachToGroup(group, subChunk);
+    else
+    {
+        if(group->lazyChunks == NULL && !createLazyChunks(group, stream, chunkRegistry))
+            return FALSE;
+
+        if(!IFF_attachToGroup(group, subChunk))
+            return FALSE;
+
+        group->lazyChunks->chunkOffset[group->chunkLength - 1] = chunkOffset;
+    }
+
+    return TRUE;
+}
+
+static IFF_Bool readLazyGroupSubChunks(IFF_IOStream *stream, IFF_Group *group, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+{
+    while(*bytesProcessed < group->chunkSize)
+    {
+        IFF_ID chunkId;
+        IFF_Long chunkSize;
+        IFF_ChunkType *chunkType;
+        IFF_Chunk *subChunk;
+        long chunkOffset = -1;
+
+        if(!IFF_readId(stream, &chunkId, ID_EMPTY, "")
+            || !IFF_readLong(stream, &chunkSize, chunkId, "chunkSize"))
+            return FALSE;
+
+        chunkType = IFF_findChunkType(chunkRegistry, group->groupType, chunkId);
+
+        /* Group chunks are read immediately, so that their structure is known. The bodies of all other chunks are deferred */
+        if(isGroupChunkType(chunkType))
+            subChunk = readLazyGroupChunk(stream, chunkType, chunkId, chunkSize, group->groupType, chunkRegistry);
+        else
+            subChunk = deferChunk(stream, chunkId, chunkSize, &chunkOffset);
+
+        if(subChunk == NULL)
+            return FALSE;
+
+        if(!attachSubChunk(stream, group, subChunk, chunkOffset, chunkRegistry))
+        {
+            if(chunkOffset == -1)
+                IFF_freeChunk(subChunk, group->groupType, chunkRegistry);
+            else
+                IFF_deallocateIn(subChunk->arena, subChunk);
+
+            return FALSE;
+        }
+
+        /* Increase the bytes processed counter */
+        *bytesProcessed = IFF_incrementChunkSize(*bytesProcessed, subChunk);
+    }
+
+    if(*bytesProcessed > group->chunkSize)
+        IFF_error("WARNING: truncated group chunk! The size specifies: %d but the total amount of its sub chunks is: %d bytes. The parser may get confused!\n", group->chunkSize, *bytesProcessed);
+
+    return TRUE;
+}
+
+static IFF_Chunk *readLazyGroupChunk(IFF_IOStream *stream, IFF_ChunkType *chunkType, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_Chunk *chunk = chunkType->createExtensionChunk(chunkId, chunkSize);
+
+    if(chunk != NULL)
+    {
+        IFF_Group *group = (IFF_Group*)chunk;
+        const char *groupTypeName = (chunkId == IFF_ID_FORM || chunkId == IFF_ID_PROP) ? "formType" : "contentsType";
+        IFF_Long bytesProcessed = 0;
+        IFF_FieldStatus status;
+
+        chunk->chunkType = chunkType;
+
+        if((status = IFF_readIdField(stream, &group->groupType, chunk, groupTypeName, &bytesProcessed)) == IFF_FIELD_FAILURE
+            || (status == IFF_FIELD_MORE && !readLazyGroupSubChunks(stream, group, chunkRegistry, &bytesProcessed))
+            || !IFF_skipUnknownBytes(stream, chunkId, chunkSize, bytesProcessed)
+            || !IFF_readPaddingByte(stream, chunkSize, chunkId))
+        {
+            IFF_freeChunk(chunk, formType, chunkRegistry);
+            return NULL;
+        }
+    }
+
+    return chunk;
+}
+
+IFF_Chunk *IFF_readLazyChunk(IFF_IOStream *stream, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+    IFF_ChunkType *chunkType;
+
+    if(!IFF_readId(stream, &chunkId, ID_EMPTY, "")
+        || !IFF_readLong(stream, &chunkSize, chunkId, "chunkSize"))
+        return NULL;
+
+    chunkType = IFF_findChunkType(chunkRegistry, formType, chunkId);
+
+    /* A chunk that is not a group has no sub chunks that can be deferred */
+    if(isGroupChunkType(chunkType))
+        return readLazyGroupChunk(stream, chunkType, chunkId, chunkSize, formType, chunkRegistry);
+    else
+        return IFF_readChunkBody(stream, chunkId, chunkSize, formType, chunkRegistry);
+}
+
+IFF_Bool IFF_isLazyGroupSubChunk(const IFF_Group *group, const unsigned int index)
+{
+    return group->lazyChunks != NULL && group->lazyChunks->chunkOffset[index] != -1;
+}
+
+IFF_Chunk *IFF_loadGroupSubChunk(IFF_Group *group, const unsigned int index)
+{
+    if(IFF_isLazyGroupSubChunk(group, index))
+    {
+        IFF_LazyChunks *lazyChunks = group->lazyChunks;
+        IFF_Chunk *placeholder = group->chunk[index];
+        IFF_Arena *previousArena;
+        IFF_Chunk *chunk;
+
+        if(!lazyChunks->stream->seek(lazyChunks->stream, lazyChunks->chunkOffset[index], SEEK_SET))
+        {
+            IFF_recordError(IFF_ERROR_READ);
+            IFF_error("Cannot seek to the body of chunk: '");
+            IFF_errorId(placeholder->chunkId);
+            IFF_error("'\n");
+            return NULL;
+        }
+
+        /* Allocate the chunk from the same arena as the group in which it is located */
+        previousArena = IFF_selectArena(group->arena);
+        chunk = IFF_readChunkBody(lazyChunks->stream, placeholder->chunkId, placeholder->chunkSize, group->groupType, lazyChunks->chunkRegistry);
+        IFF_selectArena(previousArena);
+
+        if(chunk == NULL)
+            return NULL;
+
+        /* Replace the placeholder by the chunk that has been read */
+        chunk->parent = group;
+        group->chunk[index] = chunk;
+        lazyChunks->chunkOffset[index] = -1;
+        IFF_deallocateIn(placeholder->arena, placeholder);
+
+        return chunk;
+    }
+    else
+        return group->chunk[index];
+}
+
+IFF_Bool IFF_loadGroupSubChunks(IFF_Group *group)
+{
+    unsigned int i;
+
+    for(i = 0; i < group->chunkLength; i++)
+    {
+        if(IFF_loadGroupSubChunk(group, i) == NULL)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+void IFF_freeLazyChunks(IFF_Group *group)
+{
+    if(group->lazyChunks != NULL)
+    {
+        IFF_deallocateIn(group->arena, group->lazyChunks->chunkOffset);
+        IFF_deallocateIn(group->arena, group->lazyChunks);
+        group->lazyChunks = NULL;
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_LAZY_H
+#define __IFF_LAZY_H
+
+typedef struct IFF_LazyChunks IFF_LazyChunks;
+
+#include "ifftypes.h"
+#include "stream.h"
+#include "chunk.h"
+#include "chunkregistry.h"
+#include "group.h"
+
+/**
+ * @brief Keeps track of the sub chunks of a group chunk whose bodies have not been read yet.
+ * Until they are loaded, these sub chunks are represented by placeholders that only contain the chunk id and chunk size.
+ */
+struct IFF_LazyChunks
+{
+    /** Stream from which the sub chunk bodies are read. It must remain valid as long as there are sub chunks that need to be loaded */
+    IFF_IOStream *stream;
+
+    /** A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType */
+    const IFF_ChunkRegistry *chunkRegistry;
+
+    /** For each sub chunk, the stream offset of its body or -1 if the sub chunk has been loaded. It has room for as many elements as the chunk array of the group. */
+    long *chunkOffset;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Reads a chunk hierarchy from a given seekable stream, in which the bodies of
+ * all chunks except groups are not read until they are accessed. Their stream
+ * offsets are recorded instead, and their bodies are skipped by seeking.
+ * Placeholder sub chunks are loaded by IFF_loadGroupSubChunk(), which is used by
+ * the chunk retrieval functions, such as IFF_getChunkFromForm(), and by the
+ * write, check, print and compare functions.
+ * The resulting chunk must be freed using IFF_free()
+ *
+ * @param stream A seekable I/O stream that must remain valid as long as sub chunks need to be loaded
+ * @param formType Form type id describing in which FORM the sub chunk is located. 0 is used for sub chunks in other group chunks.
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @return A chunk hierarchy derived from the IFF stream, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readLazyChunk(IFF_IOStream *stream, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Enlarges the offset administration of a group chunk that has lazily read sub chunks,
+ * so that it has room for the given amount of sub chunks.
+ *
+ * @param group A group chunk instance
+ * @param previousCapacity The amount of sub chunks for which the offset administration currently has room
+ * @param chunkCapacity The amount of sub chunks for which the offset administration should have room
+ * @return TRUE if the offset administration has been enlarged, else FALSE
+ */
+IFF_Bool IFF_reserveLazyChunks(IFF_Group *group, const unsigned int previousCapacity, const unsigned int chunkCapacity);
+
+/**
+ * Checks whether a sub chunk of a group is a placeholder whose body has not been read yet.
+ *
+ * @param group A group chunk instance
+ * @param index Index of the sub chunk
+ * @return TRUE if the sub chunk has not been loaded yet, else FALSE
+ */
+IFF_Bool IFF_isLazyGroupSubChunk(const IFF_Group *group, const unsigned int index);
+
+/**
+ * Retrieves a sub chunk of a group. If the sub chunk is a placeholder, its body
+ * is read from the stream and the placeholder is replaced by the resulting chunk.
+ *
+ * @param group A group chunk instance
+ * @param index Index of the sub chunk
+ * @return The sub chunk or NULL if it cannot be loaded
+ */
+IFF_Chunk *IFF_loadGroupSubChunk(IFF_Group *group, const unsigned int index);
+
+/**
+ * Loads all sub chunks of a group that have not been read yet. Sub chunks of nested groups are not loaded.
+ *
+ * @param group A group chunk instance
+ * @return TRUE if all sub chunks have been loaded, else FALSE
+ */
+IFF_Bool IFF_loadGroupSubChunks(IFF_Group *group);
+
+/**
+ * Frees the offset administration of a group chunk. The placeholders of the sub
+ * chunks that have not been loaded must be freed separately with IFF_deallocate().
+ *
+ * @param group A group chunk instance
+ */
+void IFF_freeLazyChunks(IFF_Group *group);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
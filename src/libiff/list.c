@@ -26,6 +26,38 @@
 #include "util.h"
 #include "cat.h"
 #include "error.h"
+#include "context.h"
+#include "arena.h"
+
+#define IFF_INITIAL_PROP_CAPACITY 2
+
+/**
+ * @brief A slot in the lookup table of shared property chunks. A slot is free if its PROP chunk is NULL.
+ */
+typedef struct
+{
+    /** Form type of the PROP chunk */
+    IFF_ID formType;
+
+    /** A 4 character chunk id */
+    IFF_ID chunkId;
+
+    /** The PROP chunk in which the chunk is located */
+    IFF_Prop *prop;
+
+    /** Index of the chunk in the PROP chunk. The index is stored rather than the chunk itself, because lazily read chunks are replaced when they are loaded */
+    unsigned int index;
+}
+IFF_PropertySlot;
+
+struct IFF_PropertyCache
+{
+    /** Number of slots minus one. The amount of slots is always a power of two. */
+    unsigned int slotMask;
+
+    /** An open-addressing hash table mapping (formType, chunkId) pairs to the chunks in the PROP chunks */
+    IFF_PropertySlot *slot;
+};
 
 IFF_List *IFF_createList(const IFF_Long chunkSize, const IFF_ID contentsType)
 {
@@ -37,6 +69,8 @@ IFF_List *IFF_createList(const IFF_Long chunkSize, const IFF_ID contentsType)
 
         list->prop = NULL;
         list->propLength = 0;
+        list->propCapacity = 0;
+        list->propertyCache = NULL;
     }
 
     return list;
@@ -57,45 +91,92 @@ IFF_Chunk *IFF_createUnparsedList(const IFF_ID chunkId, const IFF_Long chunkSize
     return (IFF_Chunk*)IFF_createList(chunkSize, 0);
 }
 
-static void addPropToList(IFF_List *list, IFF_Prop *prop)
+static IFF_Bool enlargeListProps(IFF_List *list)
 {
-    list->prop = (IFF_Prop**)realloc(list->prop, (list->propLength + 1) * sizeof(IFF_Prop*));
-    list->prop[list->propLength] = prop;
-    list->propLength++;
-    prop->parent = (IFF_Group*)list;
+    /* Double the capacity, so that attaching N PROP chunks takes a logarithmic amount of reallocations */
+    unsigned int propCapacity = list->propCapacity == 0 ? IFF_INITIAL_PROP_CAPACITY : list->propCapacity * 2;
+    IFF_Prop **prop = (IFF_Prop**)IFF_reallocateIn(list->arena, list->prop, list->propCapacity * sizeof(IFF_Prop*), propCapacity * sizeof(IFF_Prop*));
+
+    if(prop == NULL)
+    {
+        IFF_recordError(IFF_ERROR_MEMORY);
+        IFF_error("Cannot allocate memory for: %u PROP chunks!\n", propCapacity);
+        return FALSE;
+    }
+
+    list->prop = prop;
+    list->propCapacity = propCapacity;
+    return TRUE;
 }
 
-void IFF_addPropToList(IFF_List *list, IFF_Prop *prop)
+IFF_Bool IFF_attachPropToList(IFF_List *list, IFF_Prop *prop)
 {
-    addPropToList(list, prop);
-    list->chunkSize = IFF_incrementChunkSize(list->chunkSize, (IFF_Chunk*)prop);
+    if(list->propLength < list->propCapacity || enlargeListProps(list))
+    {
+        list->prop[list->propLength] = prop;
+        list->propLength++;
+        prop->parent = (IFF_Group*)list;
+        IFF_invalidateListPropertyCache(list);
+        IFF_invalidateChunkHash((IFF_Chunk*)list);
+        return TRUE;
+    }
+    else
+        return FALSE;
 }
 
-void IFF_addToList(IFF_List *list, IFF_Chunk *chunk)
+IFF_Bool IFF_addPropToList(IFF_List *list, IFF_Prop *prop)
 {
-    IFF_addToCAT((IFF_CAT*)list, chunk);
+    if(IFF_attachPropToList(list, prop))
+    {
+        IFF_propagateChunkSizeDelta((IFF_Group*)list, IFF_incrementChunkSize(0, (IFF_Chunk*)prop));
+        return TRUE;
+    }
+    else
+        return FALSE;
 }
 
-void IFF_addToListAndUpdateContentsType(IFF_List *list, IFF_Chunk *chunk)
+IFF_Bool IFF_addToList(IFF_List *list, IFF_Chunk *chunk)
 {
-    IFF_addToCATAndUpdateContentsType((IFF_CAT*)list, chunk);
+    return IFF_addToCAT((IFF_CAT*)list, chunk);
 }
 
-static IFF_Bool readListSubChunks(FILE *file, IFF_List *list, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool IFF_addToListAndUpdateContentsType(IFF_List *list, IFF_Chunk *chunk)
 {
+    return IFF_addToCATAndUpdateContentsType((IFF_CAT*)list, chunk);
+}
+
+static IFF_Bool readListSubChunks(IFF_IOStream *stream, IFF_List *list, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+{
+    IFF_Bool validate = IFF_getValidateOnRead();
+
     while(*bytesProcessed < list->chunkSize)
     {
         /* Read sub chunk */
-        IFF_Chunk *chunk = IFF_readChunk(file, list->contentsType, chunkRegistry);
+        IFF_Chunk *chunk = IFF_readSubChunk(stream, list->contentsType, chunkRegistry, list->chunkSize - *bytesProcessed);
 
         if(chunk == NULL)
             return FALSE;
 
-        /* Add the PROP chunk or arbitrary sub chunk */
+        /* Add the PROP chunk or arbitrary sub chunk. A PROP has already checked its own contents while it was read */
         if(chunk->chunkId == IFF_ID_PROP)
-            addPropToList(list, (IFF_Prop*)chunk);
+        {
+            if(!IFF_attachPropToList(list, (IFF_Prop*)chunk))
+            {
+                IFF_freeChunk(chunk, list->contentsType, chunkRegistry);
+                return FALSE;
+            }
+        }
         else
-            IFF_attachToGroup((IFF_Group*)list, chunk);
+        {
+            if(!IFF_attachToGroup((IFF_Group*)list, chunk))
+            {
+                IFF_freeChunk(chunk, list->contentsType, chunkRegistry);
+                return FALSE;
+            }
+
+            if(validate && !IFF_checkReadSubChunk((IFF_Group*)list, chunk, &IFF_checkCATSubChunk, chunkRegistry))
+                return FALSE;
+        }
 
         /* Increase the bytes processed counter */
         *bytesProcessed = IFF_incrementChunkSize(*bytesProcessed, chunk);
@@ -107,17 +188,33 @@ static IFF_Bool readListSubChunks(FILE *file, IFF_List *list, const IFF_ChunkReg
     return TRUE;
 }
 
-IFF_Bool IFF_readList(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool IFF_readList(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
     IFF_List *list = (IFF_List*)chunk;
     IFF_FieldStatus status;
 
     /* Read the contentsType id */
-    if((status = IFF_readIdField(file, &list->contentsType, chunk, "contentsType", bytesProcessed)) != IFF_FIELD_MORE)
+    if((status = IFF_readIdField(stream, &list->contentsType, chunk, "contentsType", bytesProcessed)) != IFF_FIELD_MORE)
+    {
+        /* When validating, a list that is too small to contain a contents type is rejected */
+        if(status == IFF_FIELD_LAST && IFF_getValidateOnRead() && !IFF_checkGroupChunkSize((IFF_Group*)list, IFF_ID_SIZE))
+        {
+            IFF_recordError(IFF_ERROR_INVALID);
+            return FALSE;
+        }
+
         return IFF_deriveSuccess(status);
+    }
+
+    /* When validating, the contents type is checked before any sub chunk is read */
+    if(IFF_getValidateOnRead() && !IFF_checkId(list->contentsType))
+    {
+        IFF_recordError(IFF_ERROR_INVALID);
+        return FALSE;
+    }
 
     /* Read the remaining nested sub chunks */
-    if(!readListSubChunks(file, list, chunkRegistry, bytesProcessed))
+    if(!readListSubChunks(stream, list, chunkRegistry, bytesProcessed))
     {
         IFF_error("Error reading chunk in list!\n");
         return FALSE;
@@ -127,13 +224,13 @@ IFF_Bool IFF_readList(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chu
     return TRUE;
 }
 
-static IFF_Bool writeListPropChunks(FILE *file, const IFF_List *list, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+static IFF_Bool writeListPropChunks(IFF_IOStream *stream, const IFF_List *list, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
     unsigned int i;
 
     for(i = 0; i < list->propLength; i++)
     {
-        if(!IFF_writeChunk(file, (IFF_Chunk*)list->prop[i], 0, chunkRegistry))
+        if(!IFF_writeChunk(stream, (IFF_Chunk*)list->prop[i], 0, chunkRegistry))
         {
             IFF_error("Error writing PROP!\n");
             return FALSE;
@@ -146,18 +243,18 @@ static IFF_Bool writeListPropChunks(FILE *file, const IFF_List *list, const IFF_
     return TRUE;
 }
 
-IFF_Bool IFF_writeList(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool IFF_writeList(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
     const IFF_List *list = (const IFF_List*)chunk;
     IFF_FieldStatus status;
 
-    if((status = IFF_writeIdField(file, list->contentsType, chunk, "contentsType", bytesProcessed)) != IFF_FIELD_MORE)
+    if((status = IFF_writeIdField(stream, list->contentsType, chunk, "contentsType", bytesProcessed)) != IFF_FIELD_MORE)
         return IFF_deriveSuccess(status);
 
-    if(!writeListPropChunks(file, list, chunkRegistry, bytesProcessed))
+    if(!writeListPropChunks(stream, list, chunkRegistry, bytesProcessed))
         return FALSE;
 
-    if(!IFF_writeGroupSubChunks(file, (const IFF_Group*)chunk, chunkRegistry, bytesProcessed))
+    if(!IFF_writeGroupSubChunks(stream, (const IFF_Group*)chunk, chunkRegistry, bytesProcessed))
         return FALSE;
 
     return TRUE;
@@ -224,7 +321,8 @@ void IFF_freeList(IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
 
     IFF_freeCAT(chunk, chunkRegistry);
     freeListPropChunks(list, chunkRegistry);
-    free(list->prop);
+    IFF_deallocateIn(list->arena, list->prop);
+    IFF_invalidateListPropertyCache(list);
 }
 
 static void printListPropChunks(const IFF_List *list, const unsigned int indentLevel, const IFF_ChunkRegistry *chunkRegistry)
@@ -290,6 +388,9 @@ void IFF_updateListChunkSizes(IFF_List *list)
 
     for(i = 0; i < list->propLength; i++)
         list->chunkSize = IFF_incrementChunkSize(list->chunkSize, (IFF_Chunk*)list->prop[i]);
+
+    if(list->propLength > 0)
+        IFF_invalidateChunkHash((IFF_Chunk*)list);
 }
 
 IFF_Prop *IFF_getPropFromList(const IFF_List *list, const IFF_ID formType)
@@ -304,3 +405,103 @@ IFF_Prop *IFF_getPropFromList(const IFF_List *list, const IFF_ID formType)
 
     return NULL;
 }
+
+static unsigned int hashProperty(const IFF_ID formType, const IFF_ID chunkId)
+{
+    unsigned int hash = (formType * 0x9e3779b1U) ^ chunkId;
+    hash = (hash ^ (hash >> 16)) * 0x85ebca6bU;
+    return hash ^ (hash >> 13);
+}
+
+static IFF_PropertySlot *getPropertySlot(const IFF_PropertyCache *propertyCache, const IFF_ID formType, const IFF_ID chunkId)
+{
+    unsigned int i = hashProperty(formType, chunkId) & propertyCache->slotMask;
+
+    /* The table is never full, so the probe sequence always ends in a matching or a free slot */
+    while(propertyCache->slot[i].prop != NULL
+        && (propertyCache->slot[i].formType != formType || propertyCache->slot[i].chunkId != chunkId))
+        i = (i + 1) & propertyCache->slotMask;
+
+    return &propertyCache->slot[i];
+}
+
+static IFF_PropertyCache *buildPropertyCache(const IFF_List *list)
+{
+    IFF_PropertyCache *propertyCache;
+    unsigned int i, j, slotsLength = 2, chunksLength = 0;
+
+    for(i = 0; i < list->propLength; i++)
+        chunksLength += list->prop[i]->chunkLength;
+
+    /* Keep the load factor at most 50%, so that probe sequences stay short */
+    while(slotsLength < chunksLength * 2)
+        slotsLength *= 2;
+
+    if((propertyCache = (IFF_PropertyCache*)IFF_allocateIn(list->arena, sizeof(IFF_PropertyCache) + slotsLength * sizeof(IFF_PropertySlot))) == NULL)
+        return NULL;
+
+    propertyCache->slotMask = slotsLength - 1;
+    propertyCache->slot = (IFF_PropertySlot*)(propertyCache + 1);
+
+    for(i = 0; i < slotsLength; i++)
+        propertyCache->slot[i].prop = NULL;
+
+    for(i = 0; i < list->propLength; i++)
+    {
+        IFF_Prop *prop = list->prop[i];
+
+        /* Only the first PROP chunk with a given form type is consulted, as IFF_getPropFromList() does */
+        if(IFF_getPropFromList(list, prop->formType) == prop)
+        {
+            for(j = 0; j < prop->chunkLength; j++)
+            {
+                IFF_PropertySlot *slot = getPropertySlot(propertyCache, prop->formType, prop->chunk[j]->chunkId);
+
+                /* The first chunk with a given chunk id takes precedence */
+                if(slot->prop == NULL)
+                {
+                    slot->formType = prop->formType;
+                    slot->chunkId = prop->chunk[j]->chunkId;
+                    slot->prop = prop;
+                    slot->index = j;
+                }
+            }
+        }
+    }
+
+    return propertyCache;
+}
+
+IFF_Bool IFF_cacheListProperties(IFF_List *list)
+{
+    return list->propertyCache != NULL || (list->propertyCache = buildPropertyCache(list)) != NULL;
+}
+
+IFF_Chunk *IFF_getPropertyFromList(IFF_List *list, const IFF_ID formType, const IFF_ID chunkId)
+{
+    if(!IFF_cacheListProperties(list))
+    {
+        /* Without a lookup table, search the PROP chunks directly */
+        IFF_Prop *prop = IFF_getPropFromList(list, formType);
+
+        if(prop == NULL)
+            return NULL;
+        else
+            return IFF_getChunkFromProp(prop, chunkId);
+    }
+    else
+    {
+        IFF_PropertySlot *slot = getPropertySlot(list->propertyCache, formType, chunkId);
+
+        if(slot->prop == NULL)
+            return NULL;
+        else
+            return IFF_loadGroupSubChunk((IFF_Group*)slot->prop, slot->index); /* Reads the chunk body first if it was deferred */
+    }
+}
+
+void IFF_invalidateListPropertyCache(IFF_List *list)
+{
+    IFF_deallocateIn(list->arena, list->propertyCache);
+    list->propertyCache = NULL;
+}
@@ -25,10 +25,16 @@
 #define IFF_ID_LIST IFF_MAKEID('L', 'I', 'S', 'T')
 
 typedef struct IFF_List IFF_List;
+typedef struct IFF_PropertyCache IFF_PropertyCache;
 
 #include <stdio.h>
 #include "ifftypes.h"
+#include "stream.h"
+#include "hash.h"
+#include "arena.h"
 #include "chunk.h"
+#include "lazy.h"
+#include "chunkindex.h"
 #include "prop.h"
 
 /**
@@ -45,6 +51,15 @@ struct IFF_List
     /** Contains the size of the chunk data in bytes */
     IFF_Long chunkSize;
 
+    /** Refers to the chunk type that was resolved when the chunk was read, so that it does not have to be looked up again. NULL if it should be looked up in the registry */
+    IFF_ChunkType *chunkType;
+
+    /** Caches the content hash that has been computed by IFF_hashChunk(). Both halves are 0 if it has not been computed, or if it has been invalidated by a modification */
+    IFF_Hash hash;
+
+    /** Refers to the arena from which the chunk has been allocated, or NULL if it has been allocated from the heap. The memory that belongs to the chunk is allocated from the same arena */
+    IFF_Arena *arena;
+
     /**
      * Contains a type ID which hints about the contents of this list.
      * 'JJJJ' is used if this concatenation stores forms of multiple form types.
@@ -59,11 +74,26 @@ struct IFF_List
     /** An array of chunk pointers referring to the sub chunks */
     IFF_Chunk **chunk;
 
+    /** Contains the number of sub chunks for which the array of chunk pointers has room */
+    unsigned int chunkCapacity;
+
+    /** Keeps track of the sub chunks whose bodies are read on first access, or NULL if all sub chunks have been read */
+    IFF_LazyChunks *lazyChunks;
+
+    /** An index of the sub chunks by chunk id, which is built when the group becomes large enough, or NULL if the sub chunks are scanned */
+    IFF_ChunkIndex *chunkIndex;
+
     /** Contains the number of PROP chunks stored in this list chunk */
     unsigned int propLength;
 
     /** An array of chunk pointers referring to the PROP chunks */
     IFF_Prop **prop;
+
+    /** Contains the number of PROP chunks for which the array of chunk pointers has room */
+    unsigned int propCapacity;
+
+    /** A lookup table of the shared property chunks in the PROP chunks of this list, which is built on first use, or NULL if it has not been built yet */
+    IFF_PropertyCache *propertyCache;
 };
 
 #ifdef __cplusplus
@@ -110,14 +140,24 @@ IFF_List *IFF_createEmptyList(void);
  */
 IFF_Chunk *IFF_createUnparsedList(const IFF_ID chunkId, const IFF_Long chunkSize);
 
+/**
+ * Attaches a PROP chunk to the body of the given list.
+ *
+ * @param list An instance of a list struct
+ * @param prop A PROP chunk
+ * @return TRUE if the PROP chunk has been attached, or FALSE if the memory for it cannot be allocated. In that case, the PROP chunk remains owned by the caller
+ */
+IFF_Bool IFF_attachPropToList(IFF_List *list, IFF_Prop *prop);
+
 /**
  * Adds a PROP chunk to the body of the given list. This function also increments the
  * chunk size and PROP length counter.
  *
  * @param list An instance of a list struct
  * @param prop A PROP chunk
+ * @return TRUE if the PROP chunk has been added, or FALSE if the memory for it cannot be allocated. In that case, the PROP chunk remains owned by the caller
  */
-void IFF_addPropToList(IFF_List *list, IFF_Prop *prop);
+IFF_Bool IFF_addPropToList(IFF_List *list, IFF_Prop *prop);
 
 /**
  * Adds a chunk to the body of the given list. This function also increments the
@@ -125,8 +165,9 @@ void IFF_addPropToList(IFF_List *list, IFF_Prop *prop);
  *
  * @param list An instance of a list struct
  * @param chunk A FORM, CAT or LIST chunk
+ * @return TRUE if the chunk has been added, or FALSE if the memory for it cannot be allocated. In that case, the chunk remains owned by the caller
  */
-void IFF_addToList(IFF_List *list, IFF_Chunk *chunk);
+IFF_Bool IFF_addToList(IFF_List *list, IFF_Chunk *chunk);
 
 /**
  * Adds a chunk to the body of the given list.
@@ -136,30 +177,31 @@ void IFF_addToList(IFF_List *list, IFF_Chunk *chunk);
  *
  * @param list An instance of a list struct
  * @param chunk A FORM, CAT or LIST chunk
+ * @return TRUE if the chunk has been added, or FALSE if the memory for it cannot be allocated. In that case, the chunk remains owned by the caller
  */
-void IFF_addToListAndUpdateContentsType(IFF_List *list, IFF_Chunk *chunk);
+IFF_Bool IFF_addToListAndUpdateContentsType(IFF_List *list, IFF_Chunk *chunk);
 
 /**
- * Reads a list chunk and its sub chunks from a file.
+ * Reads a list chunk and its sub chunks from a stream.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk An instance of a list chunk
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the list has been successfully read, or FALSE if an error has occured
  */
-IFF_Bool IFF_readList(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_readList(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
- * Writes a list chunk and its sub chunks to a file.
+ * Writes a list chunk and its sub chunks to a stream.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk An instance of a list chunk
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the list has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeList(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_writeList(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
  * Checks whether the list chunk and its sub chunks conform to the IFF specification.
@@ -224,6 +266,49 @@ void IFF_updateListChunkSizes(IFF_List *list);
  */
 IFF_Prop *IFF_getPropFromList(const IFF_List *list, const IFF_ID formType);
 
+/**
+ * Retrieves a shared property chunk with the given chunk id from the PROP chunk
+ * with the given form type in a list. PROP chunks of enclosing lists are not
+ * searched.
+ *
+ * On first use, a lookup table of all the chunks in the PROP chunks of the list
+ * is built, so that subsequent lookups take constant time. The table is
+ * discarded when a PROP chunk is attached to the list, or when a chunk is
+ * added to, removed from or replaced in one of its PROP chunks through the
+ * group functions. Code that modifies the PROP chunks of a list directly must
+ * call IFF_invalidateListPropertyCache() afterwards.
+ *
+ * A lookup may build the table and, if the list has been read lazily, read the
+ * body of the requested chunk. Lookups in the same list can only be done by
+ * multiple threads simultaneously if the list has been read eagerly and its
+ * table has been built in advance with IFF_cacheListProperties().
+ *
+ * @param list An instance of a list chunk
+ * @param formType Form type of the PROP chunk
+ * @param chunkId A 4 character chunk id
+ * @return The requested chunk, or NULL if the PROP chunk or the chunk does not exist
+ */
+IFF_Chunk *IFF_getPropertyFromList(IFF_List *list, const IFF_ID formType, const IFF_ID chunkId);
+
+/**
+ * Builds the lookup table of shared property chunks of the given list from the
+ * arena of the list, if it has not been built yet.
+ *
+ * @param list An instance of a list chunk
+ * @return TRUE if the table is available, or FALSE if the memory for it cannot be allocated. In that case, lookups search the PROP chunks directly
+ */
+IFF_Bool IFF_cacheListProperties(IFF_List *list);
+
+/**
+ * Discards the lookup table of shared property chunks of the given list, so
+ * that it is rebuilt by the next call to IFF_getPropertyFromList(). The memory
+ * of a table that has been allocated from an arena is only reclaimed when the
+ * arena is reset or freed.
+ *
+ * @param list An instance of a list chunk
+ */
+void IFF_invalidateListPropertyCache(IFF_List *list);
+
 #ifdef __cplusplus
 }
 #endif
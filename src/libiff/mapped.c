@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mapped.h"
+#include <stdio.h>
+#include <stdlib.h>
+#if HAVE_SYS_MMAN_H == 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "id.h"
+#include "group.h"
+#include "form.h"
+#include "cat.h"
+#include "list.h"
+#include "prop.h"
+#include "rawchunk.h"
+#include "memorystream.h"
+#include "field.h"
+#include "error.h"
+#include "context.h"
+
+#define ID_EMPTY IFF_MAKEID(' ', ' ', ' ', ' ')
+
+#if HAVE_SYS_MMAN_H == 1
+static IFF_Bool mapFile(IFF_MappedFile *mappedFile, const char *filename)
+{
+    struct stat st;
+    int fd = open(filename, O_RDONLY);
+
+    if(fd == -1)
+        return FALSE;
+
+    if(fstat(fd, &st) == -1)
+    {
+        close(fd);
+        return FALSE;
+    }
+
+    mappedFile->size = st.st_size;
+    mappedFile->mapped = TRUE;
+
+    if(mappedFile->size == 0)
+        mappedFile->data = NULL; /* An empty file cannot be mapped, but there is also nothing to read */
+    else
+    {
+        void *data = mmap(NULL, mappedFile->size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(data == MAP_FAILED)
+        {
+            close(fd);
+            return FALSE;
+        }
+
+        mappedFile->data = (const IFF_UByte*)data;
+    }
+
+    /* The mapping remains valid after the file descriptor has been closed */
+    close(fd);
+    return TRUE;
+}
+#else
+static IFF_Bool mapFile(IFF_MappedFile *mappedFile, const char *filename)
+{
+    FILE *file = fopen(filename, "rb");
+    IFF_UByte *data;
+    long size;
+
+    if(file == NULL)
+        return FALSE;
+
+    if(fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) == -1 || fseek(file, 0, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return FALSE;
+    }
+
+    data = (IFF_UByte*)malloc(size == 0 ? 1 : size);
+
+    if(data == NULL || fread(data, sizeof(IFF_UByte), size, file) < (size_t)size)
+    {
+        free(data);
+        fclose(file);
+        return FALSE;
+    }
+
+    fclose(file);
+
+    mappedFile->data = data;
+    mappedFile->size = size;
+    mappedFile->mapped = FALSE;
+    return TRUE;
+}
+#endif
+
+IFF_Bool IFF_openMappedFile(IFF_MappedFile *mappedFile, const char *filename)
+{
+    if(mapFile(mappedFile, filename))
+        return TRUE;
+    else
+    {
+        IFF_recordError(IFF_ERROR_READ);
+        IFF_error("ERROR: cannot map file: %s\n", filename);
+        return FALSE;
+    }
+}
+
+void IFF_closeMappedFile(IFF_MappedFile *mappedFile)
+{
+#if HAVE_SYS_MMAN_H == 1
+    if(mappedFile->data != NULL)
+        munmap((void*)mappedFile->data, mappedFile->size);
+#else
+    free((void*)mappedFile->data);
+#endif
+}
+
+static IFF_FieldStatus readIdField(IFF_Cursor *cursor, IFF_ID *value, const IFF_Chunk *chunk, const char *attributeName, IFF_Long *bytesProcessed)
+{
+    if(*bytesProcessed > chunk->chunkSize - IFF_ID_SIZE)
+        return IFF_FIELD_LAST;
+    else if(IFF_readCursorId(cursor, value, chunk->chunkId, attributeName))
+    {
+        *bytesProcessed = *bytesProcessed + IFF_ID_SIZE;
+        return IFF_FIELD_MORE;
+    }
+    else
+        return IFF_FIELD_FAILURE;
+}
+
+static IFF_Bool readGroup(IFF_Cursor *cursor, IFF_Chunk *chunk, const char *groupTypeName, const IFF_ChunkRegistry *chunkRegistry, const IFF_Bool borrowRawChunkData, IFF_Long *bytesProcessed)
+{
+    IFF_Group *group = (IFF_Group*)chunk;
+    IFF_FieldStatus status;
+
+    /* Read group type */
+    if((status = readIdField(cursor, &group->groupType, chunk, groupTypeName, bytesProcessed)) != IFF_FIELD_MORE)
+        return IFF_deriveSuccess(status);
+
+    /* Keep parsing sub chunks until we have read all bytes */
+    while(*bytesProcessed < group->chunkSize)
+    {
+        IFF_Chunk *subChunk = IFF_readMappedChunk(cursor, group->groupType, chunkRegistry, borrowRawChunkData);
+        IFF_Bool attached;
+
+        if(subChunk == NULL)
+            return FALSE;
+
+        /* PROP chunks inside a LIST are stored separately */
+        if(group->chunkId == IFF_ID_LIST && subChunk->chunkId == IFF_ID_PROP)
+            attached = IFF_attachPropToList((IFF_List*)group, (IFF_Prop*)subChunk);
+        else
+            attached = IFF_attachToGroup(group, subChunk);
+
+        if(!attached)
+        {
+            IFF_freeChunk(subChunk, group->groupType, chunkRegistry);
+            return FALSE;
+        }
+
+        /* Increase the bytes processed counter */
+        *bytesProcessed = IFF_incrementChunkSize(*bytesProcessed, subChunk);
+    }
+
+    if(*bytesProcessed > group->chunkSize)
+        IFF_error("WARNING: truncated group chunk! The size specifies: %d but the total amount of its sub chunks is: %d bytes. The parser may get confused!\n", group->chunkSize, *bytesProcessed);
+
+    return TRUE;
+}
+
+static IFF_Bool readRawChunk(IFF_Cursor *cursor, IFF_Chunk *chunk, IFF_Long *bytesProcessed)
+{
+    IFF_RawChunk *rawChunk = (IFF_RawChunk*)chunk;
+
+    if(rawChunk->chunkDataBorrowed)
+    {
+        /* The chunk data already refers to the memory block, so we only have to move beyond it */
+        cursor->position += rawChunk->chunkSize;
+        *bytesProcessed = *bytesProcessed + rawChunk->chunkSize;
+        return TRUE;
+    }
+    else if(IFF_readCursorBytes(cursor, rawChunk->chunkData, rawChunk->chunkSize, rawChunk->chunkId, "chunkData"))
+    {
+        *bytesProcessed = *bytesProcessed + rawChunk->chunkSize;
+        return TRUE;
+    }
+    else
+        return FALSE;
+}
+
+static IFF_Bool readExtensionChunk(IFF_Cursor *cursor, IFF_Chunk *chunk, const IFF_ChunkType *chunkType, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+{
+    size_t bodySize = IFF_getCursorBytesLeft(cursor);
+    IFF_MemoryIOStream stream;
+    IFF_Bool status;
+
+    /* Expose only the body of the chunk, so that the chunk type cannot read beyond it */
+    if(chunk->chunkSize < 0)
+        bodySize = 0;
+    else if((size_t)chunk->chunkSize < bodySize)
+        bodySize = chunk->chunkSize;
+
+    /* The chunk type only reads from the stream, so it is safe to refer to the read-only memory block */
+    IFF_initMemoryIOStream(&stream, (IFF_UByte*)(cursor->data + cursor->position), bodySize);
+
+    status = chunkType->readExtensionChunkFields((IFF_IOStream*)&stream, chunk, chunkRegistry, bytesProcessed);
+
+    /* Move the cursor beyond the bytes that were consumed by the chunk type */
+    cursor->position += stream.position;
+
+    return status;
+}
+
+static IFF_Chunk *createChunk(IFF_Cursor *cursor, const IFF_ChunkType *chunkType, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Bool borrowRawChunkData)
+{
+    /* Raw chunk data may refer to the memory block, so that it does not have to be allocated and copied */
+    if(borrowRawChunkData
+        && chunkType->createExtensionChunk == &IFF_createRawChunk && chunkType->readExtensionChunkFields == &IFF_readRawChunk
+        && chunkSize >= 0 && (size_t)chunkSize <= IFF_getCursorBytesLeft(cursor))
+        return IFF_createBorrowedRawChunk(chunkId, chunkSize, cursor->data + cursor->position);
+    else
+        return chunkType->createExtensionChunk(chunkId, chunkSize);
+}
+
+static IFF_Bool readChunkFields(IFF_Cursor *cursor, IFF_Chunk *chunk, const IFF_ChunkType *chunkType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Bool borrowRawChunkData, IFF_Long *bytesProcessed)
+{
+    if(chunkType->readExtensionChunkFields == &IFF_readForm || chunkType->readExtensionChunkFields == &IFF_readProp)
+        return readGroup(cursor, chunk, "formType", chunkRegistry, borrowRawChunkData, bytesProcessed);
+    else if(chunkType->readExtensionChunkFields == &IFF_readCAT || chunkType->readExtensionChunkFields == &IFF_readList)
+        return readGroup(cursor, chunk, "contentsType", chunkRegistry, borrowRawChunkData, bytesProcessed);
+    else if(chunkType->readExtensionChunkFields == &IFF_readRawChunk)
+        return readRawChunk(cursor, chunk, bytesProcessed);
+    else
+        return readExtensionChunk(cursor, chunk, chunkType, chunkRegistry, bytesProcessed);
+}
+
+IFF_Chunk *IFF_readMappedChunk(IFF_Cursor *cursor, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Bool borrowRawChunkData)
+{
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+    IFF_ChunkType *chunkType;
+    IFF_Chunk *chunk;
+
+    if(!IFF_readCursorId(cursor, &chunkId, ID_EMPTY, "")
+        || !IFF_readCursorLong(cursor, &chunkSize, chunkId, "chunkSize"))
+        return NULL;
+
+    chunkType = IFF_findChunkType(chunkRegistry, formType, chunkId);
+    chunk = createChunk(cursor, chunkType, chunkId, chunkSize, borrowRawChunkData);
+
+    if(chunk != NULL)
+    {
+        IFF_Long bytesProcessed = 0;
+
+        chunk->chunkType = chunkType;
+
+        /* Read remaining bytes (procedure depends on chunk id type) */
+        if(!readChunkFields(cursor, chunk, chunkType, chunkRegistry, borrowRawChunkData, &bytesProcessed)
+            || !IFF_skipCursorUnknownBytes(cursor, chunk->chunkId, chunkSize, bytesProcessed)
+            || !IFF_readCursorPaddingByte(cursor, chunkSize, chunk->chunkId))
+        {
+            IFF_freeChunk(chunk, formType, chunkRegistry);
+            return NULL;
+        }
+    }
+
+    return chunk;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_MAPPED_H
+#define __IFF_MAPPED_H
+
+typedef struct IFF_MappedFile IFF_MappedFile;
+
+#include <stddef.h>
+#include "ifftypes.h"
+#include "chunk.h"
+#include "cursor.h"
+
+/**
+ * @brief The contents of a file that has been made accessible as a block of memory
+ */
+struct IFF_MappedFile
+{
+    /** Pointer to the first byte of the file contents */
+    const IFF_UByte *data;
+
+    /** Size of the file in bytes */
+    size_t size;
+
+    /** Indicates whether the contents was mapped into memory (TRUE) or read into an allocated buffer (FALSE) */
+    IFF_Bool mapped;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Maps the file with the given filename into memory. If memory mapping is not
+ * supported by the platform, the file is read into an allocated buffer with a
+ * single read operation. The mapping must be released with IFF_closeMappedFile().
+ *
+ * @param mappedFile A mapped file instance that will refer to the contents of the file
+ * @param filename Filename of the file
+ * @return TRUE if the file has been successfully mapped, else FALSE
+ */
+IFF_Bool IFF_openMappedFile(IFF_MappedFile *mappedFile, const char *filename);
+
+/**
+ * Releases the memory of a file that was mapped with IFF_openMappedFile().
+ *
+ * @param mappedFile A mapped file instance
+ */
+void IFF_closeMappedFile(IFF_MappedFile *mappedFile);
+
+/**
+ * Reads a chunk hierarchy from a block of memory. Group chunks and raw chunks
+ * are directly parsed from the memory block. Application specific chunks are
+ * read by their chunk type through a stream that refers to the chunk body.
+ * The resulting chunk must be freed using IFF_free()
+ *
+ * When raw chunk data is borrowed, raw chunks refer to their bodies in the
+ * memory block instead of a copy, so the memory block must remain valid and
+ * unmodified until the resulting chunk has been freed.
+ *
+ * @param cursor A cursor referring to the position of the chunk in the memory block
+ * @param formType Form type id describing in which FORM the sub chunk is located. 0 is used for sub chunks in other group chunks.
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param borrowRawChunkData Indicates whether raw chunks should refer to the memory block (TRUE) or to a copy of their data (FALSE)
+ * @return A chunk hierarchy derived from the memory block, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readMappedChunk(IFF_Cursor *cursor, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Bool borrowRawChunkData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "memorystream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t limitToBytesLeft(const IFF_MemoryIOStream *memoryStream, const size_t size)
+{
+    size_t bytesLeft = memoryStream->size - memoryStream->position;
+
+    if(size > bytesLeft)
+        return bytesLeft;
+    else
+        return size;
+}
+
+static size_t readMemory(IFF_IOStream *stream, void *buffer, const size_t size)
+{
+    IFF_MemoryIOStream *memoryStream = (IFF_MemoryIOStream*)stream;
+    size_t bytesRead = limitToBytesLeft(memoryStream, size);
+
+    memcpy(buffer, memoryStream->data + memoryStream->position, bytesRead);
+    memoryStream->position += bytesRead;
+
+    return bytesRead;
+}
+
+static void enlargeMemory(IFF_MemoryIOStream *memoryStream, const size_t minimumSize)
+{
+    /* Double the size, so that a sequence of writes requires a logarithmic amount of reallocations */
+    size_t newSize = memoryStream->size * 2;
+    IFF_UByte *data;
+
+    if(newSize < minimumSize)
+        newSize = minimumSize;
+
+    data = (IFF_UByte*)realloc(memoryStream->data, newSize * sizeof(IFF_UByte));
+
+    /* If the memory cannot be enlarged, we keep the original memory block and only write the bytes that fit */
+    if(data != NULL)
+    {
+        memoryStream->data = data;
+        memoryStream->size = newSize;
+    }
+}
+
+static size_t writeMemory(IFF_IOStream *stream, const void *buffer, const size_t size)
+{
+    IFF_MemoryIOStream *memoryStream = (IFF_MemoryIOStream*)stream;
+    size_t bytesWritten;
+
+    if(memoryStream->growable && size > memoryStream->size - memoryStream->position)
+        enlargeMemory(memoryStream, memoryStream->position + size);
+
+    bytesWritten = limitToBytesLeft(memoryStream, size);
+
+    memcpy(memoryStream->data + memoryStream->position, buffer, bytesWritten);
+    memoryStream->position += bytesWritten;
+
+    return bytesWritten;
+}
+
+static IFF_Bool seekMemory(IFF_IOStream *stream, const long offset, const int origin)
+{
+    IFF_MemoryIOStream *memoryStream = (IFF_MemoryIOStream*)stream;
+    long base;
+
+    switch(origin)
+    {
+        case SEEK_SET:
+            base = 0;
+            break;
+        case SEEK_CUR:
+            base = memoryStream->position;
+            break;
+        case SEEK_END:
+            base = memoryStream->size;
+            break;
+        default:
+            return FALSE;
+    }
+
+    /* The position must remain within the boundaries of the memory block */
+    if(offset < -base || (size_t)(base + offset) > memoryStream->size)
+        return FALSE;
+    else
+    {
+        memoryStream->position = base + offset;
+        return TRUE;
+    }
+}
+
+static long tellMemory(IFF_IOStream *stream)
+{
+    IFF_MemoryIOStream *memoryStream = (IFF_MemoryIOStream*)stream;
+    return memoryStream->position;
+}
+
+void IFF_initMemoryIOStream(IFF_MemoryIOStream *stream, IFF_UByte *data, const size_t size)
+{
+    stream->read = &readMemory;
+    stream->write = &writeMemory;
+    stream->seek = &seekMemory;
+    stream->tell = &tellMemory;
+    stream->sparse = FALSE;
+    stream->data = data;
+    stream->size = size;
+    stream->position = 0;
+    stream->growable = FALSE;
+}
+
+IFF_Bool IFF_initGrowableMemoryIOStream(IFF_MemoryIOStream *stream, const size_t initialSize)
+{
+    IFF_UByte *data = (IFF_UByte*)malloc((initialSize == 0 ? 1 : initialSize) * sizeof(IFF_UByte));
+
+    if(data == NULL)
+        return FALSE;
+    else
+    {
+        IFF_initMemoryIOStream(stream, data, initialSize);
+        stream->growable = TRUE;
+        return TRUE;
+    }
+}
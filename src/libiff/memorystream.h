@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_MEMORYSTREAM_H
+#define __IFF_MEMORYSTREAM_H
+
+typedef struct IFF_MemoryIOStream IFF_MemoryIOStream;
+
+#include <stddef.h>
+#include "ifftypes.h"
+#include "stream.h"
+
+/**
+ * @brief A stream that reads from and writes to a block of memory.
+ */
+struct IFF_MemoryIOStream
+{
+    /** Function responsible for reading the given amount of bytes into a buffer */
+    size_t (*read) (IFF_IOStream *stream, void *buffer, const size_t size);
+
+    /** Function responsible for writing the given amount of bytes from a buffer */
+    size_t (*write) (IFF_IOStream *stream, const void *buffer, const size_t size);
+
+    /** Function responsible for moving the position of the stream */
+    IFF_Bool (*seek) (IFF_IOStream *stream, const long offset, const int origin);
+
+    /** Function responsible for returning the current position of the stream */
+    long (*tell) (IFF_IOStream *stream);
+
+    /** Indicates whether large zero fillers can be written as holes, which is never the case for memory blocks */
+    IFF_Bool sparse;
+
+    /** Pointer to the first byte of the memory block */
+    IFF_UByte *data;
+
+    /** Size of the memory block in bytes */
+    size_t size;
+
+    /** Offset of the next byte that will be read or written */
+    size_t position;
+
+    /** Indicates whether the memory block is owned by the stream and enlarged when writing beyond its end (TRUE), or whether it has a fixed size (FALSE) */
+    IFF_Bool growable;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a stream that reads from and writes to the given block of memory.
+ * Reading and writing beyond the end of the memory block fails. The stream
+ * does not take ownership of the memory block.
+ *
+ * @param stream A memory stream instance
+ * @param data Pointer to the first byte of the memory block
+ * @param size Size of the memory block in bytes
+ */
+void IFF_initMemoryIOStream(IFF_MemoryIOStream *stream, IFF_UByte *data, const size_t size);
+
+/**
+ * Initializes a stream that writes to a newly allocated block of memory, which
+ * is enlarged when writing beyond its end. The memory block must be freed with
+ * free(), even if nothing has been written. The amount of bytes written is
+ * available as the position of the stream, when writes are sequential.
+ *
+ * @param stream A memory stream instance
+ * @param initialSize Initial size of the memory block in bytes. If the final size is known in advance, no reallocations are needed.
+ * @return TRUE if the memory block has been successfully allocated, else FALSE
+ */
+IFF_Bool IFF_initGrowableMemoryIOStream(IFF_MemoryIOStream *stream, const size_t initialSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,643 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#if HAVE_PTHREAD_H == 1
+#include <pthread.h>
+#endif
+#if HAVE_UNISTD_H == 1
+#include <unistd.h>
+#endif
+#include "mapped.h"
+#include "group.h"
+#include "cat.h"
+#include "list.h"
+#include "prop.h"
+#include "lazy.h"
+#include "arena.h"
+#include "error.h"
+#include "context.h"
+#include "threadlocal.h"
+
+#define ID_EMPTY IFF_MAKEID(' ', ' ', ' ', ' ')
+
+/* The threads select their own arena and context, so without thread local storage the tasks are executed sequentially */
+#if HAVE_PTHREAD_H == 1 && IFF_HAVE_THREAD_LOCAL == 1
+#define IFF_USE_THREADS 1
+#endif
+
+#define IFF_INITIAL_MEMBER_CAPACITY 16
+
+/** Maximum length of a single error message that is collected while checking a member */
+#define IFF_MAX_MESSAGE_LENGTH 256
+
+#if IFF_USE_THREADS == 1
+typedef struct
+{
+    IFF_ParallelTask task;
+    void *taskData;
+    unsigned int taskLength;
+    unsigned int nextIndex;
+    pthread_mutex_t mutex;
+}
+WorkQueue;
+
+static void *executeTasks(void *data)
+{
+    WorkQueue *queue = (WorkQueue*)data;
+
+    while(TRUE)
+    {
+        unsigned int index;
+
+        /* Take the next work item, so that threads that finish early pick up the remainder */
+        pthread_mutex_lock(&queue->mutex);
+        index = queue->nextIndex;
+
+        if(index < queue->taskLength)
+            queue->nextIndex++;
+
+        pthread_mutex_unlock(&queue->mutex);
+
+        if(index >= queue->taskLength)
+            break;
+
+        queue->task(queue->taskData, index);
+    }
+
+    return NULL;
+}
+#endif
+
+static unsigned int determineNumOfThreads(const void *executorData)
+{
+    if(executorData != NULL && *((const unsigned int*)executorData) > 0)
+        return *((const unsigned int*)executorData);
+    else
+    {
+#if HAVE_UNISTD_H == 1 && defined(_SC_NPROCESSORS_ONLN)
+        long numOfProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+
+        if(numOfProcessors > 0)
+            return numOfProcessors;
+#endif
+        return 1;
+    }
+}
+
+IFF_Bool IFF_executeInThreads(void *executorData, IFF_ParallelTask task, void *taskData, const unsigned int taskLength)
+{
+    unsigned int numOfThreads = determineNumOfThreads(executorData);
+
+    if(numOfThreads > taskLength)
+        numOfThreads = taskLength;
+
+#if IFF_USE_THREADS == 1
+    if(numOfThreads > 1)
+    {
+        WorkQueue queue;
+        pthread_t *thread = (pthread_t*)malloc((numOfThreads - 1) * sizeof(pthread_t));
+        unsigned int i, numOfStartedThreads = 0;
+
+        if(thread == NULL)
+        {
+            IFF_error("Cannot allocate memory for: %u threads!\n", numOfThreads);
+            return FALSE;
+        }
+
+        queue.task = task;
+        queue.taskData = taskData;
+        queue.taskLength = taskLength;
+        queue.nextIndex = 0;
+        pthread_mutex_init(&queue.mutex, NULL);
+
+        /* The calling thread is one of the workers. If a thread cannot be started, the remaining threads take over its share */
+        for(i = 0; i < numOfThreads - 1; i++)
+        {
+            if(pthread_create(&thread[numOfStartedThreads], NULL, executeTasks, &queue) == 0)
+                numOfStartedThreads++;
+        }
+
+        executeTasks(&queue);
+
+        for(i = 0; i < numOfStartedThreads; i++)
+            pthread_join(thread[i], NULL);
+
+        pthread_mutex_destroy(&queue.mutex);
+        free(thread);
+        return TRUE;
+    }
+#endif
+    {
+        unsigned int i;
+
+        for(i = 0; i < taskLength; i++)
+            task(taskData, i);
+
+        return TRUE;
+    }
+}
+
+typedef struct
+{
+    const IFF_UByte *data;
+    size_t size;
+    IFF_ID formType;
+    const IFF_ChunkRegistry *chunkRegistry;
+    IFF_Bool borrowRawChunkData;
+    size_t *memberPosition;
+    IFF_Chunk **member;
+}
+ParallelRead;
+
+static void readMember(void *data, const unsigned int index)
+{
+    ParallelRead *parallelRead = (ParallelRead*)data;
+    IFF_Cursor cursor;
+
+    /* Every member has its own cursor, so that members can be read independently */
+    IFF_initCursor(&cursor, parallelRead->data, parallelRead->size);
+    cursor.position = parallelRead->memberPosition[index];
+
+    parallelRead->member[index] = IFF_readMappedChunk(&cursor, parallelRead->formType, parallelRead->chunkRegistry, parallelRead->borrowRawChunkData);
+}
+
+static IFF_Bool scanMembers(IFF_Cursor *cursor, const IFF_Group *group, IFF_Long *bytesProcessed, size_t **memberPosition, unsigned int *memberLength)
+{
+    unsigned int memberCapacity = 0;
+
+    *memberPosition = NULL;
+    *memberLength = 0;
+
+    /* Only read the headers of the sub chunks, to determine where they start */
+    while(*bytesProcessed < group->chunkSize)
+    {
+        size_t position = cursor->position;
+        IFF_ID chunkId;
+        IFF_Long chunkSize;
+
+        if(!IFF_readCursorId(cursor, &chunkId, ID_EMPTY, "")
+            || !IFF_readCursorLong(cursor, &chunkSize, chunkId, "chunkSize"))
+            return FALSE;
+
+        if(*memberLength == memberCapacity)
+        {
+            size_t *newMemberPosition;
+
+            memberCapacity = memberCapacity == 0 ? IFF_INITIAL_MEMBER_CAPACITY : memberCapacity * 2;
+
+            if((newMemberPosition = (size_t*)realloc(*memberPosition, memberCapacity * sizeof(size_t))) == NULL)
+            {
+                IFF_error("Cannot allocate memory for the positions of: %u sub chunks!\n", memberCapacity);
+                return FALSE;
+            }
+
+            *memberPosition = newMemberPosition;
+        }
+
+        (*memberPosition)[*memberLength] = position;
+        *memberLength = *memberLength + 1;
+
+        /* Move beyond the body and padding byte. A body that exceeds the memory block is reported by the member read */
+        if(chunkSize < 0 || (size_t)chunkSize + (chunkSize % 2) > IFF_getCursorBytesLeft(cursor))
+            cursor->position = cursor->size;
+        else
+            cursor->position += chunkSize + (chunkSize % 2);
+
+        *bytesProcessed = *bytesProcessed + IFF_ID_SIZE + sizeof(IFF_Long) + chunkSize + (chunkSize % 2);
+    }
+
+    if(*bytesProcessed > group->chunkSize)
+        IFF_error("WARNING: truncated group chunk! The size specifies: %d but the total amount of its sub chunks is: %d bytes. The parser may get confused!\n", group->chunkSize, *bytesProcessed);
+
+    return TRUE;
+}
+
+static IFF_Bool readMembers(IFF_Cursor *cursor, IFF_Group *group, const IFF_ChunkRegistry *chunkRegistry, const IFF_Bool borrowRawChunkData, IFF_Executor executor, void *executorData, IFF_Long *bytesProcessed)
+{
+    ParallelRead parallelRead;
+    unsigned int i, memberLength;
+    IFF_Bool status = TRUE;
+
+    if(!scanMembers(cursor, group, bytesProcessed, &parallelRead.memberPosition, &memberLength))
+    {
+        free(parallelRead.memberPosition);
+        return FALSE;
+    }
+
+    if(memberLength == 0)
+        return TRUE;
+
+    if((parallelRead.member = (IFF_Chunk**)calloc(memberLength, sizeof(IFF_Chunk*))) == NULL)
+    {
+        free(parallelRead.memberPosition);
+        return FALSE;
+    }
+
+    parallelRead.data = cursor->data;
+    parallelRead.size = cursor->size;
+    parallelRead.formType = group->groupType;
+    parallelRead.chunkRegistry = chunkRegistry;
+    parallelRead.borrowRawChunkData = borrowRawChunkData;
+
+    if(!executor(executorData, readMember, &parallelRead, memberLength))
+        status = FALSE;
+
+    for(i = 0; i < memberLength; i++)
+    {
+        if(parallelRead.member[i] == NULL)
+            status = FALSE;
+    }
+
+    if(status && IFF_reserveGroup(group, memberLength))
+    {
+        /* Attach the members in their original order */
+        for(i = 0; i < memberLength; i++)
+        {
+            IFF_Chunk *member = parallelRead.member[i];
+            IFF_Bool attached;
+
+            /* PROP chunks inside a LIST are stored separately */
+            if(group->chunkId == IFF_ID_LIST && member->chunkId == IFF_ID_PROP)
+                attached = IFF_attachPropToList((IFF_List*)group, (IFF_Prop*)member);
+            else
+                attached = IFF_attachToGroup(group, member);
+
+            if(!attached)
+            {
+                IFF_freeChunk(member, group->groupType, chunkRegistry);
+                status = FALSE;
+            }
+        }
+    }
+    else
+    {
+        for(i = 0; i < memberLength; i++)
+        {
+            if(parallelRead.member[i] != NULL)
+                IFF_freeChunk(parallelRead.member[i], group->groupType, chunkRegistry);
+        }
+
+        status = FALSE;
+    }
+
+    free(parallelRead.member);
+    free(parallelRead.memberPosition);
+
+    return status;
+}
+
+IFF_Chunk *IFF_readParallelChunk(IFF_Cursor *cursor, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Bool borrowRawChunkData, IFF_Executor executor, void *executorData)
+{
+    size_t position = cursor->position;
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+    IFF_ChunkType *chunkType;
+    IFF_Chunk *chunk;
+    IFF_Long bytesProcessed = IFF_ID_SIZE;
+    IFF_Arena *previousArena;
+
+    if(!IFF_readCursorId(cursor, &chunkId, ID_EMPTY, "")
+        || !IFF_readCursorLong(cursor, &chunkSize, chunkId, "chunkSize"))
+        return NULL;
+
+    chunkType = IFF_findChunkType(chunkRegistry, formType, chunkId);
+
+    /* Only the members of CATs and LISTs are independent of each other */
+    if((chunkType->readExtensionChunkFields != &IFF_readCAT && chunkType->readExtensionChunkFields != &IFF_readList) || chunkSize < IFF_ID_SIZE)
+    {
+        cursor->position = position;
+        return IFF_readMappedChunk(cursor, formType, chunkRegistry, borrowRawChunkData);
+    }
+
+    /* Worker threads cannot safely share an arena, so the entire hierarchy is allocated from the heap */
+    previousArena = IFF_selectArena(NULL);
+
+    if((chunk = chunkType->createExtensionChunk(chunkId, chunkSize)) != NULL)
+    {
+        chunk->chunkType = chunkType;
+
+        if(!IFF_readCursorId(cursor, &((IFF_Group*)chunk)->groupType, chunkId, "contentsType")
+            || !readMembers(cursor, (IFF_Group*)chunk, chunkRegistry, borrowRawChunkData, executor, executorData, &bytesProcessed)
+            || !IFF_skipCursorUnknownBytes(cursor, chunkId, chunkSize, bytesProcessed)
+            || !IFF_readCursorPaddingByte(cursor, chunkSize, chunkId))
+        {
+            IFF_freeChunk(chunk, formType, chunkRegistry);
+            chunk = NULL;
+        }
+    }
+
+    IFF_selectArena(previousArena);
+    return chunk;
+}
+
+typedef struct
+{
+    const IFF_Chunk *chunk;
+    IFF_ID formType;
+    IFF_Bool status;
+    IFF_Context *context;
+    char *messages;
+    size_t messagesLength;
+}
+CheckTask;
+
+typedef struct
+{
+    const IFF_ChunkRegistry *chunkRegistry;
+    CheckTask *task;
+    unsigned int taskLength;
+    unsigned int taskCapacity;
+    unsigned int nextTask;
+}
+ParallelCheck;
+
+static IFF_ChunkType *getChunkType(const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
+{
+    if(chunk->chunkType == NULL)
+        return IFF_findChunkType(chunkRegistry, formType, chunk->chunkId);
+    else
+        return chunk->chunkType;
+}
+
+static IFF_Bool loadChunks(const IFF_Chunk *chunk)
+{
+    /* Lazily read chunks share a stream, so they are loaded before the members are checked concurrently */
+    if(IFF_isGroupChunk(chunk))
+    {
+        IFF_Group *group = (IFF_Group*)chunk;
+        unsigned int i;
+
+        if(group->lazyChunks != NULL && !IFF_loadGroupSubChunks(group))
+            return FALSE;
+
+        for(i = 0; i < group->chunkLength; i++)
+        {
+            if(!loadChunks(group->chunk[i]))
+                return FALSE;
+        }
+
+        if(chunk->chunkId == IFF_ID_LIST)
+        {
+            IFF_List *list = (IFF_List*)chunk;
+
+            for(i = 0; i < list->propLength; i++)
+            {
+                if(!loadChunks((IFF_Chunk*)list->prop[i]))
+                    return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+static IFF_Bool addCheckTask(ParallelCheck *check, const IFF_Chunk *chunk, const IFF_ID formType)
+{
+    CheckTask *task;
+
+    if(check->taskLength == check->taskCapacity)
+    {
+        unsigned int taskCapacity = check->taskCapacity == 0 ? IFF_INITIAL_MEMBER_CAPACITY : check->taskCapacity * 2;
+        CheckTask *newTask = (CheckTask*)realloc(check->task, taskCapacity * sizeof(CheckTask));
+
+        if(newTask == NULL)
+        {
+            IFF_recordError(IFF_ERROR_MEMORY);
+            IFF_error("Cannot allocate memory for the checks of: %u sub chunks!\n", taskCapacity);
+            return FALSE;
+        }
+
+        check->task = newTask;
+        check->taskCapacity = taskCapacity;
+    }
+
+    task = &check->task[check->taskLength];
+    task->chunk = chunk;
+    task->formType = formType;
+    task->status = FALSE;
+    task->context = NULL;
+    task->messages = NULL;
+    task->messagesLength = 0;
+
+    check->taskLength++;
+
+    return loadChunks(chunk);
+}
+
+static IFF_Bool isIndependentGroup(const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_ChunkType *chunkType = getChunkType(chunk, formType, chunkRegistry);
+
+    /* Only the members of CATs and LISTs are independent of each other */
+    return chunkType->checkExtensionChunk == &IFF_checkCAT || chunkType->checkExtensionChunk == &IFF_checkList;
+}
+
+static IFF_Bool collectCheckTasks(ParallelCheck *check, const IFF_Chunk *chunk, const IFF_ID formType)
+{
+    /* The members are visited in the same order as IFF_checkCAT() and IFF_checkList() visit them */
+    if(isIndependentGroup(chunk, formType, check->chunkRegistry))
+    {
+        IFF_Group *group = (IFF_Group*)chunk;
+        unsigned int i;
+
+        if(!IFF_loadGroupSubChunks(group))
+            return FALSE;
+
+        if(chunk->chunkId == IFF_ID_LIST)
+        {
+            IFF_List *list = (IFF_List*)chunk;
+
+            for(i = 0; i < list->propLength; i++)
+            {
+                if(!addCheckTask(check, (IFF_Chunk*)list->prop[i], list->contentsType))
+                    return FALSE;
+            }
+        }
+
+        for(i = 0; i < group->chunkLength; i++)
+        {
+            if(!collectCheckTasks(check, group->chunk[i], group->groupType))
+                return FALSE;
+        }
+
+        return TRUE;
+    }
+    else
+        return addCheckTask(check, chunk, formType);
+}
+
+static void collectMessage(void *data, const char *formatString, va_list ap)
+{
+    CheckTask *task = (CheckTask*)data;
+    char message[IFF_MAX_MESSAGE_LENGTH];
+    int messageLength = vsnprintf(message, IFF_MAX_MESSAGE_LENGTH, formatString, ap);
+
+    if(messageLength > 0)
+    {
+        char *messages;
+
+        if(messageLength >= IFF_MAX_MESSAGE_LENGTH)
+            messageLength = IFF_MAX_MESSAGE_LENGTH - 1;
+
+        /* Messages that cannot be stored are dropped, the verdict is not affected */
+        if((messages = (char*)realloc(task->messages, task->messagesLength + messageLength + 1)) != NULL)
+        {
+            memcpy(messages + task->messagesLength, message, messageLength + 1);
+            task->messages = messages;
+            task->messagesLength += messageLength;
+        }
+    }
+}
+
+static void checkMember(void *data, const unsigned int index)
+{
+    ParallelCheck *check = (ParallelCheck*)data;
+    CheckTask *task = &check->task[index];
+    IFF_Context context, *previousContext;
+
+    /* Every member has its own context, so that its errors and messages can be reported in document order afterwards */
+    IFF_initContext(&context);
+    context.errorCallback = &collectMessage;
+    context.errorData = task;
+
+    previousContext = IFF_selectContext(&context);
+    task->status = IFF_checkChunk(task->chunk, task->formType, check->chunkRegistry);
+    IFF_selectContext(previousContext);
+
+    if(!task->status && (task->context = (IFF_Context*)malloc(sizeof(IFF_Context))) != NULL)
+        *task->context = context;
+}
+
+static IFF_Bool reportChunk(ParallelCheck *check, const IFF_Chunk *chunk, const IFF_ID formType);
+
+static IFF_Bool reportMember(ParallelCheck *check)
+{
+    CheckTask *task = &check->task[check->nextTask];
+
+    check->nextTask++;
+
+    if(task->messages != NULL)
+        IFF_error("%s", task->messages);
+
+    if(!task->status && task->context != NULL)
+        IFF_recordContextError(task->context);
+
+    return task->status;
+}
+
+static IFF_Long reportGroupSubChunks(ParallelCheck *check, const IFF_Group *group)
+{
+    unsigned int i;
+    IFF_Long chunkSize = 0;
+
+    for(i = 0; i < group->chunkLength; i++)
+    {
+        IFF_Chunk *subChunk = group->chunk[i];
+
+        if(!IFF_checkCATSubChunk(group, subChunk) || !reportChunk(check, subChunk, group->groupType))
+            return -1;
+
+        chunkSize = IFF_incrementChunkSize(chunkSize, subChunk);
+    }
+
+    return chunkSize;
+}
+
+static IFF_Bool reportGroup(ParallelCheck *check, const IFF_Group *group)
+{
+    IFF_Long chunkSize = IFF_ID_SIZE;
+    IFF_Long subChunkSize;
+
+    if(!IFF_checkId(group->groupType))
+        return FALSE;
+
+    if(group->chunkId == IFF_ID_LIST)
+    {
+        const IFF_List *list = (const IFF_List*)group;
+        unsigned int i;
+
+        for(i = 0; i < list->propLength; i++)
+        {
+            if(!reportMember(check))
+                return FALSE;
+
+            chunkSize = IFF_incrementChunkSize(chunkSize, (IFF_Chunk*)list->prop[i]);
+        }
+    }
+
+    if((subChunkSize = reportGroupSubChunks(check, group)) == -1)
+        return FALSE;
+
+    return IFF_checkGroupChunkSize(group, chunkSize + subChunkSize);
+}
+
+static IFF_Bool reportChunk(ParallelCheck *check, const IFF_Chunk *chunk, const IFF_ID formType)
+{
+    /* Reproduces the verdict and messages of IFF_checkChunk(), using the results of the members that have been checked concurrently */
+    if(isIndependentGroup(chunk, formType, check->chunkRegistry))
+    {
+        IFF_Bool status;
+
+        IFF_enterChunk(NULL, chunk->chunkId);
+
+        status = IFF_checkId(chunk->chunkId) && reportGroup(check, (const IFF_Group*)chunk);
+
+        if(!status)
+            IFF_recordError(IFF_ERROR_INVALID);
+
+        IFF_leaveChunk();
+        return status;
+    }
+    else
+        return reportMember(check);
+}
+
+IFF_Bool IFF_checkParallelChunk(const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, IFF_Executor executor, void *executorData)
+{
+    ParallelCheck check;
+    IFF_Bool status;
+    unsigned int i;
+
+    check.chunkRegistry = chunkRegistry;
+    check.task = NULL;
+    check.taskLength = 0;
+    check.taskCapacity = 0;
+    check.nextTask = 0;
+
+    status = collectCheckTasks(&check, chunk, formType)
+        && executor(executorData, checkMember, &check, check.taskLength)
+        && reportChunk(&check, chunk, formType);
+
+    for(i = 0; i < check.taskLength; i++)
+    {
+        free(check.task[i].context);
+        free(check.task[i].messages);
+    }
+
+    free(check.task);
+
+    return status;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_PARALLEL_H
+#define __IFF_PARALLEL_H
+
+#include "ifftypes.h"
+#include "chunk.h"
+#include "chunkregistry.h"
+#include "cursor.h"
+
+/**
+ * A task that processes one element of a collection of independent work items.
+ *
+ * @param data Arbitrary data that is shared by all tasks
+ * @param index Index of the work item that should be processed
+ */
+typedef void (*IFF_ParallelTask) (void *data, const unsigned int index);
+
+/**
+ * An executor that runs a task for every index in [0, taskLength), possibly
+ * concurrently, and returns when all of them have completed.
+ *
+ * @param executorData Arbitrary data that configures the executor
+ * @param task Task that should be executed for every index
+ * @param taskData Data that is passed to every invocation of the task
+ * @param taskLength Number of indices for which the task should be executed
+ * @return TRUE if all tasks have been executed, else FALSE
+ */
+typedef IFF_Bool (*IFF_Executor) (void *executorData, IFF_ParallelTask task, void *taskData, const unsigned int taskLength);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * An executor that distributes the tasks over a number of threads. If the
+ * library has been built without thread support or without thread local
+ * storage, the tasks are executed sequentially by the calling thread.
+ *
+ * @param executorData Pointer to an unsigned int containing the number of threads, or NULL or 0 to use the number of online processors
+ * @param task Task that should be executed for every index
+ * @param taskData Data that is passed to every invocation of the task
+ * @param taskLength Number of indices for which the task should be executed
+ * @return TRUE if all tasks have been executed, else FALSE
+ */
+IFF_Bool IFF_executeInThreads(void *executorData, IFF_ParallelTask task, void *taskData, const unsigned int taskLength);
+
+/**
+ * Reads a chunk hierarchy from a memory block, like IFF_readMappedChunk(). If
+ * the chunk is a CAT or LIST, its sub chunks are located by only scanning their
+ * headers, after which they are parsed independently by the given executor and
+ * attached in their original order. Other chunks are read sequentially.
+ * The resulting hierarchy is always allocated from the heap, even when an arena has been selected.
+ *
+ * @param cursor A cursor referring to a memory block
+ * @param formType Form type id describing in which FORM the sub chunk is located. 0 is used for sub chunks in other group chunks.
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param borrowRawChunkData Indicates whether the data of raw chunks should refer to the memory block, rather than being copied
+ * @param executor Executor that parses the sub chunks
+ * @param executorData Arbitrary data that configures the executor
+ * @return A chunk hierarchy derived from the memory block, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readParallelChunk(IFF_Cursor *cursor, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Bool borrowRawChunkData, IFF_Executor executor, void *executorData);
+
+/**
+ * Checks whether a chunk hierarchy conforms to the IFF specification, like
+ * IFF_checkChunk(). The members of CATs and LISTs are checked independently by
+ * the given executor, after which their messages and errors are reported in
+ * document order. The verdict and the reported messages are the same as those
+ * of IFF_checkChunk(). Chunks that have been read lazily are loaded before the
+ * members are checked. The check functions of the chunk types must be safe to
+ * invoke concurrently for different chunks.
+ * @param chunk A chunk hierarchy
+ * @param formType Form type id describing in which FORM the sub chunk is located. 0 is used for sub chunks in other group chunks.
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param executor Executor that checks the members
+ * @param executorData Arbitrary data that configures the executor
+ * @return TRUE if the chunk hierarchy is valid, else FALSE
+ */
+IFF_Bool IFF_checkParallelChunk(const IFF_Chunk *chunk, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, IFF_Executor executor, void *executorData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -46,19 +46,9 @@ IFF_Chunk *IFF_createUnparsedProp(const IFF_ID chunkId, const IFF_Long chunkSize
     return IFF_createUnparsedGroup(chunkId, chunkSize);
 }
 
-void IFF_addToProp(IFF_Prop *prop, IFF_Chunk *chunk)
+IFF_Bool IFF_addToProp(IFF_Prop *prop, IFF_Chunk *chunk)
 {
-    IFF_addToForm((IFF_Form*)prop, chunk);
-}
-
-IFF_Bool IFF_readProp(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
-{
-    return IFF_readGroup(file, chunk, PROP_GROUPTYPENAME, chunkRegistry, bytesProcessed);
-}
-
-IFF_Bool IFF_writeProp(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
-{
-    return IFF_writeForm(file, chunk, chunkRegistry, bytesProcessed);
+    return IFF_addToForm((IFF_Form*)prop, chunk);
 }
 
 static IFF_Bool subChunkCheck(const IFF_Group *group, const IFF_Chunk *subChunk)
@@ -78,6 +68,16 @@ static IFF_Bool subChunkCheck(const IFF_Group *group, const IFF_Chunk *subChunk)
         return TRUE;
 }
 
+IFF_Bool IFF_readProp(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+{
+    return IFF_readCheckedGroup(stream, chunk, PROP_GROUPTYPENAME, &IFF_checkFormType, &subChunkCheck, chunkRegistry, bytesProcessed);
+}
+
+IFF_Bool IFF_writeProp(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+{
+    return IFF_writeForm(stream, chunk, chunkRegistry, bytesProcessed);
+}
+
 IFF_Bool IFF_checkProp(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
 {
     return IFF_checkGroup((IFF_Group*)chunk, &IFF_checkFormType, &subChunkCheck, chunkRegistry);
@@ -28,6 +28,7 @@ typedef struct IFF_Form IFF_Prop;
 
 #include <stdio.h>
 #include "ifftypes.h"
+#include "stream.h"
 #include "chunk.h"
 #include "form.h"
 
@@ -72,30 +73,31 @@ IFF_Chunk *IFF_createUnparsedProp(const IFF_ID chunkId, const IFF_Long chunkSize
  *
  * @param prop An instance of a PROP chunk
  * @param chunk A data chunk
+ * @return TRUE if the chunk has been added, or FALSE if the memory for it cannot be allocated. In that case, the chunk remains owned by the caller
  */
-void IFF_addToProp(IFF_Prop *prop, IFF_Chunk *chunk);
+IFF_Bool IFF_addToProp(IFF_Prop *prop, IFF_Chunk *chunk);
 
 /**
- * Reads a PROP chunk and its sub chunks from a file.
+ * Reads a PROP chunk and its sub chunks from a stream.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk An instance of a PROP chunk
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the PROP has been successfully read, or FALSE if an error has occured
  */
-IFF_Bool IFF_readProp(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_readProp(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
- * Writes a PROP chunk and its sub chunks to a file.
+ * Writes a PROP chunk and its sub chunks to a stream.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk An instance of a PROP chunk
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the PROP has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeProp(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_writeProp(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
  * Checks whether the PROP chunk and its sub chunks conform to the IFF specification.
@@ -23,9 +23,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include "error.h"
+#include "context.h"
 #include "io.h"
 #include "id.h"
+#include "group.h"
 #include "util.h"
+#include "arena.h"
 
 IFF_Chunk *IFF_createRawChunk(const IFF_ID chunkId, const IFF_Long chunkSize)
 {
@@ -33,44 +36,71 @@ IFF_Chunk *IFF_createRawChunk(const IFF_ID chunkId, const IFF_Long chunkSize)
 
     if(rawChunk != NULL)
     {
-        rawChunk->chunkData = (IFF_UByte*)malloc(chunkSize * sizeof(IFF_UByte));
+        rawChunk->chunkData = (IFF_UByte*)IFF_allocateIn(rawChunk->arena, chunkSize * sizeof(IFF_UByte));
 
         if(rawChunk->chunkData == NULL)
         {
-            free(rawChunk);
+            IFF_deallocateIn(rawChunk->arena, rawChunk);
             return NULL;
         }
+
+        rawChunk->chunkDataBorrowed = FALSE;
     }
 
     return (IFF_Chunk*)rawChunk;
 }
 
+IFF_Chunk *IFF_createBorrowedRawChunk(const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_UByte *chunkData)
+{
+    IFF_RawChunk *rawChunk = (IFF_RawChunk*)IFF_createChunk(chunkId, chunkSize, sizeof(IFF_RawChunk));
+
+    if(rawChunk != NULL)
+        IFF_borrowRawChunkData(rawChunk, chunkData, chunkSize);
+
+    return (IFF_Chunk*)rawChunk;
+}
+
 void IFF_copyDataToRawChunkData(IFF_RawChunk *rawChunk, IFF_UByte *data)
 {
     memcpy(rawChunk->chunkData, data, rawChunk->chunkSize);
+    IFF_invalidateChunkHash((IFF_Chunk*)rawChunk);
 }
 
 void IFF_setRawChunkData(IFF_RawChunk *rawChunk, IFF_UByte *chunkData, IFF_Long chunkSize)
 {
     rawChunk->chunkData = chunkData;
-    rawChunk->chunkSize = chunkSize;
+    IFF_resizeChunk((IFF_Chunk*)rawChunk, chunkSize);
+    rawChunk->chunkDataBorrowed = FALSE;
+}
+
+void IFF_borrowRawChunkData(IFF_RawChunk *rawChunk, const IFF_UByte *chunkData, IFF_Long chunkSize)
+{
+    rawChunk->chunkData = (IFF_UByte*)chunkData;
+    IFF_resizeChunk((IFF_Chunk*)rawChunk, chunkSize);
+    rawChunk->chunkDataBorrowed = TRUE;
 }
 
 void IFF_setTextData(IFF_RawChunk *rawChunk, const char *text)
 {
     size_t textLength = strlen(text);
-    IFF_UByte *chunkData = (IFF_UByte*)malloc(textLength * sizeof(IFF_UByte));
+    IFF_UByte *chunkData = (IFF_UByte*)IFF_allocateIn(rawChunk->arena, textLength * sizeof(IFF_UByte));
 
     memcpy(chunkData, text, textLength);
+
+    /* The previous chunk data is replaced, so it is no longer needed */
+    if(!rawChunk->chunkDataBorrowed)
+        IFF_deallocateIn(rawChunk->arena, rawChunk->chunkData);
+
     IFF_setRawChunkData(rawChunk, chunkData, textLength);
 }
 
-IFF_Bool IFF_readRawChunk(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool IFF_readRawChunk(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
     IFF_RawChunk *rawChunk = (IFF_RawChunk*)chunk;
 
-    if(fread(rawChunk->chunkData, sizeof(IFF_UByte), rawChunk->chunkSize, file) < rawChunk->chunkSize)
+    if(stream->read(stream, rawChunk->chunkData, rawChunk->chunkSize) < rawChunk->chunkSize)
     {
+        IFF_recordError(IFF_ERROR_READ);
         IFF_error("Error reading raw chunk body of chunk: '");
         IFF_errorId(rawChunk->chunkId);
         IFF_error("'\n");
@@ -83,12 +113,13 @@ IFF_Bool IFF_readRawChunk(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry
     }
 }
 
-IFF_Bool IFF_writeRawChunk(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool IFF_writeRawChunk(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
     const IFF_RawChunk *rawChunk = (const IFF_RawChunk*)chunk;
 
-    if(fwrite(rawChunk->chunkData, sizeof(IFF_UByte), rawChunk->chunkSize, file) < rawChunk->chunkSize)
+    if(stream->write(stream, rawChunk->chunkData, rawChunk->chunkSize) < rawChunk->chunkSize)
     {
+        IFF_recordError(IFF_ERROR_WRITE);
         IFF_error("Error writing raw chunk body of chunk '");
         IFF_errorId(rawChunk->chunkId);
         IFF_error("'\n");
@@ -109,7 +140,9 @@ IFF_Bool IFF_checkRawChunk(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chun
 void IFF_freeRawChunk(IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
 {
     IFF_RawChunk *rawChunk = (IFF_RawChunk*)chunk;
-    free(rawChunk->chunkData);
+
+    if(!rawChunk->chunkDataBorrowed)
+        IFF_deallocateIn(rawChunk->arena, rawChunk->chunkData);
 }
 
 void IFF_printText(const IFF_RawChunk *chunk, const unsigned int indentLevel)
@@ -28,6 +28,9 @@ typedef struct IFF_RawChunk IFF_RawChunk;
 
 #include <stdio.h>
 #include "ifftypes.h"
+#include "stream.h"
+#include "hash.h"
+#include "arena.h"
 #include "chunk.h"
 
 #ifdef __cplusplus
@@ -48,8 +51,20 @@ struct IFF_RawChunk
     /** Contains the size of the chunk data in bytes */
     IFF_Long chunkSize;
 
+    /** Refers to the chunk type that was resolved when the chunk was read, so that it does not have to be looked up again. NULL if it should be looked up in the registry */
+    IFF_ChunkType *chunkType;
+
+    /** Caches the content hash that has been computed by IFF_hashChunk(). Both halves are 0 if it has not been computed, or if it has been invalidated by a modification */
+    IFF_Hash hash;
+
+    /** Refers to the arena from which the chunk has been allocated, or NULL if it has been allocated from the heap. The memory that belongs to the chunk is allocated from the same arena */
+    IFF_Arena *arena;
+
     /** An array of bytes representing raw chunk data */
     IFF_UByte *chunkData;
+
+    /** Indicates whether the chunk data is borrowed from a memory block owned by somebody else (TRUE), so that it is not freed along with the chunk */
+    IFF_Bool chunkDataBorrowed;
 };
 
 /**
@@ -61,6 +76,19 @@ struct IFF_RawChunk
  */
 IFF_Chunk *IFF_createRawChunk(const IFF_ID chunkId, const IFF_Long chunkSize);
 
+/**
+ * Creates a raw chunk with the given chunk ID and size whose data refers to
+ * the given memory block, instead of a copy of it. The memory block must remain
+ * valid and unmodified as long as the chunk exists. The resulting chunk must be
+ * freed using IFF_free(), which leaves the memory block untouched.
+ *
+ * @param chunkId A 4 character id
+ * @param chunkSize Length of the bytes array.
+ * @param chunkData An array of bytes that is at least as big as the chunk size
+ * @return A raw chunk with the given chunk Id, or NULL if the memory can't be allocated
+ */
+IFF_Chunk *IFF_createBorrowedRawChunk(const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_UByte *chunkData);
+
 /**
  * Copies the given data array to the chunk data
  *
@@ -70,7 +98,11 @@ IFF_Chunk *IFF_createRawChunk(const IFF_ID chunkId, const IFF_Long chunkSize);
 void IFF_copyDataToRawChunkData(IFF_RawChunk *rawChunk, IFF_UByte *data);
 
 /**
- * Attaches chunk data to a given chunk. It also increments the chunk size.
+ * Attaches chunk data to a given chunk. It also changes the chunk size and the
+ * chunk sizes of the group chunks in which the chunk is located. The chunk data
+ * is freed along with the chunk, so it must have been allocated from the arena
+ * of the chunk with IFF_allocateIn(), which is the heap if the chunk has not
+ * been allocated from an arena.
  *
  * @param rawChunk A raw chunk
  * @param chunkData An array of bytes
@@ -78,6 +110,19 @@ void IFF_copyDataToRawChunkData(IFF_RawChunk *rawChunk, IFF_UByte *data);
  */
 void IFF_setRawChunkData(IFF_RawChunk *rawChunk, IFF_UByte *chunkData, IFF_Long chunkSize);
 
+/**
+ * Makes the chunk data of a given chunk refer to a memory block that is owned
+ * by somebody else. In contrast to IFF_setRawChunkData(), the memory block is not
+ * freed along with the chunk, so it must remain valid as long as the chunk exists.
+ * It also changes the chunk size and the chunk sizes of the group chunks in which
+ * the chunk is located.
+ *
+ * @param rawChunk A raw chunk
+ * @param chunkData An array of bytes
+ * @param chunkSize Length of the bytes array.
+ */
+void IFF_borrowRawChunkData(IFF_RawChunk *rawChunk, const IFF_UByte *chunkData, IFF_Long chunkSize);
+
 /**
  * Copies the given string into the data of the chunk. Additionally, it makes
  * the chunk size equal to the given string.
@@ -88,26 +133,26 @@ void IFF_setRawChunkData(IFF_RawChunk *rawChunk, IFF_UByte *chunkData, IFF_Long
 void IFF_setTextData(IFF_RawChunk *rawChunk, const char *text);
 
 /**
- * Reads a raw chunk with the given chunk id and chunk size from a file.
+ * Reads a raw chunk with the given chunk id and chunk size from a stream.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk A raw chunk instance
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the chunk has been successfully read, else FALSE
  */
-IFF_Bool IFF_readRawChunk(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_readRawChunk(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
- * Writes the given raw chunk to a file descriptor.
+ * Writes the given raw chunk to a stream.
  *
- * @param file File descriptor of the file
+ * @param stream An I/O stream
  * @param chunk A raw chunk instance
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
  * @param bytesProcessed Indicates how many bytes in the chunk body were processed
  * @return TRUE if the chunk has been successfully written, else FALSE
  */
-IFF_Bool IFF_writeRawChunk(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool IFF_writeRawChunk(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 /**
  * Checks the given raw chunk
@@ -119,7 +164,7 @@ IFF_Bool IFF_writeRawChunk(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRe
 IFF_Bool IFF_checkRawChunk(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry);
 
 /**
- * Frees the raw chunk data of the given raw chunk.
+ * Frees the raw chunk data of the given raw chunk, unless it has been borrowed.
  *
  * @param chunk A raw chunk instance
  * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_STREAM_H
+#define __IFF_STREAM_H
+
+typedef struct IFF_IOStream IFF_IOStream;
+
+#include <stdio.h>
+#include <stddef.h>
+#include "ifftypes.h"
+#include "stream.h"
+
+/**
+ * @brief An abstract stream from which IFF data can be read and to which it can be written.
+ *
+ * Concrete streams, such as IFF_FileIOStream, IFF_FdIOStream and IFF_MemoryIOStream,
+ * start with the same members so that they can be used as an IFF_IOStream. Custom
+ * streams can be created in the same way, and should set sparse to FALSE unless
+ * they are known to support holes.
+ */
+struct IFF_IOStream
+{
+    /** Function responsible for reading the given amount of bytes into a buffer. It returns the amount of bytes that were read, which is smaller than the requested size if an error occurs or the end of the stream has been reached */
+    size_t (*read) (IFF_IOStream *stream, void *buffer, const size_t size);
+
+    /** Function responsible for writing the given amount of bytes from a buffer. It returns the amount of bytes that were written, which is smaller than the requested size if an error occurs */
+    size_t (*write) (IFF_IOStream *stream, const void *buffer, const size_t size);
+
+    /** Function responsible for moving the position of the stream by an offset relative to an origin: SEEK_SET, SEEK_CUR or SEEK_END. It returns TRUE if the position has been changed, or FALSE if an error occurs or the stream is not seekable */
+    IFF_Bool (*seek) (IFF_IOStream *stream, const long offset, const int origin);
+
+    /** Function responsible for returning the current position of the stream, or -1 if it cannot be determined */
+    long (*tell) (IFF_IOStream *stream);
+
+    /** Indicates whether seeking beyond the end of the stream and writing there leaves a hole that reads as zeros (TRUE). This is not the case for files that are opened in append mode, since every write then goes to the end of the file */
+    IFF_Bool sparse;
+};
+
+#endif
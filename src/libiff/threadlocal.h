@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_THREADLOCAL_H
+#define __IFF_THREADLOCAL_H
+
+/*
+ * Storage class of the state that each thread selects for itself, such as the
+ * selected arena and context. IFF_HAVE_THREAD_LOCAL is 0 if the compiler does
+ * not support thread local storage, in which case all threads share that state.
+ */
+#if HAVE_THREAD_LOCAL == 1
+#define IFF_THREAD_LOCAL __thread
+#define IFF_HAVE_THREAD_LOCAL 1
+#elif defined(_MSC_VER)
+#define IFF_THREAD_LOCAL __declspec(thread)
+#define IFF_HAVE_THREAD_LOCAL 1
+#else
+#define IFF_THREAD_LOCAL
+#define IFF_HAVE_THREAD_LOCAL 0
+#endif
+
+#endif
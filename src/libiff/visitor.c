@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "visitor.h"
+#include "io.h"
+#include "id.h"
+#include "group.h"
+#include "form.h"
+#include "cat.h"
+#include "list.h"
+#include "prop.h"
+#include "error.h"
+#include "context.h"
+
+#define ID_EMPTY IFF_MAKEID(' ', ' ', ' ', ' ')
+
+static IFF_Bool isGroupChunk(const IFF_ID chunkId)
+{
+    return chunkId == IFF_ID_FORM || chunkId == IFF_ID_CAT || chunkId == IFF_ID_LIST || chunkId == IFF_ID_PROP;
+}
+
+static IFF_VisitAction determineAction(const IFF_Visitor *visitor, void *data, const IFF_ID formType, const IFF_ID chunkId, const IFF_Long chunkSize)
+{
+    if(visitor->visitChunkHeader != NULL)
+        return visitor->visitChunkHeader(data, formType, chunkId, chunkSize);
+    else if(isGroupChunk(chunkId))
+        return IFF_VISIT_DESCEND;
+    else if(visitor->visitChunk != NULL)
+        return IFF_VISIT_READ;
+    else
+        return IFF_VISIT_SKIP;
+}
+
+static IFF_Bool skipChunkBody(IFF_IOStream *stream, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_Long bytesProcessed)
+{
+    /* Skip the remainder of the body including the padding byte */
+    long bytesToSkip = chunkSize - bytesProcessed + (chunkSize % 2);
+
+    if(bytesToSkip > 0 && !IFF_skipBytes(stream, bytesToSkip))
+    {
+        IFF_recordError(IFF_ERROR_READ);
+        IFF_error("Cannot skip the body of chunk: '");
+        IFF_errorId(chunkId);
+        IFF_error("'\n");
+        return FALSE;
+    }
+    else
+        return TRUE;
+}
+
+static IFF_FieldStatus visitChunk(IFF_IOStream *stream, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Visitor *visitor, void *data, IFF_Long *bytesProcessed);
+
+static IFF_FieldStatus visitSubChunks(IFF_IOStream *stream, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ID groupType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Visitor *visitor, void *data, IFF_Long *bytesProcessed)
+{
+    while(*bytesProcessed < chunkSize)
+    {
+        IFF_FieldStatus status;
+
+        if((status = visitChunk(stream, groupType, chunkRegistry, visitor, data, bytesProcessed)) != IFF_FIELD_MORE)
+            return status;
+    }
+
+    if(*bytesProcessed > chunkSize)
+        IFF_error("WARNING: truncated group chunk! The size specifies: %d but the total amount of its sub chunks is: %d bytes. The parser may get confused!\n", chunkSize, *bytesProcessed);
+
+    return IFF_FIELD_MORE;
+}
+
+static IFF_FieldStatus visitGroup(IFF_IOStream *stream, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ChunkRegistry *chunkRegistry, const IFF_Visitor *visitor, void *data)
+{
+    IFF_ID groupType = 0;
+    IFF_Long bytesProcessed = 0;
+    IFF_VisitAction action;
+    IFF_FieldStatus status;
+
+    /* A group that is too small for a group type has no type and no sub chunks, like IFF_readCheckedGroup() reads it. Its body must not be read beyond its size */
+    if(chunkSize < IFF_ID_SIZE)
+    {
+        IFF_error("WARNING: group chunk: '");
+        IFF_errorId(chunkId);
+        IFF_error("' with size: %d is too small to contain a group type!\n", chunkSize);
+    }
+    else if(IFF_readId(stream, &groupType, chunkId, chunkId == IFF_ID_FORM || chunkId == IFF_ID_PROP ? "formType" : "contentsType"))
+        bytesProcessed = IFF_ID_SIZE;
+    else
+        return IFF_FIELD_FAILURE;
+
+    action = visitor->beginGroup == NULL ? IFF_VISIT_DESCEND : visitor->beginGroup(data, chunkId, chunkSize, groupType);
+
+    if(action == IFF_VISIT_STOP)
+        return IFF_FIELD_LAST;
+    else if(action != IFF_VISIT_SKIP)
+    {
+        if(bytesProcessed > 0 && (status = visitSubChunks(stream, chunkId, chunkSize, groupType, chunkRegistry, visitor, data, &bytesProcessed)) != IFF_FIELD_MORE)
+            return status;
+
+        if(visitor->endGroup != NULL && !visitor->endGroup(data, chunkId, groupType))
+            return IFF_FIELD_LAST;
+    }
+
+    if(!skipChunkBody(stream, chunkId, chunkSize, bytesProcessed))
+        return IFF_FIELD_FAILURE;
+
+    return IFF_FIELD_MORE;
+}
+
+static IFF_FieldStatus visitChunkBody(IFF_IOStream *stream, const IFF_ID formType, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ChunkRegistry *chunkRegistry, const IFF_Visitor *visitor, void *data)
+{
+    IFF_Chunk *chunk = IFF_readChunkBody(stream, chunkId, chunkSize, formType, chunkRegistry);
+    IFF_Bool proceed;
+
+    if(chunk == NULL)
+        return IFF_FIELD_FAILURE;
+
+    proceed = visitor->visitChunk == NULL || visitor->visitChunk(data, formType, chunk);
+    IFF_freeChunk(chunk, formType, chunkRegistry);
+
+    return proceed ? IFF_FIELD_MORE : IFF_FIELD_LAST;
+}
+
+static IFF_FieldStatus visitChunk(IFF_IOStream *stream, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Visitor *visitor, void *data, IFF_Long *bytesProcessed)
+{
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+
+    if(!IFF_readId(stream, &chunkId, ID_EMPTY, "")
+        || !IFF_readLong(stream, &chunkSize, chunkId, "chunkSize"))
+        return IFF_FIELD_FAILURE;
+
+    /* Account for the chunk header, body and padding byte, so that the enclosing group knows when it ends */
+    *bytesProcessed = *bytesProcessed + sizeof(IFF_ID) + sizeof(IFF_Long) + chunkSize + (chunkSize % 2);
+
+    switch(determineAction(visitor, data, formType, chunkId, chunkSize))
+    {
+        case IFF_VISIT_SKIP:
+            return skipChunkBody(stream, chunkId, chunkSize, 0) ? IFF_FIELD_MORE : IFF_FIELD_FAILURE;
+        case IFF_VISIT_DESCEND:
+            if(isGroupChunk(chunkId))
+                return visitGroup(stream, chunkId, chunkSize, chunkRegistry, visitor, data);
+            else
+                return visitChunkBody(stream, formType, chunkId, chunkSize, chunkRegistry, visitor, data);
+        case IFF_VISIT_READ:
+            return visitChunkBody(stream, formType, chunkId, chunkSize, chunkRegistry, visitor, data);
+        default:
+            return IFF_FIELD_LAST;
+    }
+}
+
+IFF_FieldStatus IFF_visitChunk(IFF_IOStream *stream, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Visitor *visitor, void *data)
+{
+    IFF_Long bytesProcessed = 0;
+    return visitChunk(stream, formType, chunkRegistry, visitor, data, &bytesProcessed);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_VISITOR_H
+#define __IFF_VISITOR_H
+
+typedef struct IFF_Visitor IFF_Visitor;
+
+#include "ifftypes.h"
+#include "stream.h"
+#include "chunk.h"
+#include "chunkregistry.h"
+#include "field.h"
+
+/**
+ * @brief Determines what happens with a chunk that has been encountered by a visitor
+ */
+typedef enum
+{
+    /** Skips the chunk body, by seeking beyond it */
+    IFF_VISIT_SKIP = 0,
+
+    /** Reads the chunk with its chunk type and passes it to the visitChunk() callback */
+    IFF_VISIT_READ = 1,
+
+    /** Visits the sub chunks of a group chunk. For other chunks, it has the same effect as IFF_VISIT_READ */
+    IFF_VISIT_DESCEND = 2,
+
+    /** Stops the traversal */
+    IFF_VISIT_STOP = 3
+}
+IFF_VisitAction;
+
+/**
+ * @brief A collection of callbacks that are invoked while traversing an IFF stream without building a chunk hierarchy. Each callback may be NULL.
+ */
+struct IFF_Visitor
+{
+    /**
+     * Function that is invoked for every chunk header and decides what happens
+     * with the chunk body. When it is NULL, group chunks are descended into, and
+     * other chunks are read if visitChunk() is provided, or skipped otherwise.
+     */
+    IFF_VisitAction (*visitChunkHeader) (void *data, const IFF_ID formType, const IFF_ID chunkId, const IFF_Long chunkSize);
+
+    /** Function that is invoked when a group chunk is descended into. It may return IFF_VISIT_SKIP to skip the sub chunks, or IFF_VISIT_STOP to stop the traversal */
+    IFF_VisitAction (*beginGroup) (void *data, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ID groupType);
+
+    /** Function that is invoked after all sub chunks of a group chunk have been visited. It returns FALSE to stop the traversal */
+    IFF_Bool (*endGroup) (void *data, const IFF_ID chunkId, const IFF_ID groupType);
+
+    /** Function that is invoked with a chunk that has been read. The chunk is freed after the function returns. It returns FALSE to stop the traversal */
+    IFF_Bool (*visitChunk) (void *data, const IFF_ID formType, const IFF_Chunk *chunk);
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Visits the next chunk in the given stream and, if requested, its sub chunks.
+ * Only the chunks that the visitor decides to read are kept in memory, until
+ * the visitChunk() callback returns, so that the memory usage is proportional
+ * to the nesting depth rather than the size of the stream.
+ *
+ * @param stream An I/O stream
+ * @param formType Form type id describing in which FORM the sub chunk is located. 0 is used for sub chunks in other group chunks.
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType
+ * @param visitor A visitor containing the callbacks that should be invoked
+ * @param data Arbitrary data that is passed to the callbacks of the visitor
+ * @return IFF_FIELD_MORE if the traversal should continue, IFF_FIELD_LAST if the visitor has stopped it, or IFF_FIELD_FAILURE if an error occurs
+ */
+IFF_FieldStatus IFF_visitChunk(IFF_IOStream *stream, const IFF_ID formType, const IFF_ChunkRegistry *chunkRegistry, const IFF_Visitor *visitor, void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "writer.h"
+#include <stdlib.h>
+#include "io.h"
+#include "id.h"
+#include "error.h"
+#include "defaultregistry.h"
+
+#define MAX_CHUNK_SIZE 0x7fffffffU
+#define CHUNK_HEADER_SIZE (IFF_ID_SIZE + sizeof(IFF_Long))
+#define INITIAL_BUFFER_SIZE 4096
+
+IFF_Writer *IFF_createWriter(IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry)
+{
+    IFF_Writer *writer = (IFF_Writer*)malloc(sizeof(IFF_Writer));
+
+    if(writer != NULL)
+    {
+        long position = stream->tell(stream);
+
+        writer->stream = stream;
+        writer->chunkRegistry = chunkRegistry == NULL ? &IFF_defaultChunkRegistry : chunkRegistry;
+        writer->seekable = position != -1 && stream->seek(stream, position, SEEK_SET);
+        writer->groupLength = 0;
+        writer->group = NULL;
+        writer->groupCapacity = 0;
+    }
+
+    return writer;
+}
+
+static IFF_IOStream *getOutputStream(IFF_Writer *writer)
+{
+    if(writer->seekable || writer->groupLength == 0)
+        return writer->stream;
+    else
+        return (IFF_IOStream*)&writer->buffer;
+}
+
+static IFF_Bool addToGroup(IFF_Writer *writer, const IFF_ID chunkId, const IFF_Long chunkSize)
+{
+    if(writer->groupLength == 0)
+        return TRUE;
+    else
+    {
+        IFF_WriterGroup *group = &writer->group[writer->groupLength - 1];
+        IFF_ULong size = CHUNK_HEADER_SIZE + (IFF_ULong)chunkSize + (chunkSize % 2); /* Sub chunks are padded to an even size */
+
+        if(size > MAX_CHUNK_SIZE - group->chunkSize)
+        {
+            IFF_error("Cannot add chunk: '");
+            IFF_errorId(chunkId);
+            IFF_error("', because the size of group: '");
+            IFF_errorId(group->chunkId);
+            IFF_error("' would exceed the maximum chunk size\n");
+            return FALSE;
+        }
+        else
+        {
+            group->chunkSize += size;
+            return TRUE;
+        }
+    }
+}
+
+static IFF_Bool pushGroup(IFF_Writer *writer, const IFF_ID chunkId, const IFF_ID groupType, const long sizePosition)
+{
+    IFF_WriterGroup *group;
+
+    if(writer->groupLength == writer->groupCapacity)
+    {
+        unsigned int groupCapacity = writer->groupCapacity == 0 ? 4 : writer->groupCapacity * 2;
+        IFF_WriterGroup *newGroup = (IFF_WriterGroup*)realloc(writer->group, groupCapacity * sizeof(IFF_WriterGroup));
+
+        if(newGroup == NULL)
+            return FALSE;
+
+        writer->group = newGroup;
+        writer->groupCapacity = groupCapacity;
+    }
+
+    group = &writer->group[writer->groupLength];
+    group->chunkId = chunkId;
+    group->groupType = groupType;
+    group->sizePosition = sizePosition;
+    group->chunkSize = IFF_ID_SIZE; /* The group type is part of the group body */
+    writer->groupLength++;
+
+    return TRUE;
+}
+
+IFF_Bool IFF_beginGroup(IFF_Writer *writer, const IFF_ID chunkId, const IFF_ID groupType)
+{
+    IFF_IOStream *stream;
+    long position;
+
+    /* If we cannot seek back, the outermost group is buffered in a stream that can */
+    if(!writer->seekable && writer->groupLength == 0)
+    {
+        if(!IFF_initGrowableMemoryIOStream(&writer->buffer, INITIAL_BUFFER_SIZE))
+            return FALSE;
+
+        stream = (IFF_IOStream*)&writer->buffer;
+    }
+    else
+        stream = getOutputStream(writer);
+
+    position = stream->tell(stream);
+
+    if(position != -1
+        && IFF_writeId(stream, chunkId, chunkId, "chunkId")
+        && IFF_writeLong(stream, 0, chunkId, "chunkSize")
+        && IFF_writeId(stream, groupType, chunkId, "groupType")
+        && pushGroup(writer, chunkId, groupType, position + IFF_ID_SIZE))
+        return TRUE;
+    else
+    {
+        if(!writer->seekable && writer->groupLength == 0)
+            free(writer->buffer.data);
+
+        return FALSE;
+    }
+}
+
+static IFF_Bool patchGroupSize(IFF_IOStream *stream, const IFF_WriterGroup *group)
+{
+    long position = stream->tell(stream);
+
+    if(position != -1
+        && stream->seek(stream, group->sizePosition, SEEK_SET)
+        && IFF_writeLong(stream, group->chunkSize, group->chunkId, "chunkSize")
+        && stream->seek(stream, position, SEEK_SET))
+        return TRUE;
+    else
+    {
+        IFF_error("Cannot patch the size of group: '");
+        IFF_errorId(group->chunkId);
+        IFF_error("'\n");
+        return FALSE;
+    }
+}
+
+static IFF_Bool flushBuffer(IFF_Writer *writer)
+{
+    size_t size = writer->buffer.position;
+    IFF_Bool status = writer->stream->write(writer->stream, writer->buffer.data, size) == size;
+
+    if(!status)
+        IFF_error("Cannot write the buffered group to the stream\n");
+
+    free(writer->buffer.data);
+    return status;
+}
+
+IFF_Bool IFF_endGroup(IFF_Writer *writer)
+{
+    if(writer->groupLength == 0)
+    {
+        IFF_error("There is no group that can be ended!\n");
+        return FALSE;
+    }
+    else
+    {
+        IFF_WriterGroup group = writer->group[writer->groupLength - 1];
+
+        if(!patchGroupSize(getOutputStream(writer), &group))
+            return FALSE;
+
+        writer->groupLength--;
+
+        if(!addToGroup(writer, group.chunkId, group.chunkSize))
+            return FALSE;
+
+        if(!writer->seekable && writer->groupLength == 0)
+            return flushBuffer(writer);
+        else
+            return TRUE;
+    }
+}
+
+IFF_Bool IFF_writeDataChunk(IFF_Writer *writer, const IFF_ID chunkId, const void *data, const IFF_Long chunkSize)
+{
+    IFF_IOStream *stream = getOutputStream(writer);
+
+    if(chunkSize < 0)
+    {
+        IFF_error("Cannot write chunk: '");
+        IFF_errorId(chunkId);
+        IFF_error("' with a negative size\n");
+        return FALSE;
+    }
+
+    if(!addToGroup(writer, chunkId, chunkSize))
+        return FALSE;
+
+    if(!IFF_writeId(stream, chunkId, chunkId, "chunkId")
+        || !IFF_writeLong(stream, chunkSize, chunkId, "chunkSize"))
+        return FALSE;
+
+    if(stream->write(stream, data, chunkSize) < (size_t)chunkSize)
+    {
+        IFF_error("Cannot write the body of chunk: '");
+        IFF_errorId(chunkId);
+        IFF_error("'\n");
+        return FALSE;
+    }
+
+    return IFF_writePaddingByte(stream, chunkSize, chunkId);
+}
+
+IFF_Bool IFF_writeChunkWithWriter(IFF_Writer *writer, const IFF_Chunk *chunk)
+{
+    IFF_ID formType;
+
+    if(writer->groupLength == 0)
+        formType = 0;
+    else
+        formType = writer->group[writer->groupLength - 1].groupType;
+
+    return addToGroup(writer, chunk->chunkId, chunk->chunkSize)
+        && IFF_writeChunk(getOutputStream(writer), chunk, formType, writer->chunkRegistry);
+}
+
+void IFF_freeWriter(IFF_Writer *writer)
+{
+    if(!writer->seekable && writer->groupLength > 0)
+        free(writer->buffer.data);
+
+    free(writer->group);
+    free(writer);
+}
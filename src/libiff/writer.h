@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_WRITER_H
+#define __IFF_WRITER_H
+
+typedef struct IFF_Writer IFF_Writer;
+typedef struct IFF_WriterGroup IFF_WriterGroup;
+
+#include "ifftypes.h"
+#include "stream.h"
+#include "memorystream.h"
+#include "chunk.h"
+#include "chunkregistry.h"
+
+/**
+ * @brief A group chunk that has been started by a writer, but not ended yet
+ */
+struct IFF_WriterGroup
+{
+    /** Chunk id of the group: FORM, CAT, LIST or PROP */
+    IFF_ID chunkId;
+
+    /** Form type or contents type of the group */
+    IFF_ID groupType;
+
+    /** Position of the size field of the group in the stream to which it is written */
+    long sizePosition;
+
+    /** Amount of bytes in the group body that have been written so far */
+    IFF_Long chunkSize;
+};
+
+/**
+ * @brief Writes an IFF file chunk by chunk, without building a chunk hierarchy.
+ *
+ * The sizes of group chunks are written as placeholders and patched when the
+ * group ends. On streams that cannot seek back, the outermost open group is
+ * buffered in memory until it ends.
+ */
+struct IFF_Writer
+{
+    /** The stream to which the IFF file is written */
+    IFF_IOStream *stream;
+
+    /** A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType */
+    const IFF_ChunkRegistry *chunkRegistry;
+
+    /** Indicates whether the sizes of groups can be patched in the stream itself */
+    IFF_Bool seekable;
+
+    /** Buffers the outermost open group if the stream is not seekable */
+    IFF_MemoryIOStream buffer;
+
+    /** Number of groups that have been started, but not ended yet */
+    unsigned int groupLength;
+
+    /** Stack of groups that have been started, but not ended yet */
+    IFF_WriterGroup *group;
+
+    /** Number of groups for which the stack has room */
+    unsigned int groupCapacity;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Creates a writer that writes an IFF file to the given stream.
+ *
+ * @param stream An I/O stream. If it is seekable, it must be positioned at the location where the IFF file starts.
+ * @param chunkRegistry A registry that determines how to handle a chunk of a certain type, optionally in the scope of a FORM with a certain formType, or NULL to use the default registry
+ * @return A writer that must be freed with IFF_freeWriter(), or NULL if the memory cannot be allocated
+ */
+IFF_Writer *IFF_createWriter(IFF_IOStream *stream, const IFF_ChunkRegistry *chunkRegistry);
+
+/**
+ * Starts a group chunk, by writing its header with a placeholder size. Until
+ * the group is ended with IFF_endGroup(), all written chunks become sub chunks
+ * of the group.
+ *
+ * @param writer A writer
+ * @param chunkId Chunk id of the group: FORM, CAT, LIST or PROP
+ * @param groupType Form type or contents type of the group
+ * @return TRUE if the group has been started, else FALSE
+ */
+IFF_Bool IFF_beginGroup(IFF_Writer *writer, const IFF_ID chunkId, const IFF_ID groupType);
+
+/**
+ * Ends the group chunk that has been started last, by patching its size.
+ * If the stream is not seekable and the outermost group ends, the buffered
+ * group is written to the stream.
+ *
+ * @param writer A writer
+ * @return TRUE if the group has been ended, else FALSE
+ */
+IFF_Bool IFF_endGroup(IFF_Writer *writer);
+
+/**
+ * Writes a data chunk with the given body, followed by a padding byte if the
+ * size is odd.
+ *
+ * @param writer A writer
+ * @param chunkId A 4 character chunk id
+ * @param data Body of the chunk
+ * @param chunkSize Size of the chunk body in bytes
+ * @return TRUE if the chunk has been written, else FALSE
+ */
+IFF_Bool IFF_writeDataChunk(IFF_Writer *writer, const IFF_ID chunkId, const void *data, const IFF_Long chunkSize);
+
+/**
+ * Writes a chunk instance, such as an application chunk, in the scope of the
+ * group that has been started last. The chunk sizes of the chunk must be
+ * correct, e.g. by invoking IFF_updateChunkSizes() first.
+ *
+ * @param writer A writer
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @return TRUE if the chunk has been written, else FALSE
+ */
+IFF_Bool IFF_writeChunkWithWriter(IFF_Writer *writer, const IFF_Chunk *chunk);
+
+/**
+ * Frees a writer. Groups that have not been ended are not completed.
+ *
+ * @param writer A writer
+ */
+void IFF_freeWriter(IFF_Writer *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
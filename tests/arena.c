@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <iff.h>
+#include <arena.h>
+#include <form.h>
+#include <rawchunk.h>
+#include <id.h>
+
+#define NUM_OF_ITERATIONS 3
+#define NUM_OF_ADDED_CHUNKS 40
+
+#define ID_BYTE IFF_MAKEID('B', 'Y', 'T', 'E')
+
+static IFF_Bool isAllocatedFromArena(const IFF_Arena *arena, const void *data)
+{
+    const IFF_ArenaSlab *slab;
+
+    for(slab = arena->slab; slab != NULL; slab = slab->next)
+    {
+        if((const IFF_UByte*)data >= slab->data && (const IFF_UByte*)data < slab->data + slab->used)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static int checkModifyArenaChunk(IFF_Arena *arena)
+{
+    IFF_Form *form = (IFF_Form*)IFF_readInArena("pp-text.TEST", NULL, arena);
+    IFF_Long chunkSize;
+    unsigned int i;
+
+    if(form == NULL)
+    {
+        fprintf(stderr, "Cannot read 'pp-text.TEST' into the arena!\n");
+        return 1;
+    }
+
+    chunkSize = form->chunkSize;
+
+    /* Add chunks after the read has finished, so that the sub chunk array must grow while another arena or none is selected */
+    for(i = 0; i < NUM_OF_ADDED_CHUNKS; i++)
+    {
+        IFF_Arena *previousArena = IFF_selectArena(arena);
+        IFF_Chunk *byteChunk = IFF_createRawChunk(ID_BYTE, 1);
+        IFF_selectArena(previousArena);
+
+        if(byteChunk == NULL)
+            return 1;
+
+        ((IFF_RawChunk*)byteChunk)->chunkData[0] = 'a';
+        IFF_addToForm(form, byteChunk);
+    }
+
+    if(!isAllocatedFromArena(arena, form->chunk))
+    {
+        fprintf(stderr, "The enlarged sub chunk array should have been allocated from the arena!\n");
+        return 1;
+    }
+
+    if(form->chunkSize != chunkSize + NUM_OF_ADDED_CHUNKS * 10)
+    {
+        fprintf(stderr, "The chunk size should be: %d, but it is: %d\n", chunkSize + NUM_OF_ADDED_CHUNKS * 10, form->chunkSize);
+        return 1;
+    }
+
+    if(!IFF_check((IFF_Chunk*)form, NULL))
+    {
+        fprintf(stderr, "The modified chunk should be valid!\n");
+        return 1;
+    }
+
+    IFF_resetArena(arena);
+    return 0;
+}
+
+static int checkModifyHeapChunk(IFF_Arena *arena)
+{
+    IFF_Form *form = (IFF_Form*)IFF_read("pp-text.TEST", NULL);
+    IFF_RawChunk *rawChunk;
+    IFF_Arena *previousArena;
+    int status = 0;
+
+    if(form == NULL)
+        return 1;
+
+    /* Memory that belongs to a chunk from the heap is allocated from the heap, even if an arena is selected */
+    previousArena = IFF_selectArena(arena);
+
+    rawChunk = (IFF_RawChunk*)form->chunk[0];
+    IFF_setTextData(rawChunk, "Hello world");
+
+    if(isAllocatedFromArena(arena, rawChunk->chunkData))
+    {
+        fprintf(stderr, "The text data should have been allocated from the heap!\n");
+        status = 1;
+    }
+
+    /* Freeing the chunk while the arena is selected should release its memory to the heap */
+    IFF_free((IFF_Chunk*)form, NULL);
+    IFF_selectArena(previousArena);
+
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filename = "lookupproperty-nested.TEST";
+    IFF_Chunk *chunk = IFF_read(filename, NULL);
+    IFF_Arena *arena = IFF_createArena(64); /* Use tiny slabs, so that multiple slabs are required */
+    int status = 0;
+    unsigned int i;
+
+    if(chunk == NULL || arena == NULL)
+        return 1;
+
+    /* Read the same file repeatedly and reset the arena in between */
+    for(i = 0; i < NUM_OF_ITERATIONS && status == 0; i++)
+    {
+        IFF_Chunk *arenaChunk = IFF_readInArena(filename, NULL, arena);
+
+        if(arenaChunk == NULL)
+        {
+            fprintf(stderr, "Cannot read '%s' into the arena!\n", filename);
+            status = 1;
+        }
+        else if(!isAllocatedFromArena(arena, arenaChunk))
+        {
+            fprintf(stderr, "The chunk should have been allocated from the arena!\n");
+            status = 1;
+        }
+        else if(!IFF_compare(chunk, arenaChunk, NULL))
+        {
+            fprintf(stderr, "The chunk read into the arena should be equal to the regular read!\n");
+            status = 1;
+        }
+
+        IFF_resetArena(arena);
+    }
+
+    if(status == 0)
+        status = checkModifyArenaChunk(arena);
+
+    if(status == 0)
+        status = checkModifyHeapChunk(arena);
+
+    IFF_freeArena(arena);
+    IFF_free(chunk, NULL);
+
+    return status;
+}
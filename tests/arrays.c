@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <io.h>
+#include <field.h>
+#include <chunk.h>
+#include <memorystream.h>
+#include <id.h>
+
+#define ID_ARRY IFF_MAKEID('A', 'R', 'R', 'Y')
+#define MAX_LENGTH 2100 /* Larger than the write buffer, to check writing in multiple blocks */
+
+static IFF_UWord uwords[MAX_LENGTH];
+static IFF_UWord readUWords[MAX_LENGTH];
+static IFF_Long longs[MAX_LENGTH];
+static IFF_Long readLongs[MAX_LENGTH];
+
+static void initValues(void)
+{
+    unsigned int i;
+
+    for(i = 0; i < MAX_LENGTH; i++)
+    {
+        uwords[i] = (IFF_UWord)(i * 0x0101 + 0x1234);
+        longs[i] = (IFF_Long)(i * 0x01010101U + 0x89abcdefU);
+    }
+}
+
+static int checkUWords(const size_t length)
+{
+    IFF_MemoryIOStream stream;
+    int status = 1;
+
+    IFF_initGrowableMemoryIOStream(&stream, 16);
+
+    if(!IFF_writeUWordArray((IFF_IOStream*)&stream, uwords, length, ID_ARRY, "uwords"))
+        fprintf(stderr, "Cannot write an array of %u words!\n", (unsigned int)length);
+    else
+    {
+        size_t i;
+
+        for(i = 0; i < length; i++)
+        {
+            if(stream.data[2 * i] != uwords[i] >> 8 || stream.data[2 * i + 1] != (uwords[i] & 0xff))
+            {
+                fprintf(stderr, "Word: %u of an array of %u words is not stored in big-endian order!\n", (unsigned int)i, (unsigned int)length);
+                break;
+            }
+        }
+
+        if(i == length)
+        {
+            IFF_initMemoryIOStream(&stream, stream.data, length * sizeof(IFF_UWord));
+
+            if(!IFF_readUWordArray((IFF_IOStream*)&stream, readUWords, length, ID_ARRY, "uwords"))
+                fprintf(stderr, "Cannot read an array of %u words!\n", (unsigned int)length);
+            else
+            {
+                for(i = 0; i < length; i++)
+                {
+                    if(readUWords[i] != uwords[i])
+                    {
+                        fprintf(stderr, "Word: %u of an array of %u words has not been read correctly!\n", (unsigned int)i, (unsigned int)length);
+                        break;
+                    }
+                }
+
+                if(i == length)
+                    status = 0;
+            }
+        }
+    }
+
+    free(stream.data);
+    return status;
+}
+
+static int checkLongs(const size_t length)
+{
+    IFF_MemoryIOStream stream;
+    int status = 1;
+
+    IFF_initGrowableMemoryIOStream(&stream, 16);
+
+    if(!IFF_writeLongArray((IFF_IOStream*)&stream, longs, length, ID_ARRY, "longs"))
+        fprintf(stderr, "Cannot write an array of %u longs!\n", (unsigned int)length);
+    else
+    {
+        size_t i;
+
+        for(i = 0; i < length; i++)
+        {
+            IFF_ULong value = (IFF_ULong)longs[i];
+
+            if(stream.data[4 * i] != value >> 24 || stream.data[4 * i + 1] != ((value >> 16) & 0xff)
+                || stream.data[4 * i + 2] != ((value >> 8) & 0xff) || stream.data[4 * i + 3] != (value & 0xff))
+            {
+                fprintf(stderr, "Long: %u of an array of %u longs is not stored in big-endian order!\n", (unsigned int)i, (unsigned int)length);
+                break;
+            }
+        }
+
+        if(i == length)
+        {
+            IFF_initMemoryIOStream(&stream, stream.data, length * sizeof(IFF_Long));
+
+            if(!IFF_readLongArray((IFF_IOStream*)&stream, readLongs, length, ID_ARRY, "longs"))
+                fprintf(stderr, "Cannot read an array of %u longs!\n", (unsigned int)length);
+            else
+            {
+                for(i = 0; i < length; i++)
+                {
+                    if(readLongs[i] != longs[i])
+                    {
+                        fprintf(stderr, "Long: %u of an array of %u longs has not been read correctly!\n", (unsigned int)i, (unsigned int)length);
+                        break;
+                    }
+                }
+
+                if(i == length)
+                    status = 0;
+            }
+        }
+    }
+
+    free(stream.data);
+    return status;
+}
+
+static int checkFields(void)
+{
+    IFF_Chunk chunk;
+    IFF_UByte data[8] = { 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0 };
+    IFF_MemoryIOStream stream;
+    IFF_Long bytesProcessed = 2;
+
+    chunk.chunkId = ID_ARRY;
+    chunk.chunkSize = 8;
+
+    IFF_initMemoryIOStream(&stream, data, sizeof(data));
+
+    /* The array does not fit in the remainder of the chunk */
+    if(IFF_readUWordArrayField((IFF_IOStream*)&stream, readUWords, 4, &chunk, "uwords", &bytesProcessed) != IFF_FIELD_LAST || bytesProcessed != 2)
+    {
+        fprintf(stderr, "An array that does not fit in the chunk should not be read!\n");
+        return 1;
+    }
+
+    /* The array is longer than the whole chunk */
+    bytesProcessed = 0;
+
+    if(IFF_readUWordArrayField((IFF_IOStream*)&stream, readUWords, 5, &chunk, "uwords", &bytesProcessed) != IFF_FIELD_LAST || bytesProcessed != 0)
+    {
+        fprintf(stderr, "An array that is longer than the chunk should not be read!\n");
+        return 1;
+    }
+
+    /* The size of the array in bytes does not fit in a size_t and wraps to 0 */
+    if(IFF_readUWordArrayField((IFF_IOStream*)&stream, readUWords, (size_t)-1 / 2 + 1, &chunk, "uwords", &bytesProcessed) != IFF_FIELD_LAST || bytesProcessed != 0)
+    {
+        fprintf(stderr, "An array whose size in bytes overflows should not be read!\n");
+        return 1;
+    }
+
+    bytesProcessed = 2;
+
+    if(IFF_readUWordArrayField((IFF_IOStream*)&stream, readUWords, 3, &chunk, "uwords", &bytesProcessed) != IFF_FIELD_MORE || bytesProcessed != 8)
+    {
+        fprintf(stderr, "An array that fits in the chunk should be read!\n");
+        return 1;
+    }
+
+    if(readUWords[0] != 0x1234 || readUWords[1] != 0x5678 || readUWords[2] != 0x9abc)
+    {
+        fprintf(stderr, "The array field has not been read correctly!\n");
+        return 1;
+    }
+
+    /* The stream ends before the array does */
+    IFF_initMemoryIOStream(&stream, data, 6);
+    bytesProcessed = 0;
+
+    if(IFF_readLongArrayField((IFF_IOStream*)&stream, readLongs, 2, &chunk, "longs", &bytesProcessed) != IFF_FIELD_FAILURE)
+    {
+        fprintf(stderr, "Reading an array beyond the end of the stream should fail!\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t length;
+
+    initValues();
+
+    /* Cover the remainders of all vector widths */
+    for(length = 0; length <= 70; length++)
+    {
+        if(checkUWords(length) != 0 || checkLongs(length) != 0)
+            return 1;
+    }
+
+    if(checkUWords(MAX_LENGTH) != 0 || checkLongs(MAX_LENGTH) != 0)
+        return 1;
+
+    return checkFields();
+}
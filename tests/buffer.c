@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <memorystream.h>
+#include "test.h"
+#include "extensiondata.h"
+
+static int checkGrowableStream(const IFF_Chunk *chunk, const IFF_UByte *data, const size_t size)
+{
+    IFF_MemoryIOStream stream;
+    int status;
+
+    /* Start with a tiny memory block, so that it must be enlarged a number of times */
+    if(!IFF_initGrowableMemoryIOStream(&stream, 1))
+        return 1;
+
+    if(!TEST_writeStream((IFF_IOStream*)&stream, chunk))
+    {
+        fprintf(stderr, "Cannot write the chunk to a growable memory stream!\n");
+        status = 1;
+    }
+    else if(stream.position != size || memcmp(stream.data, data, size) != 0)
+    {
+        fprintf(stderr, "The growable memory stream should contain the same data as the buffer!\n");
+        status = 1;
+    }
+    else
+        status = 0;
+
+    free(stream.data);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Form *form = IFF_createTestForm();
+    IFF_UByte *data;
+    size_t size;
+    int status;
+
+    if(!TEST_writeBuffer((IFF_Chunk*)form, &data, &size))
+    {
+        fprintf(stderr, "Cannot write the chunk to a buffer!\n");
+        status = 1;
+    }
+    else
+    {
+        IFF_Chunk *chunk;
+
+        if(size != form->chunkSize + 8)
+        {
+            fprintf(stderr, "The buffer size should be: %d, but it is: %u\n", form->chunkSize + 8, (unsigned int)size);
+            status = 1;
+        }
+        else if((chunk = TEST_readBuffer(data, size)) == NULL)
+        {
+            fprintf(stderr, "Cannot read the chunk from the buffer!\n");
+            status = 1;
+        }
+        else
+        {
+            if(!TEST_compare((IFF_Chunk*)form, chunk))
+            {
+                fprintf(stderr, "The chunk read from the buffer should be equal to the original!\n");
+                status = 1;
+            }
+            else
+                status = checkGrowableStream((IFF_Chunk*)form, data, size);
+
+            TEST_free(chunk);
+        }
+
+        free(data);
+    }
+
+    TEST_free((IFF_Chunk*)form);
+    return status;
+}
@@ -21,84 +21,22 @@
 
 #include "bye.h"
 #include <stdlib.h>
-#include <field.h>
-#include <error.h>
-#include <util.h>
+#include <stddef.h>
+#include <descriptor.h>
 #include "test.h"
 
-IFF_Chunk *TEST_createByeChunk(const IFF_ID chunkId, const IFF_Long chunkSize)
-{
-    TEST_Bye *bye = (TEST_Bye*)IFF_createChunk(chunkId, chunkSize, sizeof(TEST_Bye));
+static const IFF_FieldDescriptor byeFieldDescriptors[] = {
+    { IFF_FIELD_TYPE_LONG, offsetof(TEST_Bye, one), "one" },
+    { IFF_FIELD_TYPE_LONG, offsetof(TEST_Bye, two), "two" }
+};
 
-    if(bye != NULL)
-    {
-        bye->one = 0;
-        bye->two = 0;
-    }
+static const IFF_ChunkDescriptor byeChunkDescriptor = {
+    sizeof(TEST_Bye), 2, byeFieldDescriptors, NULL
+};
 
-    return (IFF_Chunk*)bye;
-}
+IFF_DEFINE_DESCRIBED_CHUNK_FUNCTIONS(TEST_, Bye, byeChunkDescriptor)
 
 TEST_Bye *TEST_createBye(const IFF_Long chunkSize)
 {
     return (TEST_Bye*)TEST_createByeChunk(TEST_ID_BYE, chunkSize);
 }
-
-IFF_Bool TEST_readBye(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
-{
-    TEST_Bye *bye = (TEST_Bye*)chunk;
-    IFF_FieldStatus status;
-
-    if((status = IFF_readLongField(file, &bye->one, chunk, "one", bytesProcessed)) != IFF_FIELD_MORE)
-        return IFF_deriveSuccess(status);
-
-    if((status = IFF_readLongField(file, &bye->two, chunk, "two", bytesProcessed)) != IFF_FIELD_MORE)
-        return IFF_deriveSuccess(status);
-
-    return TRUE;
-}
-
-IFF_Bool TEST_writeBye(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
-{
-    const TEST_Bye *bye = (const TEST_Bye*)chunk;
-    IFF_FieldStatus status;
-
-    if((status = IFF_writeLongField(file, bye->one, chunk, "one", bytesProcessed)) != IFF_FIELD_MORE)
-        return IFF_deriveSuccess(status);
-
-    if((status = IFF_writeLongField(file, bye->two, chunk, "two", bytesProcessed)) != IFF_FIELD_MORE)
-        return IFF_deriveSuccess(status);
-
-    return TRUE;
-}
-
-IFF_Bool TEST_checkBye(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
-{
-    return TRUE;
-}
-
-void TEST_freeBye(IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry)
-{
-}
-
-void TEST_printBye(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF_ChunkRegistry *chunkRegistry)
-{
-    const TEST_Bye *bye = (const TEST_Bye*)chunk;
-
-    IFF_printIndent(stdout, indentLevel, "one = %d;\n", bye->one);
-    IFF_printIndent(stdout, indentLevel, "two = %d;\n", bye->two);
-}
-
-IFF_Bool TEST_compareBye(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_ChunkRegistry *chunkRegistry)
-{
-    const TEST_Bye *bye1 = (const TEST_Bye*)chunk1;
-    const TEST_Bye *bye2 = (const TEST_Bye*)chunk2;
-
-    if(bye1->one != bye2->one)
-        return FALSE;
-
-    if(bye1->two != bye2->two)
-        return FALSE;
-
-    return TRUE;
-}
@@ -24,6 +24,7 @@
 
 #include <ifftypes.h>
 #include <chunk.h>
+#include <stream.h>
 #include <stdio.h>
 #include <id.h>
 
@@ -36,6 +37,9 @@ typedef struct
 
     IFF_ID chunkId;
     IFF_Long chunkSize;
+    IFF_ChunkType *chunkType;
+    IFF_Hash hash;
+    IFF_Arena *arena;
 
     IFF_Long one;
     IFF_Long two;
@@ -46,9 +50,9 @@ IFF_Chunk *TEST_createByeChunk(const IFF_ID chunkId, const IFF_Long chunkSize);
 
 TEST_Bye *TEST_createBye(const IFF_Long chunkSize);
 
-IFF_Bool TEST_readBye(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool TEST_readBye(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
-IFF_Bool TEST_writeBye(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool TEST_writeBye(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 IFF_Bool TEST_checkBye(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry);
 
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "iff.h"
+#include "context.h"
+#include "error.h"
+#include "form.h"
+#include "cat.h"
+#include "list.h"
+#include "prop.h"
+#include "rawchunk.h"
+#include "id.h"
+
+#define ID_ABCD IFF_MAKEID('A', 'B', 'C', 'D')
+#define ID_TEST IFF_MAKEID('T', 'E', 'S', 'T')
+
+#define NUM_OF_FORMS 200
+#define MAX_MESSAGES_LENGTH 4096
+
+static char messages[MAX_MESSAGES_LENGTH];
+static size_t messagesLength = 0;
+
+static void collectMessage(const char *formatString, va_list ap)
+{
+    int length = vsnprintf(messages + messagesLength, MAX_MESSAGES_LENGTH - messagesLength, formatString, ap);
+
+    if(length > 0)
+    {
+        messagesLength += length;
+
+        if(messagesLength >= MAX_MESSAGES_LENGTH)
+            messagesLength = MAX_MESSAGES_LENGTH - 1;
+    }
+}
+
+static IFF_Form *createForm(void)
+{
+    IFF_RawChunk *rawChunk = (IFF_RawChunk*)IFF_createRawChunk(ID_ABCD, 4);
+    IFF_Form *form = IFF_createEmptyForm(ID_TEST);
+
+    memcpy(rawChunk->chunkData, "abcd", 4);
+    IFF_addToForm(form, (IFF_Chunk*)rawChunk);
+
+    return form;
+}
+
+static IFF_Chunk *createCAT(void)
+{
+    IFF_CAT *cat = IFF_createEmptyCAT();
+    IFF_List *list = IFF_createEmptyList();
+    IFF_CAT *nestedCAT = IFF_createEmptyCAT();
+    IFF_Prop *prop = IFF_createEmptyProp(ID_TEST);
+    IFF_RawChunk *rawChunk = (IFF_RawChunk*)IFF_createRawChunk(ID_ABCD, 4);
+    unsigned int i;
+
+    memcpy(rawChunk->chunkData, "efgh", 4);
+    IFF_addToProp(prop, (IFF_Chunk*)rawChunk);
+    IFF_addPropToList(list, prop);
+
+    for(i = 0; i < NUM_OF_FORMS; i++)
+    {
+        if(i % 3 == 0)
+            IFF_addToList(list, (IFF_Chunk*)createForm());
+        else if(i % 3 == 1)
+            IFF_addToCATAndUpdateContentsType(nestedCAT, (IFF_Chunk*)createForm());
+        else
+            IFF_addToCAT(cat, (IFF_Chunk*)createForm());
+    }
+
+    IFF_addToCAT(cat, (IFF_Chunk*)list);
+    IFF_addToCAT(cat, (IFF_Chunk*)nestedCAT);
+
+    return (IFF_Chunk*)cat;
+}
+
+static int compareChecks(const IFF_Chunk *chunk, const unsigned int numOfThreads, const IFF_Bool expectedStatus)
+{
+    char sequentialMessages[MAX_MESSAGES_LENGTH];
+    IFF_Context sequentialContext, parallelContext;
+    IFF_Bool sequentialStatus, parallelStatus;
+    unsigned int i;
+
+    /* Check the hierarchy sequentially */
+    IFF_initContext(&sequentialContext);
+    messagesLength = 0;
+    messages[0] = '\0';
+
+    sequentialStatus = IFF_check(chunk, NULL);
+    strcpy(sequentialMessages, messages);
+
+    IFF_selectContext(&sequentialContext);
+    IFF_check(chunk, NULL);
+    IFF_selectContext(NULL);
+
+    /* Check the hierarchy in parallel */
+    messagesLength = 0;
+    messages[0] = '\0';
+
+    parallelStatus = IFF_checkParallel(chunk, NULL, numOfThreads);
+
+    IFF_initContext(&parallelContext);
+    IFF_selectContext(&parallelContext);
+    IFF_checkParallel(chunk, NULL, numOfThreads);
+    IFF_selectContext(NULL);
+
+    if(sequentialStatus != expectedStatus)
+    {
+        fprintf(stderr, "The sequential check should return: %d\n", expectedStatus);
+        return 1;
+    }
+
+    if(parallelStatus != sequentialStatus)
+    {
+        fprintf(stderr, "The parallel check with: %u threads should return the same verdict as the sequential check!\n", numOfThreads);
+        return 1;
+    }
+
+    if(strcmp(messages, sequentialMessages) != 0)
+    {
+        fprintf(stderr, "The parallel check with: %u threads should report the same messages as the sequential check!\nSequential:\n%sParallel:\n%s", numOfThreads, sequentialMessages, messages);
+        return 1;
+    }
+
+    if(parallelContext.errorCode != sequentialContext.errorCode || parallelContext.chunkPathLength != sequentialContext.chunkPathLength)
+    {
+        fprintf(stderr, "The parallel check with: %u threads should record the same error as the sequential check!\n", numOfThreads);
+        return 1;
+    }
+
+    for(i = 0; i < sequentialContext.chunkPathLength; i++)
+    {
+        if(parallelContext.chunkPath[i] != sequentialContext.chunkPath[i])
+        {
+            fprintf(stderr, "Element: %u of the chunk path should be the same as the sequential check!\n", i);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Chunk *chunk = createCAT();
+    IFF_CAT *cat = (IFF_CAT*)chunk;
+    IFF_Form *invalidForm, *mismatchingForm;
+    int status = 0;
+
+    IFF_errorCallback = &collectMessage;
+
+    status |= compareChecks(chunk, 1, TRUE);
+    status |= compareChecks(chunk, 4, TRUE);
+
+    /* Make the ID of a chunk in a form and the size of a later form in the nested LIST invalid */
+    invalidForm = (IFF_Form*)cat->chunk[40];
+    mismatchingForm = (IFF_Form*)((IFF_List*)cat->chunk[cat->chunkLength - 2])->chunk[10];
+
+    invalidForm->chunk[0]->chunkId = IFF_MAKEID('A', 'B', 1, 'D');
+    mismatchingForm->chunkSize += 2;
+
+    status |= compareChecks(chunk, 1, FALSE);
+    status |= compareChecks(chunk, 4, FALSE);
+
+    /* Only the size of the later form is invalid now */
+    invalidForm->chunk[0]->chunkId = ID_ABCD;
+
+    status |= compareChecks(chunk, 4, FALSE);
+
+    mismatchingForm->chunkSize -= 2;
+
+    IFF_free(chunk, NULL);
+
+    return status;
+}
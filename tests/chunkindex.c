@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "iff.h"
+#include "group.h"
+#include "form.h"
+#include "rawchunk.h"
+#include "id.h"
+
+#define NUM_OF_CHUNKS 100
+#define NUM_OF_IDS 40
+
+#define ID_ABCD IFF_MAKEID('A', 'B', 'C', 'D')
+#define ID_EFGH IFF_MAKEID('E', 'F', 'G', 'H')
+#define ID_IJKL IFF_MAKEID('I', 'J', 'K', 'L')
+#define ID_MNOP IFF_MAKEID('M', 'N', 'O', 'P')
+#define ID_TEST IFF_MAKEID('T', 'E', 'S', 'T')
+
+static IFF_Chunk *createNumberedChunk(const IFF_ID chunkId, const unsigned int number)
+{
+    IFF_RawChunk *rawChunk = (IFF_RawChunk*)IFF_createRawChunk(chunkId, 1);
+    rawChunk->chunkData[0] = number;
+    return (IFF_Chunk*)rawChunk;
+}
+
+/* Checks that the iterator visits the chunks with the given chunk ID in the same order as a linear scan */
+static int checkIterator(const IFF_Form *form, const IFF_ID chunkId)
+{
+    IFF_ChunkIterator iterator;
+    IFF_Chunk *chunk;
+    unsigned int i = 0;
+
+    IFF_iterateChunksInForm(&iterator, form, chunkId);
+
+    while((chunk = IFF_nextChunkInForm(&iterator)) != NULL)
+    {
+        while(i < form->chunkLength && form->chunk[i]->chunkId != chunkId)
+            i++;
+
+        if(i == form->chunkLength || chunk != form->chunk[i])
+        {
+            fprintf(stderr, "The iterator returns a chunk that does not match the sub chunks of the form!\n");
+            return 1;
+        }
+
+        i++;
+    }
+
+    /* There should be no remaining matching sub chunks */
+    while(i < form->chunkLength)
+    {
+        if(form->chunk[i]->chunkId == chunkId)
+        {
+            fprintf(stderr, "The iterator skips a sub chunk of the form!\n");
+            return 1;
+        }
+
+        i++;
+    }
+
+    return 0;
+}
+
+static int checkChunks(const IFF_Form *form, const char *situation)
+{
+    int status = checkIterator(form, ID_ABCD) | checkIterator(form, ID_EFGH) | checkIterator(form, ID_IJKL) | checkIterator(form, ID_MNOP);
+
+    if(status != 0)
+        fprintf(stderr, "The lookups are inconsistent %s\n", situation);
+
+    return status;
+}
+
+/* Forms that are read are indexed while their sub chunks are attached */
+static int checkReadForm(const IFF_Form *form)
+{
+    IFF_UByte *data;
+    size_t size;
+    IFF_Form *readForm;
+    int status;
+
+    if(!IFF_writeBuffer((const IFF_Chunk*)form, &data, &size, NULL))
+    {
+        fprintf(stderr, "Cannot write the form!\n");
+        return 1;
+    }
+
+    if((readForm = (IFF_Form*)IFF_readBuffer(data, size, NULL)) == NULL)
+    {
+        fprintf(stderr, "Cannot read the form!\n");
+        free(data);
+        return 1;
+    }
+
+    if(readForm->chunkIndex == NULL)
+    {
+        fprintf(stderr, "A form that has been read should be indexed!\n");
+        status = 1;
+    }
+    else
+        status = checkChunks(readForm, "in a form that has been read");
+
+    IFF_free((IFF_Chunk*)readForm, NULL);
+    free(data);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Form *form = IFF_createEmptyForm(ID_TEST);
+    IFF_RawChunk *rawChunk;
+    IFF_Chunk **chunks;
+    IFF_Chunk *chunk;
+    unsigned int i, chunksLength;
+    int status = 0;
+
+    /* A few chunks are not indexed */
+    IFF_addToForm(form, createNumberedChunk(ID_ABCD, 0));
+    IFF_addToForm(form, createNumberedChunk(ID_EFGH, 1));
+    status |= checkChunks(form, "in a small form");
+
+    if(form->chunkIndex != NULL)
+    {
+        fprintf(stderr, "A small form should not be indexed!\n");
+        status = 1;
+    }
+
+    for(i = 2; i < NUM_OF_CHUNKS; i++)
+        IFF_addToForm(form, createNumberedChunk(i % 3 == 0 ? ID_ABCD : ID_EFGH, i));
+
+    /* The index is built while attaching chunks, since lookups must not modify the form */
+    if(form->chunkIndex == NULL)
+    {
+        fprintf(stderr, "The form should be indexed before it is looked up!\n");
+        status = 1;
+    }
+
+    status |= checkChunks(form, "after indexing the form");
+
+    rawChunk = (IFF_RawChunk*)IFF_getDataChunkFromForm(form, ID_EFGH);
+
+    if(rawChunk == NULL || rawChunk->chunkData[0] != 1)
+    {
+        fprintf(stderr, "The first EFGH chunk should be retrieved!\n");
+        status = 1;
+    }
+
+    if(IFF_getDataChunkFromForm(form, ID_IJKL) != NULL)
+    {
+        fprintf(stderr, "No IJKL chunk should be found!\n");
+        status = 1;
+    }
+
+    chunks = IFF_getChunksFromForm(form, ID_ABCD, &chunksLength);
+
+    if(chunksLength != (NUM_OF_CHUNKS + 2) / 3)
+    {
+        fprintf(stderr, "The amount of ABCD chunks should be: %u, but it is: %u\n", (NUM_OF_CHUNKS + 2) / 3, chunksLength);
+        status = 1;
+    }
+
+    free(chunks);
+
+    /* Attaching chunks updates the index */
+    IFF_addToForm(form, createNumberedChunk(ID_IJKL, NUM_OF_CHUNKS));
+    IFF_addToForm(form, createNumberedChunk(ID_ABCD, NUM_OF_CHUNKS + 1));
+    status |= checkChunks(form, "after adding chunks");
+
+    /* Attaching chunks with many different chunk IDs enlarges the index */
+    for(i = 0; i < NUM_OF_IDS; i++)
+        IFF_addToForm(form, createNumberedChunk(IFF_MAKEID('X', 'Y', 'A' + i / 26, 'A' + i % 26), i));
+
+    for(i = 0; i < NUM_OF_IDS; i++)
+    {
+        rawChunk = (IFF_RawChunk*)IFF_getDataChunkFromForm(form, IFF_MAKEID('X', 'Y', 'A' + i / 26, 'A' + i % 26));
+
+        if(rawChunk == NULL || rawChunk->chunkData[0] != i)
+        {
+            fprintf(stderr, "Chunk: %u with a distinct chunk ID should be retrieved!\n", i);
+            status = 1;
+        }
+    }
+
+    /* Removing and replacing chunks rebuilds the index */
+    chunk = IFF_removeFromGroup((IFF_Group*)form, 0);
+    IFF_free(chunk, NULL);
+    status |= checkChunks(form, "after removing a chunk");
+
+    if(form->chunkIndex == NULL)
+    {
+        fprintf(stderr, "The form should remain indexed after removing a chunk!\n");
+        status = 1;
+    }
+
+    chunk = IFF_replaceInGroup((IFF_Group*)form, 0, createNumberedChunk(ID_MNOP, 0));
+    IFF_free(chunk, NULL);
+    status |= checkChunks(form, "after replacing a chunk");
+
+    rawChunk = (IFF_RawChunk*)IFF_getDataChunkFromForm(form, ID_EFGH);
+
+    if(rawChunk == NULL || rawChunk->chunkData[0] != 2)
+    {
+        fprintf(stderr, "The first remaining EFGH chunk should be retrieved!\n");
+        status = 1;
+    }
+
+    if(!IFF_check((IFF_Chunk*)form, NULL))
+        status = 1;
+
+    status |= checkReadForm(form);
+
+    IFF_free((IFF_Chunk*)form, NULL);
+
+    return status;
+}
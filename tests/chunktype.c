@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <form.h>
+#include "test.h"
+#include "hello.h"
+#include "bye.h"
+#include "extensiondata.h"
+
+static int checkChunkTypes(const IFF_Form *form)
+{
+    if(form->chunkType == NULL || form->chunkType->chunkId != IFF_ID_FORM)
+    {
+        fprintf(stderr, "The form should refer to the FORM chunk type!\n");
+        return 1;
+    }
+
+    if(form->chunk[0]->chunkType == NULL || form->chunk[0]->chunkType->chunkId != TEST_ID_HELO
+        || form->chunk[1]->chunkType == NULL || form->chunk[1]->chunkType->chunkId != TEST_ID_BYE)
+    {
+        fprintf(stderr, "The sub chunks should refer to the chunk types of the TEST form!\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Form *form = IFF_createTestForm();
+    IFF_UByte *data;
+    size_t size;
+    int status;
+
+    /* Chunks that are created programmatically are looked up in the registry */
+    if(form->chunkType != NULL || form->chunk[0]->chunkType != NULL)
+    {
+        fprintf(stderr, "Created chunks should not refer to a chunk type!\n");
+        status = 1;
+    }
+    else if(!TEST_writeBuffer((IFF_Chunk*)form, &data, &size))
+    {
+        fprintf(stderr, "Cannot write the chunk to a buffer!\n");
+        status = 1;
+    }
+    else
+    {
+        IFF_Chunk *chunk = TEST_readBuffer(data, size);
+
+        if(chunk == NULL)
+        {
+            fprintf(stderr, "Cannot read the chunk from the buffer!\n");
+            status = 1;
+        }
+        else
+        {
+            status = checkChunkTypes((const IFF_Form*)chunk);
+
+            if(status == 0)
+            {
+                /* A data chunk that is detached from its form still knows how to free itself */
+                IFF_Chunk *hello = ((IFF_Form*)chunk)->chunk[0];
+                ((IFF_Form*)chunk)->chunk[0] = ((IFF_Form*)chunk)->chunk[1];
+                ((IFF_Form*)chunk)->chunkLength--;
+                TEST_free(hello);
+            }
+
+            TEST_free(chunk);
+        }
+
+        free(data);
+    }
+
+    TEST_free((IFF_Chunk*)form);
+    return status;
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chunkregistry.h>
+#include <defaultregistry.h>
+#include <id.h>
+#include <error.h>
+#include <cat.h>
+#include <list.h>
+#include <prop.h>
+#include <iff.h>
+#include "test.h"
+#include "hello.h"
+#include "bye.h"
+#include "extensiondata.h"
+
+#define ID_ABCD IFF_MAKEID('A', 'B', 'C', 'D')
+#define ID_WXYZ IFF_MAKEID('W', 'X', 'Y', 'Z')
+
+static IFF_ChunkType testChunkTypes[] = {
+    {TEST_ID_BYE, &TEST_createByeChunk, &TEST_readBye, &TEST_writeBye, &TEST_checkBye, &TEST_freeBye, &TEST_printBye, &TEST_compareBye},
+    {TEST_ID_HELO, &TEST_createHelloChunk, &TEST_readHello, &TEST_writeHello, &TEST_checkHello, &TEST_freeHello, &TEST_printHello, &TEST_compareHello}
+};
+
+static IFF_ChunkTypesNode testChunkTypesNode = {
+    2, testChunkTypes, &IFF_globalChunkTypesNode
+};
+
+/* The ABCD form only knows HELO chunks and none of the global chunk types */
+static IFF_ChunkTypesNode abcdChunkTypesNode = {
+    1, &testChunkTypes[1], NULL
+};
+
+static IFF_FormChunkTypes formChunkTypes[] = {
+    { ID_ABCD, &abcdChunkTypesNode },
+    { TEST_ID_TEST, &testChunkTypesNode }
+};
+
+static const IFF_ChunkRegistry chunkRegistry = IFF_EXTEND_DEFAULT_REGISTRY_WITH_FORM_CHUNK_TYPES(2, formChunkTypes);
+
+/* Registries that should be rejected by the compiler */
+
+static IFF_FormChunkTypes unsortedFormChunkTypes[] = {
+    { TEST_ID_TEST, &testChunkTypesNode },
+    { ID_ABCD, &abcdChunkTypesNode }
+};
+
+static const IFF_ChunkRegistry unsortedFormsRegistry = IFF_EXTEND_DEFAULT_REGISTRY_WITH_FORM_CHUNK_TYPES(2, unsortedFormChunkTypes);
+
+static IFF_ChunkType unsortedChunkTypes[] = {
+    {TEST_ID_HELO, &TEST_createHelloChunk, &TEST_readHello, &TEST_writeHello, &TEST_checkHello, &TEST_freeHello, &TEST_printHello, &TEST_compareHello},
+    {TEST_ID_BYE, &TEST_createByeChunk, &TEST_readBye, &TEST_writeBye, &TEST_checkBye, &TEST_freeBye, &TEST_printBye, &TEST_compareBye}
+};
+
+static IFF_ChunkTypesNode unsortedChunkTypesNode = {
+    2, unsortedChunkTypes, &IFF_globalChunkTypesNode
+};
+
+static IFF_FormChunkTypes unsortedChunksFormChunkTypes[] = {
+    { TEST_ID_TEST, &unsortedChunkTypesNode }
+};
+
+static const IFF_ChunkRegistry unsortedChunksRegistry = IFF_EXTEND_DEFAULT_REGISTRY_WITH_FORM_CHUNK_TYPES(1, unsortedChunksFormChunkTypes);
+
+static IFF_ChunkType duplicateChunkTypes[] = {
+    {TEST_ID_HELO, &TEST_createHelloChunk, &TEST_readHello, &TEST_writeHello, &TEST_checkHello, &TEST_freeHello, &TEST_printHello, &TEST_compareHello},
+    {TEST_ID_HELO, &TEST_createHelloChunk, &TEST_readHello, &TEST_writeHello, &TEST_checkHello, &TEST_freeHello, &TEST_printHello, &TEST_compareHello}
+};
+
+static IFF_ChunkTypesNode duplicateChunkTypesNode = {
+    2, duplicateChunkTypes, NULL
+};
+
+static const IFF_ChunkRegistry duplicateChunksRegistry = { 0, NULL, &duplicateChunkTypesNode, &IFF_defaultChunkType, NULL };
+
+static int checkLookups(const IFF_ChunkRegistry *compiledChunkRegistry)
+{
+    IFF_ID formTypes[] = { 0, ID_ABCD, TEST_ID_TEST, ID_WXYZ };
+    IFF_ID chunkIds[] = { IFF_ID_CAT, IFF_ID_FORM, IFF_ID_LIST, IFF_ID_PROP, TEST_ID_BYE, TEST_ID_HELO, ID_WXYZ };
+    unsigned int i;
+
+    for(i = 0; i < sizeof(formTypes) / sizeof(IFF_ID); i++)
+    {
+        unsigned int j;
+
+        for(j = 0; j < sizeof(chunkIds) / sizeof(IFF_ID); j++)
+        {
+            if(IFF_findChunkType(compiledChunkRegistry, formTypes[i], chunkIds[j]) != IFF_findChunkType(&chunkRegistry, formTypes[i], chunkIds[j]))
+            {
+                fprintf(stderr, "The compiled registry resolves: ");
+                IFF_errorId(formTypes[i]);
+                fprintf(stderr, ".");
+                IFF_errorId(chunkIds[j]);
+                fprintf(stderr, " to a different chunk type!\n");
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int checkRoundTrip(const IFF_ChunkRegistry *compiledChunkRegistry)
+{
+    IFF_Form *form = IFF_createTestForm();
+    IFF_UByte *data;
+    size_t size;
+    int status;
+
+    if(!IFF_writeBuffer((IFF_Chunk*)form, &data, &size, compiledChunkRegistry))
+    {
+        fprintf(stderr, "Cannot write the form with the compiled registry!\n");
+        status = 1;
+    }
+    else
+    {
+        IFF_Chunk *chunk = IFF_readBuffer(data, size, compiledChunkRegistry);
+
+        if(chunk == NULL)
+        {
+            fprintf(stderr, "Cannot read the form with the compiled registry!\n");
+            status = 1;
+        }
+        else
+        {
+            if(IFF_compare(chunk, (IFF_Chunk*)form, compiledChunkRegistry))
+                status = 0;
+            else
+            {
+                fprintf(stderr, "The form that has been read should be equal to the original!\n");
+                status = 1;
+            }
+
+            IFF_free(chunk, compiledChunkRegistry);
+        }
+
+        free(data);
+    }
+
+    TEST_free((IFF_Chunk*)form);
+    return status;
+}
+
+static int checkRejected(const IFF_ChunkRegistry *chunkRegistry, const char *description)
+{
+    IFF_ChunkRegistry *compiledChunkRegistry = IFF_compileChunkRegistry(chunkRegistry);
+
+    if(compiledChunkRegistry == NULL)
+        return 0;
+    else
+    {
+        fprintf(stderr, "A registry with %s should not compile!\n", description);
+        IFF_freeCompiledChunkRegistry(compiledChunkRegistry);
+        return 1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_ChunkRegistry *compiledChunkRegistry = IFF_compileChunkRegistry(&chunkRegistry);
+    int status;
+
+    if(compiledChunkRegistry == NULL)
+    {
+        fprintf(stderr, "Cannot compile the chunk registry!\n");
+        return 1;
+    }
+
+    status = checkLookups(compiledChunkRegistry);
+
+    if(status == 0)
+        status = checkRoundTrip(compiledChunkRegistry);
+
+    IFF_freeCompiledChunkRegistry(compiledChunkRegistry);
+
+    if(status == 0)
+        status = checkRejected(&unsortedFormsRegistry, "unsorted form types");
+
+    if(status == 0)
+        status = checkRejected(&unsortedChunksRegistry, "unsorted chunk types");
+
+    if(status == 0)
+        status = checkRejected(&duplicateChunksRegistry, "duplicate chunk types");
+
+    return status;
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "iff.h"
+#include "context.h"
+#include "error.h"
+#include "memorystream.h"
+#include "form.h"
+#include "cat.h"
+#include "rawchunk.h"
+#include "id.h"
+
+#define ID_ABCD IFF_MAKEID('A', 'B', 'C', 'D')
+#define ID_TEST IFF_MAKEID('T', 'E', 'S', 'T')
+
+static unsigned int globalMessagesLength = 0;
+
+static void countGlobalMessage(const char *formatString, va_list ap)
+{
+    globalMessagesLength++;
+}
+
+static void countContextMessage(void *data, const char *formatString, va_list ap)
+{
+    unsigned int *messagesLength = (unsigned int*)data;
+    *messagesLength = *messagesLength + 1;
+}
+
+static IFF_Chunk *createCAT(void)
+{
+    IFF_RawChunk *rawChunk = (IFF_RawChunk*)IFF_createRawChunk(ID_ABCD, 4);
+    IFF_Form *form = IFF_createEmptyForm(ID_TEST);
+    IFF_CAT *cat = IFF_createEmptyCAT();
+
+    memcpy(rawChunk->chunkData, "ABCD", 4);
+    IFF_addToForm(form, (IFF_Chunk*)rawChunk);
+    IFF_addToCAT(cat, (IFF_Chunk*)form);
+
+    return (IFF_Chunk*)cat;
+}
+
+static int checkChunkPath(const IFF_Context *context, const IFF_ID *chunkPath, const unsigned int chunkPathLength)
+{
+    unsigned int i;
+
+    if(context->chunkPathLength != chunkPathLength)
+    {
+        fprintf(stderr, "The chunk path should have length: %u, but it has length: %u\n", chunkPathLength, context->chunkPathLength);
+        return 1;
+    }
+
+    for(i = 0; i < chunkPathLength; i++)
+    {
+        if(context->chunkPath[i] != chunkPath[i])
+        {
+            fprintf(stderr, "Element: %u of the chunk path is incorrect!\n", i);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int checkTruncatedRead(const IFF_UByte *data, const size_t size)
+{
+    IFF_Context context;
+    IFF_MemoryIOStream stream;
+    IFF_Chunk *chunk;
+    IFF_ID chunkPath[3];
+    int status = 0;
+
+    chunkPath[0] = IFF_ID_CAT;
+    chunkPath[1] = IFF_ID_FORM;
+    chunkPath[2] = ID_ABCD;
+
+    /* Cut off the last two bytes of the ABCD chunk body */
+    IFF_initContext(&context);
+    IFF_initMemoryIOStream(&stream, (IFF_UByte*)data, size - 2);
+
+    IFF_selectContext(&context);
+    chunk = IFF_readStream((IFF_IOStream*)&stream, NULL);
+    IFF_selectContext(NULL);
+
+    if(chunk != NULL)
+    {
+        fprintf(stderr, "Reading a truncated file should fail!\n");
+        IFF_free(chunk, NULL);
+        return 1;
+    }
+
+    if(context.errorCode != IFF_ERROR_READ)
+    {
+        fprintf(stderr, "The error should be a read error, but it is: %s\n", IFF_errorCodeToString(context.errorCode));
+        status = 1;
+    }
+
+    status |= checkChunkPath(&context, chunkPath, 3);
+
+    if(context.offset != (long)(size - 2))
+    {
+        fprintf(stderr, "The error should occur at offset: %ld, but it occurs at: %ld\n", (long)(size - 2), context.offset);
+        status = 1;
+    }
+
+    if(context.depth != 0)
+    {
+        fprintf(stderr, "All chunks should have been left!\n");
+        status = 1;
+    }
+
+    return status;
+}
+
+static int checkInvalidChunk(IFF_Chunk *chunk)
+{
+    IFF_Context context;
+    unsigned int messagesLength = 0;
+    IFF_ID chunkPath[2];
+    int status = 0;
+
+    chunkPath[0] = IFF_ID_CAT;
+    chunkPath[1] = IFF_ID_FORM;
+
+    /* Make the size of the form incorrect */
+    ((IFF_CAT*)chunk)->chunk[0]->chunkSize += 2;
+
+    IFF_initContext(&context);
+    context.errorCallback = &countContextMessage;
+    context.errorData = &messagesLength;
+
+    IFF_selectContext(&context);
+
+    if(IFF_check(chunk, NULL))
+    {
+        fprintf(stderr, "The chunk hierarchy should be invalid!\n");
+        status = 1;
+    }
+
+    IFF_selectContext(NULL);
+
+    ((IFF_CAT*)chunk)->chunk[0]->chunkSize -= 2;
+
+    if(context.errorCode != IFF_ERROR_INVALID || context.offset != -1)
+    {
+        fprintf(stderr, "The error should be an invalid data error without offset!\n");
+        status = 1;
+    }
+
+    status |= checkChunkPath(&context, chunkPath, 2);
+
+    if(messagesLength == 0)
+    {
+        fprintf(stderr, "The messages should be passed to the callback of the context!\n");
+        status = 1;
+    }
+
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Chunk *chunk = createCAT();
+    IFF_UByte *data;
+    size_t size;
+    int status = 0;
+
+    if(!IFF_writeBuffer(chunk, &data, &size, NULL))
+    {
+        IFF_free(chunk, NULL);
+        return 1;
+    }
+
+    IFF_errorCallback = &countGlobalMessage;
+
+    status |= checkTruncatedRead(data, size);
+    status |= checkInvalidChunk(chunk);
+
+    /* While a context without an error callback is selected, no messages should be produced */
+    if(globalMessagesLength != 0)
+    {
+        fprintf(stderr, "No messages should be passed to the global error callback!\n");
+        status = 1;
+    }
+
+    IFF_errorCallback = &IFF_errorCallbackStderr;
+
+    free(data);
+    IFF_free(chunk, NULL);
+
+    return status;
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <descriptor.h>
+#include <memorystream.h>
+#include <id.h>
+#include <chunkregistry.h>
+#include <defaultregistry.h>
+
+#define ID_DESC IFF_MAKEID('D', 'E', 'S', 'C')
+#define DESC_SIZE 18
+
+typedef struct
+{
+    IFF_Group *parent;
+
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+    IFF_ChunkType *chunkType;
+    IFF_Hash hash;
+    IFF_Arena *arena;
+
+    IFF_UByte ubyte;
+    IFF_UByte character;
+    IFF_UWord uword;
+    IFF_Word word;
+    IFF_ULong ulong;
+    IFF_Long slong;
+    IFF_ID id;
+}
+Desc;
+
+static const IFF_FieldDescriptor descFieldDescriptors[] = {
+    { IFF_FIELD_TYPE_UBYTE, offsetof(Desc, ubyte), "ubyte" },
+    { IFF_FIELD_TYPE_CHAR, offsetof(Desc, character), "character" },
+    { IFF_FIELD_TYPE_UWORD, offsetof(Desc, uword), "uword" },
+    { IFF_FIELD_TYPE_WORD, offsetof(Desc, word), "word" },
+    { IFF_FIELD_TYPE_ULONG, offsetof(Desc, ulong), "ulong" },
+    { IFF_FIELD_TYPE_LONG, offsetof(Desc, slong), "slong" },
+    { IFF_FIELD_TYPE_ID, offsetof(Desc, id), "id" }
+};
+
+static const IFF_ChunkDescriptor descChunkDescriptor = {
+    sizeof(Desc), 7, descFieldDescriptors, NULL
+};
+
+IFF_DEFINE_DESCRIBED_CHUNK_FUNCTIONS(DESC_, Desc, descChunkDescriptor)
+
+static IFF_ChunkType descChunkTypes[] = {
+    {ID_DESC, &DESC_createDescChunk, &DESC_readDesc, &DESC_writeDesc, &DESC_checkDesc, &DESC_freeDesc, &DESC_printDesc, &DESC_compareDesc}
+};
+
+static IFF_ChunkTypesNode descChunkTypesNode = {
+    1, descChunkTypes, NULL
+};
+
+static const IFF_ChunkRegistry chunkRegistry = { 0, NULL, &descChunkTypesNode, &IFF_defaultChunkType, NULL };
+
+static const IFF_UByte expectedData[DESC_SIZE] = {
+    0xfe, 'x', 0xab, 0xcd, 0xff, 0xfe, 0x12, 0x34, 0x56, 0x78, 0xff, 0xff, 0xff, 0xfd, 'D', 'E', 'S', 'C'
+};
+
+static Desc *createDesc(const IFF_Long chunkSize)
+{
+    Desc *desc = (Desc*)DESC_createDescChunk(ID_DESC, chunkSize);
+
+    desc->ubyte = 0xfe;
+    desc->character = 'x';
+    desc->uword = 0xabcd;
+    desc->word = -2;
+    desc->ulong = 0x12345678;
+    desc->slong = -3;
+    desc->id = ID_DESC;
+
+    return desc;
+}
+
+static int checkCompleteChunk(void)
+{
+    Desc *desc = createDesc(DESC_SIZE);
+    Desc *readDesc = (Desc*)IFF_createDescribedChunk(&descChunkDescriptor, ID_DESC, DESC_SIZE);
+    IFF_UByte buffer[DESC_SIZE];
+    IFF_MemoryIOStream stream;
+    IFF_Long bytesProcessed = 0;
+    int status = 1;
+
+    IFF_initMemoryIOStream(&stream, buffer, DESC_SIZE);
+
+    if(!IFF_writeDescribedChunkFields(&descChunkDescriptor, (IFF_IOStream*)&stream, (IFF_Chunk*)desc, NULL, &bytesProcessed) || bytesProcessed != DESC_SIZE)
+        fprintf(stderr, "Cannot write all fields!\n");
+    else if(memcmp(buffer, expectedData, DESC_SIZE) != 0)
+        fprintf(stderr, "The fields should be stored in big-endian order without padding!\n");
+    else
+    {
+        IFF_initMemoryIOStream(&stream, buffer, DESC_SIZE);
+        bytesProcessed = 0;
+
+        if(!IFF_readDescribedChunkFields(&descChunkDescriptor, (IFF_IOStream*)&stream, (IFF_Chunk*)readDesc, NULL, &bytesProcessed) || bytesProcessed != DESC_SIZE)
+            fprintf(stderr, "Cannot read all fields!\n");
+        else if(!IFF_compareDescribedChunk(&descChunkDescriptor, (IFF_Chunk*)desc, (IFF_Chunk*)readDesc, NULL))
+            fprintf(stderr, "The chunk that has been read should be equal to the original!\n");
+        else
+        {
+            IFF_printDescribedChunk(&descChunkDescriptor, (IFF_Chunk*)readDesc, 0, NULL);
+            status = 0;
+        }
+    }
+
+    IFF_freeChunk((IFF_Chunk*)desc, 0, &chunkRegistry);
+    IFF_freeChunk((IFF_Chunk*)readDesc, 0, &chunkRegistry);
+    return status;
+}
+
+static int checkTruncatedChunk(void)
+{
+    const IFF_Long truncatedSize = 4; /* Only contains ubyte, character and uword */
+    Desc *desc = createDesc(truncatedSize);
+    Desc *readDesc = (Desc*)IFF_createDescribedChunk(&descChunkDescriptor, ID_DESC, truncatedSize);
+    IFF_UByte buffer[DESC_SIZE];
+    IFF_MemoryIOStream stream;
+    IFF_Long bytesProcessed = 0;
+    int status = 1;
+
+    IFF_initMemoryIOStream(&stream, buffer, DESC_SIZE);
+
+    if(!IFF_writeDescribedChunkFields(&descChunkDescriptor, (IFF_IOStream*)&stream, (IFF_Chunk*)desc, NULL, &bytesProcessed) || bytesProcessed != truncatedSize)
+        fprintf(stderr, "Only the fields that fit in the truncated chunk should be written!\n");
+    else
+    {
+        IFF_initMemoryIOStream(&stream, buffer, truncatedSize);
+        bytesProcessed = 0;
+
+        if(!IFF_readDescribedChunkFields(&descChunkDescriptor, (IFF_IOStream*)&stream, (IFF_Chunk*)readDesc, NULL, &bytesProcessed) || bytesProcessed != truncatedSize)
+            fprintf(stderr, "Only the fields that fit in the truncated chunk should be read!\n");
+        else if(readDesc->uword != 0xabcd || readDesc->word != 0 || readDesc->id != 0)
+            fprintf(stderr, "The fields beyond the truncated chunk should remain 0!\n");
+        else
+            status = 0;
+    }
+
+    IFF_freeChunk((IFF_Chunk*)desc, 0, &chunkRegistry);
+    IFF_freeChunk((IFF_Chunk*)readDesc, 0, &chunkRegistry);
+    return status;
+}
+
+static int checkPrematureEnd(void)
+{
+    Desc *readDesc = (Desc*)IFF_createDescribedChunk(&descChunkDescriptor, ID_DESC, DESC_SIZE);
+    IFF_UByte buffer[DESC_SIZE];
+    IFF_MemoryIOStream stream;
+    IFF_Long bytesProcessed = 0;
+    int status;
+
+    memcpy(buffer, expectedData, DESC_SIZE);
+    IFF_initMemoryIOStream(&stream, buffer, 5); /* Ends in the middle of the word field */
+
+    if(IFF_readDescribedChunkFields(&descChunkDescriptor, (IFF_IOStream*)&stream, (IFF_Chunk*)readDesc, NULL, &bytesProcessed))
+    {
+        fprintf(stderr, "Reading a chunk from a stream that ends prematurely should fail!\n");
+        status = 1;
+    }
+    else
+        status = 0;
+
+    IFF_freeChunk((IFF_Chunk*)readDesc, 0, &chunkRegistry);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    int status = checkCompleteChunk();
+
+    if(status == 0)
+        status = checkTruncatedChunk();
+
+    if(status == 0)
+        status = checkPrematureEnd();
+
+    return status;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include "iff.h"
+#include "group.h"
+#include "form.h"
+#include "cat.h"
+#include "list.h"
+#include "id.h"
+
+#define ID_ABCD IFF_MAKEID('A', 'B', 'C', 'D')
+#define ID_EFGH IFF_MAKEID('E', 'F', 'G', 'H')
+#define ID_IJKL IFF_MAKEID('I', 'J', 'K', 'L')
+#define ID_TEST IFF_MAKEID('T', 'E', 'S', 'T')
+
+#define MAX_NUM_OF_FORMS 10
+
+typedef struct
+{
+    IFF_Form *forms[MAX_NUM_OF_FORMS];
+    unsigned int formsLength;
+    unsigned int maxFormsLength;
+}
+FormRecorder;
+
+static IFF_Bool recordForm(void *data, IFF_Form *form)
+{
+    FormRecorder *formRecorder = (FormRecorder*)data;
+
+    formRecorder->forms[formRecorder->formsLength] = form;
+    formRecorder->formsLength++;
+
+    return formRecorder->formsLength < formRecorder->maxFormsLength;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_CAT *cat = IFF_createEmptyCAT();
+    IFF_Form *abcdForm1 = IFF_createEmptyForm(ID_ABCD);
+    IFF_Form *testForm = IFF_createEmptyForm(ID_TEST);
+    IFF_Form *abcdForm2 = IFF_createEmptyForm(ID_ABCD);
+    IFF_Form *nestedAbcdForm = IFF_createEmptyForm(ID_ABCD);
+    IFF_List *list = IFF_createEmptyList();
+    IFF_Form *efghForm = IFF_createEmptyForm(ID_EFGH);
+    IFF_ID formTypes[2];
+    FormRecorder formRecorder;
+    int status = 0;
+
+    /*
+     * CAT
+     *     FORM ABCD (1)
+     *     FORM TEST
+     *         FORM ABCD (2)
+     *             FORM ABCD (nested, not found because its parent matches)
+     *     LIST
+     *         FORM EFGH
+     */
+    IFF_addToForm(abcdForm2, (IFF_Chunk*)nestedAbcdForm);
+    IFF_addToForm(testForm, (IFF_Chunk*)abcdForm2);
+    IFF_addToList(list, (IFF_Chunk*)efghForm);
+    IFF_addToCAT(cat, (IFF_Chunk*)abcdForm1);
+    IFF_addToCAT(cat, (IFF_Chunk*)testForm);
+    IFF_addToCAT(cat, (IFF_Chunk*)list);
+
+    formTypes[0] = ID_EFGH;
+    formTypes[1] = ID_ABCD;
+
+    /* Visit all forms with either form type */
+    formRecorder.formsLength = 0;
+    formRecorder.maxFormsLength = MAX_NUM_OF_FORMS;
+
+    if(!IFF_forEachFormFromArray((IFF_Chunk*)cat, formTypes, 2, &recordForm, &formRecorder)
+        || formRecorder.formsLength != 3
+        || formRecorder.forms[0] != abcdForm1
+        || formRecorder.forms[1] != abcdForm2
+        || formRecorder.forms[2] != efghForm)
+    {
+        fprintf(stderr, "The ABCD and EFGH forms should be visited in order!\n");
+        status = 1;
+    }
+
+    /* Stop the search after the second form */
+    formRecorder.formsLength = 0;
+    formRecorder.maxFormsLength = 2;
+
+    if(IFF_forEachFormFromArray((IFF_Chunk*)cat, formTypes, 2, &recordForm, &formRecorder) || formRecorder.formsLength != 2)
+    {
+        fprintf(stderr, "The search should stop after two forms!\n");
+        status = 1;
+    }
+
+    if(IFF_findFirstForm((IFF_Chunk*)cat, ID_EFGH) != efghForm)
+    {
+        fprintf(stderr, "The first EFGH form should be found!\n");
+        status = 1;
+    }
+
+    if(IFF_findFirstForm((IFF_Chunk*)cat, ID_TEST) != testForm)
+    {
+        fprintf(stderr, "The TEST form should be found!\n");
+        status = 1;
+    }
+
+    if(IFF_findFirstForm((IFF_Chunk*)cat, ID_IJKL) != NULL)
+    {
+        fprintf(stderr, "No IJKL form should be found!\n");
+        status = 1;
+    }
+
+    IFF_free((IFF_Chunk*)cat, NULL);
+
+    return status;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "iff.h"
+#include "form.h"
+#include "cat.h"
+#include "list.h"
+#include "prop.h"
+#include "rawchunk.h"
+#include "id.h"
+
+#define ID_ABCD IFF_MAKEID('A', 'B', 'C', 'D')
+#define ID_EFGH IFF_MAKEID('E', 'F', 'G', 'H')
+#define ID_TEST IFF_MAKEID('T', 'E', 'S', 'T')
+
+static IFF_Chunk *createTextChunk(const IFF_ID chunkId, const char *text)
+{
+    IFF_Long chunkSize = strlen(text);
+    IFF_RawChunk *rawChunk = (IFF_RawChunk*)IFF_createRawChunk(chunkId, chunkSize);
+    memcpy(rawChunk->chunkData, text, chunkSize);
+    return (IFF_Chunk*)rawChunk;
+}
+
+static IFF_Chunk *createCAT(const char *text)
+{
+    IFF_CAT *cat = IFF_createEmptyCATWithContentsType(ID_TEST);
+    IFF_List *list = IFF_createEmptyListWithContentsType(ID_TEST);
+    IFF_Prop *prop = IFF_createEmptyProp(ID_TEST);
+    IFF_Form *form = IFF_createEmptyForm(ID_TEST);
+
+    IFF_addToProp(prop, createTextChunk(ID_EFGH, "EFG"));
+    IFF_addPropToList(list, prop);
+    IFF_addToForm(form, createTextChunk(ID_ABCD, text));
+    IFF_addToList(list, (IFF_Chunk*)form);
+    IFF_addToCAT(cat, (IFF_Chunk*)list);
+
+    return (IFF_Chunk*)cat;
+}
+
+static IFF_RawChunk *getTextChunk(IFF_Chunk *chunk)
+{
+    IFF_List *list = (IFF_List*)((IFF_CAT*)chunk)->chunk[0];
+    return (IFF_RawChunk*)((IFF_Form*)list->chunk[0])->chunk[0];
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Chunk *chunk1 = createCAT("ABCD");
+    IFF_Chunk *chunk2 = createCAT("ABCD");
+    IFF_Chunk *chunk3 = createCAT("ABCE");
+    IFF_Chunk *readChunk;
+    IFF_RawChunk *textChunk;
+    IFF_UByte *data, *chunkData;
+    size_t size;
+    IFF_Hash hash1, hash3;
+    int status = 0;
+
+    /* Equal hierarchies should have equal hashes, different ones should not */
+    hash1 = IFF_hash(chunk1, NULL);
+    hash3 = IFF_hash(chunk3, NULL);
+
+    if(!IFF_compareHash(hash1, IFF_hash(chunk2, NULL)))
+    {
+        fprintf(stderr, "Equal chunk hierarchies should have equal hashes!\n");
+        status = 1;
+    }
+
+    if(IFF_compareHash(hash1, hash3))
+    {
+        fprintf(stderr, "Different chunk hierarchies should have different hashes!\n");
+        status = 1;
+    }
+
+    if(IFF_compare(chunk1, chunk3, NULL))
+    {
+        fprintf(stderr, "Chunk hierarchies with different hashes should not be equal!\n");
+        status = 1;
+    }
+
+    /* A hierarchy that has been read should have the same hash as the hierarchy that was written */
+    if(!IFF_writeBuffer(chunk1, &data, &size, NULL) || (readChunk = IFF_readBuffer(data, size, NULL)) == NULL)
+        return 1;
+
+    free(data);
+
+    if(!IFF_compareHash(hash1, IFF_hash(readChunk, NULL)))
+    {
+        fprintf(stderr, "A hierarchy that has been read should have the same hash as the original!\n");
+        status = 1;
+    }
+
+    IFF_free(readChunk, NULL);
+
+    /* Modifying a chunk through the library should invalidate the hashes of its ancestors */
+    textChunk = getTextChunk(chunk1);
+    chunkData = (IFF_UByte*)malloc(4);
+    memcpy(chunkData, "ABCE", 4);
+    free(textChunk->chunkData);
+    IFF_setRawChunkData(textChunk, chunkData, 4);
+
+    if(chunk1->hash.high != 0 || chunk1->hash.low != 0)
+    {
+        fprintf(stderr, "Modifying a sub chunk should invalidate the hash of the main chunk!\n");
+        status = 1;
+    }
+
+    if(!IFF_compareHash(IFF_hash(chunk1, NULL), hash3))
+    {
+        fprintf(stderr, "After the modification, the hash should be equal to the hash of the equal hierarchy!\n");
+        status = 1;
+    }
+
+    /* Modifying a chunk directly requires an explicit invalidation */
+    textChunk = getTextChunk(chunk2);
+    textChunk->chunkData[3] = 'E';
+    IFF_invalidateChunkHash((IFF_Chunk*)textChunk);
+
+    if(!IFF_compareHash(IFF_hash(chunk2, NULL), hash3) || !IFF_compare(chunk2, chunk3, NULL))
+    {
+        fprintf(stderr, "After the invalidation, the hierarchy should be equal to the equal hierarchy!\n");
+        status = 1;
+    }
+
+    /* Adding a chunk should invalidate the hashes as well */
+    IFF_addToCAT((IFF_CAT*)chunk3, (IFF_Chunk*)IFF_createEmptyForm(ID_TEST));
+
+    if(IFF_compareHash(IFF_hash(chunk3, NULL), hash3))
+    {
+        fprintf(stderr, "Adding a chunk should change the hash!\n");
+        status = 1;
+    }
+
+    IFF_free(chunk1, NULL);
+    IFF_free(chunk2, NULL);
+    IFF_free(chunk3, NULL);
+
+    return status;
+}
@@ -45,35 +45,35 @@ TEST_Hello *TEST_createHello(const IFF_Long chunkSize)
     return (TEST_Hello*)TEST_createHelloChunk(TEST_ID_HELO, chunkSize);
 }
 
-IFF_Bool TEST_readHello(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool TEST_readHello(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
     TEST_Hello *hello = (TEST_Hello*)chunk;
     IFF_FieldStatus status;
 
-    if((status = IFF_readUByteField(file, &hello->a, chunk, "a", bytesProcessed)) != IFF_FIELD_MORE)
+    if((status = IFF_readUByteField(stream, &hello->a, chunk, "a", bytesProcessed)) != IFF_FIELD_MORE)
         return IFF_deriveSuccess(status);
 
-    if((status = IFF_readUByteField(file, &hello->b, chunk, "b", bytesProcessed)) != IFF_FIELD_MORE)
+    if((status = IFF_readUByteField(stream, &hello->b, chunk, "b", bytesProcessed)) != IFF_FIELD_MORE)
         return IFF_deriveSuccess(status);
 
-    if((status = IFF_readUWordField(file, &hello->c, chunk, "c", bytesProcessed)) != IFF_FIELD_MORE)
+    if((status = IFF_readUWordField(stream, &hello->c, chunk, "c", bytesProcessed)) != IFF_FIELD_MORE)
         return IFF_deriveSuccess(status);
 
     return TRUE;
 }
 
-IFF_Bool TEST_writeHello(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
+IFF_Bool TEST_writeHello(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed)
 {
     const TEST_Hello *hello = (const TEST_Hello*)chunk;
     IFF_FieldStatus status;
 
-    if((status = IFF_writeUByteField(file, hello->a, chunk, "a", bytesProcessed)) != IFF_FIELD_MORE)
+    if((status = IFF_writeUByteField(stream, hello->a, chunk, "a", bytesProcessed)) != IFF_FIELD_MORE)
         return IFF_deriveSuccess(status);
 
-    if((status = IFF_writeUByteField(file, hello->b, chunk, "b", bytesProcessed)) != IFF_FIELD_MORE)
+    if((status = IFF_writeUByteField(stream, hello->b, chunk, "b", bytesProcessed)) != IFF_FIELD_MORE)
         return IFF_deriveSuccess(status);
 
-    if((status = IFF_writeUWordField(file, hello->c, chunk, "c", bytesProcessed)) != IFF_FIELD_MORE)
+    if((status = IFF_writeUWordField(stream, hello->c, chunk, "c", bytesProcessed)) != IFF_FIELD_MORE)
         return IFF_deriveSuccess(status);
 
     return TRUE;
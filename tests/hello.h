@@ -24,6 +24,7 @@
 
 #include <ifftypes.h>
 #include <chunk.h>
+#include <stream.h>
 #include <stdio.h>
 #include <id.h>
 
@@ -36,6 +37,9 @@ typedef struct
 
     IFF_ID chunkId;
     IFF_Long chunkSize;
+    IFF_ChunkType *chunkType;
+    IFF_Hash hash;
+    IFF_Arena *arena;
 
     IFF_UByte a;
     IFF_UByte b;
@@ -47,9 +51,9 @@ IFF_Chunk *TEST_createHelloChunk(const IFF_ID chunkId, const IFF_Long chunkSize)
 
 TEST_Hello *TEST_createHello(const IFF_Long chunkSize);
 
-IFF_Bool TEST_readHello(FILE *file, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool TEST_readHello(IFF_IOStream *stream, IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
-IFF_Bool TEST_writeHello(FILE *file, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
+IFF_Bool TEST_writeHello(IFF_IOStream *stream, const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry, IFF_Long *bytesProcessed);
 
 IFF_Bool TEST_checkHello(const IFF_Chunk *chunk, const IFF_ChunkRegistry *chunkRegistry);
 
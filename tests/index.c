@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <filestream.h>
+#include <form.h>
+#include <cat.h>
+#include <index.h>
+#include "test.h"
+#include "hello.h"
+#include "extensiondata.h"
+
+#define NUM_OF_FORMS 3
+
+static IFF_CAT *createTestCAT(IFF_Form **form)
+{
+    IFF_CAT *cat = IFF_createEmptyCAT();
+    unsigned int i;
+
+    /* Give every form a distinct hello chunk, so that we can tell them apart */
+    for(i = 0; i < NUM_OF_FORMS; i++)
+    {
+        form[i] = IFF_createTestForm();
+        ((TEST_Hello*)form[i]->chunk[0])->a = 'a' + i;
+        IFF_addToCAT(cat, (IFF_Chunk*)form[i]);
+    }
+
+    return cat;
+}
+
+static int checkIndex(const IFF_Index *index)
+{
+    const IFF_IndexEntry *entry;
+
+    /* A CAT, its forms and their hello and bye chunks */
+    if(index->entryLength != 1 + NUM_OF_FORMS * 3)
+    {
+        fprintf(stderr, "The index should contain: %u entries, but it has: %u\n", 1 + NUM_OF_FORMS * 3, index->entryLength);
+        return 1;
+    }
+
+    if(index->entry[0].chunkId != IFF_ID_CAT || index->entry[0].offset != 0 || index->entry[0].parent != -1)
+    {
+        fprintf(stderr, "The first entry should refer to the CAT!\n");
+        return 1;
+    }
+
+    if(index->sourceLength != 8 + index->entry[0].chunkSize)
+    {
+        fprintf(stderr, "The source length should be: %ld, but it is: %ld\n", (long)(8 + index->entry[0].chunkSize), index->sourceLength);
+        return 1;
+    }
+
+    entry = IFF_findIndexEntry(index, &index->entry[0], IFF_ID_FORM, TEST_ID_TEST, NUM_OF_FORMS - 1);
+
+    if(entry == NULL || entry->chunkSize != index->entry[1].chunkSize || entry->offset != 12 + (NUM_OF_FORMS - 1) * (8 + entry->chunkSize))
+    {
+        fprintf(stderr, "The last form in the CAT is not indexed correctly!\n");
+        return 1;
+    }
+
+    if(IFF_findIndexEntry(index, &index->entry[0], IFF_ID_FORM, TEST_ID_TEST, NUM_OF_FORMS) != NULL)
+    {
+        fprintf(stderr, "There should be no more forms in the CAT!\n");
+        return 1;
+    }
+
+    /* Hello chunks are not direct sub chunks of the CAT */
+    if(IFF_findIndexEntry(index, &index->entry[0], TEST_ID_HELO, 0, 0) != NULL || IFF_findIndexEntry(index, NULL, TEST_ID_HELO, 0, NUM_OF_FORMS - 1) == NULL)
+    {
+        fprintf(stderr, "Hello chunks should only be found in the forms!\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+static int checkIndexedChunk(const IFF_Index *index, IFF_Form **form)
+{
+    const IFF_IndexEntry *entry = IFF_findIndexEntry(index, &index->entry[0], IFF_ID_FORM, TEST_ID_TEST, 1);
+    const IFF_IndexEntry *helloEntry = IFF_findIndexEntry(index, entry, TEST_ID_HELO, 0, 0);
+    FILE *file = fopen("index.TEST", "rb");
+    IFF_FileIOStream stream;
+    IFF_Chunk *chunk;
+    int status = 0;
+
+    if(file == NULL)
+    {
+        fprintf(stderr, "Cannot open the indexed file!\n");
+        return 1;
+    }
+
+    IFF_initFileIOStream(&stream, file);
+
+    /* Seek straight to the second form */
+    if((chunk = TEST_readIndexedChunk((IFF_IOStream*)&stream, entry)) == NULL || !TEST_compare((IFF_Chunk*)form[1], chunk))
+    {
+        fprintf(stderr, "The second form should be equal to the original!\n");
+        status = 1;
+    }
+
+    if(chunk != NULL)
+        TEST_free(chunk);
+
+    if(status != 0)
+    {
+        fclose(file);
+        return status;
+    }
+
+    /* Data chunks should be read in the scope of their form */
+    if((chunk = TEST_readIndexedChunk((IFF_IOStream*)&stream, helloEntry)) == NULL || ((TEST_Hello*)chunk)->a != 'b')
+    {
+        fprintf(stderr, "The hello chunk of the second form should be read as a hello chunk!\n");
+        status = 1;
+    }
+
+    if(chunk != NULL)
+        TEST_freeChunk(chunk, helloEntry->formType);
+
+    fclose(file);
+    return status;
+}
+
+static int checkStaleEntry(const IFF_Index *index)
+{
+    IFF_IndexEntry entry = *IFF_findIndexEntry(index, &index->entry[0], IFF_ID_FORM, TEST_ID_TEST, 1);
+    FILE *file = fopen("index.TEST", "rb");
+    IFF_FileIOStream stream;
+    IFF_Chunk *chunk;
+    int status = 0;
+
+    if(file == NULL)
+    {
+        fprintf(stderr, "Cannot open the indexed file!\n");
+        return 1;
+    }
+
+    IFF_initFileIOStream(&stream, file);
+
+    /* An entry whose size no longer matches the chunk header should be rejected */
+    entry.chunkSize += 2;
+
+    if((chunk = TEST_readIndexedChunk((IFF_IOStream*)&stream, &entry)) != NULL)
+    {
+        fprintf(stderr, "An entry with a mismatching chunk size should not be read!\n");
+        TEST_free(chunk);
+        status = 1;
+    }
+
+    /* An entry whose offset refers to a different chunk should be rejected as well */
+    entry.chunkSize -= 2;
+    entry.offset += 12;
+
+    if((chunk = TEST_readIndexedChunk((IFF_IOStream*)&stream, &entry)) != NULL)
+    {
+        fprintf(stderr, "An entry with a mismatching chunk ID should not be read!\n");
+        TEST_free(chunk);
+        status = 1;
+    }
+
+    fclose(file);
+    return status;
+}
+
+static IFF_Bool compareIndexEntries(const IFF_IndexEntry *entry1, const IFF_IndexEntry *entry2)
+{
+    return entry1->chunkId == entry2->chunkId
+        && entry1->chunkSize == entry2->chunkSize
+        && entry1->groupType == entry2->groupType
+        && entry1->formType == entry2->formType
+        && entry1->offset == entry2->offset
+        && entry1->parent == entry2->parent;
+}
+
+static int checkTruncatedSidecar(const IFF_Index *index)
+{
+    IFF_Index truncatedIndex = *index;
+    IFF_Index *readIndex;
+
+    /* The last chunk no longer fits within the source */
+    truncatedIndex.sourceLength = index->sourceLength - 2;
+
+    if(!IFF_writeIndexFile("index.IDX", &truncatedIndex))
+    {
+        fprintf(stderr, "Cannot write the index file!\n");
+        return 1;
+    }
+
+    if((readIndex = IFF_readIndexFile("index.IDX")) != NULL)
+    {
+        fprintf(stderr, "An index with entries beyond its source length should be rejected!\n");
+        IFF_freeIndex(readIndex);
+        return 1;
+    }
+
+    return 0;
+}
+
+static int checkSidecar(const IFF_Index *index)
+{
+    IFF_Index *readIndex;
+    int status;
+
+    if(!IFF_writeIndexFile("index.IDX", index))
+    {
+        fprintf(stderr, "Cannot write the index file!\n");
+        return 1;
+    }
+
+    if((readIndex = IFF_readIndexFile("index.IDX")) == NULL)
+    {
+        fprintf(stderr, "Cannot read the index file!\n");
+        return 1;
+    }
+
+    if(readIndex->sourceLength != index->sourceLength)
+    {
+        fprintf(stderr, "The source length that was read back should be: %ld\n", index->sourceLength);
+        status = 1;
+    }
+    else if(readIndex->entryLength == index->entryLength)
+    {
+        unsigned int i;
+
+        status = 0;
+
+        for(i = 0; i < index->entryLength; i++)
+        {
+            if(!compareIndexEntries(&readIndex->entry[i], &index->entry[i]))
+            {
+                fprintf(stderr, "Index entry: %u that was read back should be equal to the original!\n", i);
+                status = 1;
+            }
+        }
+    }
+    else
+    {
+        fprintf(stderr, "The index that was read back should have: %u entries!\n", index->entryLength);
+        status = 1;
+    }
+
+    IFF_freeIndex(readIndex);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Form *form[NUM_OF_FORMS];
+    IFF_CAT *cat = createTestCAT(form);
+    IFF_Index *index;
+    int status;
+
+    if(!TEST_write("index.TEST", (IFF_Chunk*)cat))
+    {
+        fprintf(stderr, "Cannot write the CAT!\n");
+        status = 1;
+    }
+    else if((index = IFF_buildIndexFromFile("index.TEST")) == NULL)
+    {
+        fprintf(stderr, "Cannot build the index!\n");
+        status = 1;
+    }
+    else
+    {
+        status = checkIndex(index);
+
+        if(status == 0)
+            status = checkIndexedChunk(index, form);
+
+        if(status == 0)
+            status = checkStaleEntry(index);
+
+        if(status == 0)
+            status = checkSidecar(index);
+
+        if(status == 0)
+            status = checkTruncatedSidecar(index);
+
+        IFF_freeIndex(index);
+    }
+
+    TEST_free((IFF_Chunk*)cat);
+    return status;
+}
@@ -0,0 +1,3 @@
+#!/bin/sh -e
+
+! ../src/iffjoin/iffjoin -s -c -o join-stream-invalid.IFF join.HELO invalidid1.TEST
@@ -0,0 +1,8 @@
+#!/bin/sh -e
+
+../src/iffjoin/iffjoin -o join-memory.IFF join.HELO join.BYE join.HELO
+../src/iffjoin/iffjoin -s -o join-stream.IFF join.HELO join.BYE join.HELO
+cmp join-memory.IFF join-stream.IFF
+../src/iffjoin/iffjoin -s -c join.HELO join.BYE join.HELO | cat > join-stream-pipe.IFF
+cmp join-memory.IFF join-stream-pipe.IFF
+./validiff join-stream.IFF
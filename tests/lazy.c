@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <filestream.h>
+#include <memorystream.h>
+#include <form.h>
+#include <lazy.h>
+#include "test.h"
+#include "hello.h"
+#include "bye.h"
+#include "extensiondata.h"
+
+static int checkLazyForm(IFF_Form *form, const IFF_Form *originalForm)
+{
+    const TEST_Hello *hello;
+
+    /* Both data chunks should have been deferred */
+    if(form->chunkLength != 2 || !IFF_isLazyGroupSubChunk((IFF_Group*)form, 0) || !IFF_isLazyGroupSubChunk((IFF_Group*)form, 1))
+    {
+        fprintf(stderr, "The form should contain two chunks that have not been loaded yet!\n");
+        return 1;
+    }
+
+    /* The placeholders should already know their chunk ids and sizes */
+    if(form->chunk[0]->chunkId != TEST_ID_HELO || form->chunk[0]->chunkSize != TEST_HELO_DEFAULT_SIZE)
+    {
+        fprintf(stderr, "The placeholder of the hello chunk has the wrong properties!\n");
+        return 1;
+    }
+
+    /* Retrieving the hello chunk should load it, but leave the bye chunk alone */
+    hello = (const TEST_Hello*)IFF_getChunkFromForm(form, TEST_ID_HELO);
+
+    if(hello == NULL || hello->a != 'a' || hello->b != 'b' || hello->c != 4096 || hello->parent != (IFF_Group*)form)
+    {
+        fprintf(stderr, "The hello chunk is not loaded correctly!\n");
+        return 1;
+    }
+
+    if(IFF_isLazyGroupSubChunk((IFF_Group*)form, 0) || !IFF_isLazyGroupSubChunk((IFF_Group*)form, 1))
+    {
+        fprintf(stderr, "Only the hello chunk should have been loaded!\n");
+        return 1;
+    }
+
+    /* Comparing should load the remaining chunks */
+    if(!TEST_compare((IFF_Chunk*)originalForm, (IFF_Chunk*)form))
+    {
+        fprintf(stderr, "The lazily read form should be equal to the original!\n");
+        return 1;
+    }
+
+    if(IFF_isLazyGroupSubChunk((IFF_Group*)form, 1))
+    {
+        fprintf(stderr, "All chunks should have been loaded after comparing!\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+static int checkLazyStream(IFF_IOStream *stream, const IFF_Form *originalForm)
+{
+    IFF_Chunk *chunk = TEST_readLazyStream(stream);
+    int status;
+
+    if(chunk == NULL)
+    {
+        fprintf(stderr, "Cannot read the form lazily!\n");
+        return 1;
+    }
+
+    status = checkLazyForm((IFF_Form*)chunk, originalForm);
+    TEST_free(chunk);
+    return status;
+}
+
+static int checkUnloadedFree(const IFF_UByte *data, const size_t size)
+{
+    IFF_MemoryIOStream stream;
+    IFF_Chunk *chunk;
+
+    IFF_initMemoryIOStream(&stream, (IFF_UByte*)data, size);
+
+    /* Freeing a hierarchy with placeholders should not load them */
+    if((chunk = TEST_readLazyStream((IFF_IOStream*)&stream)) == NULL)
+    {
+        fprintf(stderr, "Cannot read the form lazily!\n");
+        return 1;
+    }
+
+    TEST_free(chunk);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Form *form = IFF_createTestForm();
+    IFF_UByte *data;
+    size_t size;
+    int status;
+
+    if(!TEST_writeBuffer((IFF_Chunk*)form, &data, &size))
+    {
+        fprintf(stderr, "Cannot write the chunk to a buffer!\n");
+        status = 1;
+    }
+    else
+    {
+        IFF_MemoryIOStream memoryStream;
+
+        /* Read lazily from memory */
+        IFF_initMemoryIOStream(&memoryStream, data, size);
+        status = checkLazyStream((IFF_IOStream*)&memoryStream, form);
+
+        if(status == 0)
+            status = checkUnloadedFree(data, size);
+
+        /* Read lazily from a file */
+        if(status == 0)
+        {
+            FILE *file;
+
+            if(!TEST_write("lazy.TEST", (IFF_Chunk*)form) || (file = fopen("lazy.TEST", "rb")) == NULL)
+            {
+                fprintf(stderr, "Cannot write the chunk to a file!\n");
+                status = 1;
+            }
+            else
+            {
+                IFF_FileIOStream fileStream;
+
+                IFF_initFileIOStream(&fileStream, file);
+                status = checkLazyStream((IFF_IOStream*)&fileStream, form);
+                fclose(file);
+            }
+        }
+
+        free(data);
+    }
+
+    TEST_free((IFF_Chunk*)form);
+    return status;
+}
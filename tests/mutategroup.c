@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "iff.h"
+#include "group.h"
+#include "form.h"
+#include "cat.h"
+#include "list.h"
+#include "prop.h"
+#include "rawchunk.h"
+#include "id.h"
+
+#define ID_ABCD IFF_MAKEID('A', 'B', 'C', 'D')
+#define ID_EFGH IFF_MAKEID('E', 'F', 'G', 'H')
+#define ID_TEST IFF_MAKEID('T', 'E', 'S', 'T')
+
+static IFF_Chunk *createTextChunk(const IFF_ID chunkId, const char *text)
+{
+    IFF_Long chunkSize = strlen(text);
+    IFF_RawChunk *rawChunk = (IFF_RawChunk*)IFF_createRawChunk(chunkId, chunkSize);
+    memcpy(rawChunk->chunkData, text, chunkSize);
+    return (IFF_Chunk*)rawChunk;
+}
+
+static int checkChunkSizes(IFF_CAT *cat, const char *operation)
+{
+    if(IFF_check((IFF_Chunk*)cat, NULL))
+        return 0;
+    else
+    {
+        fprintf(stderr, "The chunk sizes are invalid after: %s\n", operation);
+        return 1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_CAT *cat = IFF_createEmptyCATWithContentsType(ID_TEST);
+    IFF_List *list = IFF_createEmptyListWithContentsType(ID_TEST);
+    IFF_Prop *prop = IFF_createEmptyProp(ID_TEST);
+    IFF_Form *form = IFF_createEmptyForm(ID_TEST);
+    IFF_RawChunk *abcdChunk;
+    IFF_UByte *chunkData;
+    IFF_Chunk *chunk;
+    int status = 0;
+
+    /* Compose the hierarchy first, so that the sub chunks added afterwards must update all ancestors */
+    IFF_addToCAT(cat, (IFF_Chunk*)list);
+    IFF_addPropToList(list, prop);
+    IFF_addToList(list, (IFF_Chunk*)form);
+    status |= checkChunkSizes(cat, "composing the hierarchy");
+
+    IFF_addToProp(prop, createTextChunk(ID_EFGH, "EFG"));
+    status |= checkChunkSizes(cat, "adding a chunk to a PROP");
+
+    abcdChunk = (IFF_RawChunk*)createTextChunk(ID_ABCD, "ABCD");
+    IFF_addToForm(form, (IFF_Chunk*)abcdChunk);
+    IFF_addToForm(form, createTextChunk(ID_EFGH, "EFGH"));
+    status |= checkChunkSizes(cat, "adding chunks to a FORM");
+
+    /* Make the body odd, so that a padding byte appears */
+    chunkData = (IFF_UByte*)realloc(abcdChunk->chunkData, 5 * sizeof(IFF_UByte));
+    chunkData[4] = 'E';
+    IFF_setRawChunkData(abcdChunk, chunkData, 5);
+    status |= checkChunkSizes(cat, "growing a chunk body");
+
+    /* Make the body even again, so that the padding byte disappears */
+    IFF_resizeChunk((IFF_Chunk*)abcdChunk, 2);
+    status |= checkChunkSizes(cat, "shrinking a chunk body");
+
+    chunk = IFF_replaceInGroup((IFF_Group*)form, 1, createTextChunk(ID_EFGH, "E"));
+
+    if(chunk == NULL || chunk->parent != NULL)
+    {
+        fprintf(stderr, "The replaced chunk should be detached!\n");
+        status = 1;
+    }
+    else
+        IFF_free(chunk, NULL);
+
+    status |= checkChunkSizes(cat, "replacing a chunk");
+
+    chunk = IFF_removeFromGroup((IFF_Group*)form, 0);
+
+    if(chunk != (IFF_Chunk*)abcdChunk || chunk->parent != NULL || form->chunkLength != 1 || form->chunk[0]->chunkSize != 1)
+    {
+        fprintf(stderr, "The removed chunk should be detached and the remaining chunks shifted!\n");
+        status = 1;
+    }
+    else
+        IFF_free(chunk, NULL);
+
+    status |= checkChunkSizes(cat, "removing a chunk");
+
+    if(IFF_removeFromGroup((IFF_Group*)form, 1) != NULL)
+    {
+        fprintf(stderr, "Removing a chunk beyond the end of the group should fail!\n");
+        status = 1;
+    }
+
+    IFF_free((IFF_Chunk*)cat, NULL);
+
+    return status;
+}
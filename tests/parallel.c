@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <form.h>
+#include <cat.h>
+#include <list.h>
+#include <prop.h>
+#include <parallel.h>
+#include "test.h"
+#include "hello.h"
+#include "extensiondata.h"
+
+#define NUM_OF_FORMS 100
+#define NUM_OF_THREADS 4
+
+static IFF_Chunk *createTestCAT(void)
+{
+    IFF_CAT *cat = IFF_createEmptyCAT();
+    unsigned int i;
+
+    /* Give every form a distinct hello chunk, so that a different order is noticed */
+    for(i = 0; i < NUM_OF_FORMS; i++)
+    {
+        IFF_Form *form = IFF_createTestForm();
+        ((TEST_Hello*)form->chunk[0])->c = i;
+        IFF_addToCAT(cat, (IFF_Chunk*)form);
+    }
+
+    return (IFF_Chunk*)cat;
+}
+
+static IFF_Chunk *createTestList(void)
+{
+    IFF_List *list = IFF_createEmptyList();
+    IFF_Prop *prop = IFF_createEmptyProp(TEST_ID_TEST);
+    TEST_Hello *hello = TEST_createHello(TEST_HELO_DEFAULT_SIZE);
+    unsigned int i;
+
+    hello->a = 'x';
+    hello->b = 'y';
+    hello->c = 1;
+
+    IFF_addToProp(prop, (IFF_Chunk*)hello);
+    IFF_addPropToList(list, prop);
+
+    for(i = 0; i < NUM_OF_FORMS; i++)
+        IFF_addToList(list, (IFF_Chunk*)IFF_createTestForm());
+
+    return (IFF_Chunk*)list;
+}
+
+static IFF_Bool executeInReverse(void *executorData, IFF_ParallelTask task, void *taskData, const unsigned int taskLength)
+{
+    unsigned int i;
+
+    /* The members should be attached in their original order, regardless of the order in which they are parsed */
+    for(i = taskLength; i > 0; i--)
+        task(taskData, i - 1);
+
+    return TRUE;
+}
+
+static int checkParallelRead(const IFF_Chunk *chunk, IFF_Executor executor, void *executorData)
+{
+    IFF_UByte *data;
+    size_t size;
+    IFF_Chunk *parallelChunk;
+    int status;
+
+    if(!TEST_writeBuffer(chunk, &data, &size))
+    {
+        fprintf(stderr, "Cannot write the chunk to a buffer!\n");
+        return 1;
+    }
+
+    if((parallelChunk = TEST_readParallelBuffer(data, size, executor, executorData)) == NULL)
+    {
+        fprintf(stderr, "Cannot read the chunk in parallel!\n");
+        status = 1;
+    }
+    else
+    {
+        if(TEST_compare(chunk, parallelChunk))
+            status = 0;
+        else
+        {
+            fprintf(stderr, "The chunk that was read in parallel should be equal to the original!\n");
+            status = 1;
+        }
+
+        TEST_free(parallelChunk);
+    }
+
+    /* A truncated member should make the entire read fail */
+    if(status == 0 && TEST_readParallelBuffer(data, size - 3, executor, executorData) != NULL)
+    {
+        fprintf(stderr, "Reading a truncated chunk should fail!\n");
+        status = 1;
+    }
+
+    free(data);
+    return status;
+}
+
+static int checkParallelFile(const IFF_Chunk *chunk)
+{
+    IFF_Chunk *parallelChunk;
+    int status;
+
+    if(!TEST_write("parallel.TEST", chunk))
+    {
+        fprintf(stderr, "Cannot write the chunk to a file!\n");
+        return 1;
+    }
+
+    if((parallelChunk = TEST_readParallel("parallel.TEST", NUM_OF_THREADS)) == NULL)
+    {
+        fprintf(stderr, "Cannot read the file in parallel!\n");
+        return 1;
+    }
+
+    if(TEST_compare(chunk, parallelChunk))
+        status = 0;
+    else
+    {
+        fprintf(stderr, "The file that was read in parallel should be equal to the original!\n");
+        status = 1;
+    }
+
+    TEST_free(parallelChunk);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Chunk *cat = createTestCAT();
+    IFF_Chunk *list = createTestList();
+    IFF_Chunk *form = (IFF_Chunk*)IFF_createTestForm();
+    unsigned int numOfThreads = NUM_OF_THREADS;
+    int status;
+
+    status = checkParallelRead(cat, IFF_executeInThreads, &numOfThreads)
+        || checkParallelRead(cat, executeInReverse, NULL)
+        || checkParallelRead(list, IFF_executeInThreads, &numOfThreads)
+        || checkParallelRead(form, IFF_executeInThreads, &numOfThreads) /* A FORM is read sequentially */
+        || checkParallelFile(cat);
+
+    TEST_free(cat);
+    TEST_free(list);
+    TEST_free(form);
+
+    return status;
+}
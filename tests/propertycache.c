@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "iff.h"
+#include "group.h"
+#include "form.h"
+#include "list.h"
+#include "prop.h"
+#include "rawchunk.h"
+#include "id.h"
+
+#define ID_HELO IFF_MAKEID('H', 'E', 'L', 'O')
+#define ID_BYE IFF_MAKEID('B', 'Y', 'E', ' ')
+#define ID_TEST IFF_MAKEID('T', 'E', 'S', 'T')
+
+static IFF_Chunk *createTextChunk(const IFF_ID chunkId, const char *text)
+{
+    IFF_Long chunkSize = strlen(text);
+    IFF_RawChunk *rawChunk = (IFF_RawChunk*)IFF_createRawChunk(chunkId, chunkSize);
+    memcpy(rawChunk->chunkData, text, chunkSize);
+    return (IFF_Chunk*)rawChunk;
+}
+
+static int checkProperty(const IFF_Form *form, const IFF_ID chunkId, const char *text, const char *situation)
+{
+    IFF_RawChunk *rawChunk = (IFF_RawChunk*)IFF_getChunkFromForm(form, chunkId);
+
+    if(text == NULL)
+    {
+        if(rawChunk == NULL)
+            return 0;
+        else
+        {
+            fprintf(stderr, "No property should be found %s\n", situation);
+            return 1;
+        }
+    }
+    else if(rawChunk != NULL && rawChunk->chunkSize == strlen(text) && memcmp(rawChunk->chunkData, text, rawChunk->chunkSize) == 0)
+        return 0;
+    else
+    {
+        fprintf(stderr, "The property should be: '%s' %s\n", text, situation);
+        return 1;
+    }
+}
+
+/* Lists that are read build their lookup table on the first lookup */
+static int checkReadList(const IFF_List *list)
+{
+    IFF_UByte *data;
+    size_t size;
+    IFF_List *readList;
+    const IFF_List *innerList;
+    int status;
+
+    if(!IFF_writeBuffer((const IFF_Chunk*)list, &data, &size, NULL))
+    {
+        fprintf(stderr, "Cannot write the list!\n");
+        return 1;
+    }
+
+    if((readList = (IFF_List*)IFF_readBuffer(data, size, NULL)) == NULL)
+    {
+        fprintf(stderr, "Cannot read the list!\n");
+        free(data);
+        return 1;
+    }
+
+    innerList = (const IFF_List*)readList->chunk[0];
+    status = checkProperty((const IFF_Form*)innerList->chunk[0], ID_HELO, "outer", "in a list that has been read");
+
+    if(readList->propertyCache == NULL)
+    {
+        fprintf(stderr, "A lookup in a list that has been read should build its lookup table!\n");
+        status = 1;
+    }
+
+    IFF_free((IFF_Chunk*)readList, NULL);
+    free(data);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_List *outerList = IFF_createEmptyListWithContentsType(ID_TEST);
+    IFF_List *innerList = IFF_createEmptyListWithContentsType(ID_TEST);
+    IFF_Prop *outerProp = IFF_createEmptyProp(ID_TEST);
+    IFF_Prop *innerProp = IFF_createEmptyProp(ID_TEST);
+    IFF_Prop *otherProp = IFF_createEmptyProp(ID_TEST);
+    IFF_Form *form = IFF_createEmptyForm(ID_TEST);
+    IFF_Chunk *chunk;
+    int status = 0;
+
+    IFF_addToProp(outerProp, createTextChunk(ID_HELO, "outer"));
+    IFF_addToProp(outerProp, createTextChunk(ID_BYE, "outer"));
+    IFF_addPropToList(outerList, outerProp);
+    IFF_addToList(outerList, (IFF_Chunk*)innerList);
+
+    IFF_addToProp(innerProp, createTextChunk(ID_HELO, "inner"));
+    IFF_addPropToList(innerList, innerProp);
+    IFF_addToList(innerList, (IFF_Chunk*)form);
+
+    /* The lookup tables are built on first use, not while the lists are being filled */
+    if(outerList->propertyCache != NULL || innerList->propertyCache != NULL)
+    {
+        fprintf(stderr, "The lists should not have a lookup table before they are looked up!\n");
+        status = 1;
+    }
+
+    /* The inner PROP overrides the outer PROP */
+    status |= checkProperty(form, ID_HELO, "inner", "in the inner PROP");
+    status |= checkProperty(form, ID_BYE, "outer", "in the outer PROP");
+    status |= checkProperty(form, ID_TEST, NULL, "for a missing chunk");
+
+    /* Repeated lookups use the lookup tables that have been built */
+    status |= checkProperty(form, ID_HELO, "inner", "after a repeated lookup");
+
+    if(outerList->propertyCache == NULL || innerList->propertyCache == NULL)
+    {
+        fprintf(stderr, "The lookups should have built the lookup tables!\n");
+        status = 1;
+    }
+
+    /* Adding a chunk to a PROP only discards the lookup table of its list */
+    IFF_addToProp(innerProp, createTextChunk(ID_BYE, "inner"));
+
+    if(innerList->propertyCache != NULL)
+    {
+        fprintf(stderr, "Adding a chunk to a PROP should discard the lookup table!\n");
+        status = 1;
+    }
+
+    status |= checkProperty(form, ID_BYE, "inner", "after adding a chunk");
+
+    /* A table can also be built in advance */
+    IFF_invalidateListPropertyCache(innerList);
+
+    if(!IFF_cacheListProperties(innerList) || innerList->propertyCache == NULL)
+    {
+        fprintf(stderr, "Cannot build the lookup table in advance!\n");
+        status = 1;
+    }
+
+    status |= checkProperty(form, ID_BYE, "inner", "after building the table in advance");
+
+    /* Replacing and removing chunks also discard the lookup table */
+    chunk = IFF_replaceInGroup((IFF_Group*)innerProp, 0, createTextChunk(ID_HELO, "replaced"));
+    IFF_free(chunk, NULL);
+    status |= checkProperty(form, ID_HELO, "replaced", "after replacing a chunk");
+
+    chunk = IFF_removeFromGroup((IFF_Group*)innerProp, 0);
+    IFF_free(chunk, NULL);
+    status |= checkProperty(form, ID_HELO, "outer", "after removing a chunk");
+
+    /* Only the first PROP chunk with a given form type of a list is consulted */
+    IFF_addToProp(otherProp, createTextChunk(ID_HELO, "other"));
+    IFF_addPropToList(innerList, otherProp);
+    status |= checkProperty(form, ID_HELO, "outer", "after attaching a second PROP");
+
+    if(!IFF_check((IFF_Chunk*)outerList, NULL))
+        status = 1;
+
+    status |= checkReadList(outerList);
+
+    IFF_free((IFF_Chunk*)outerList, NULL);
+
+    return status;
+}
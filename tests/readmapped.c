@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <iff.h>
+#include <id.h>
+#include <form.h>
+#include <cat.h>
+#include <list.h>
+#include <prop.h>
+#include <rawchunk.h>
+#include "test.h"
+
+static int compareMappedRead(const char *filename)
+{
+    IFF_Chunk *chunk = IFF_read(filename, NULL);
+    IFF_Chunk *mappedChunk = IFF_readMapped(filename, NULL);
+    int status;
+
+    if(chunk == NULL || mappedChunk == NULL)
+    {
+        fprintf(stderr, "Cannot open '%s'\n", filename);
+        status = 1;
+    }
+    else if(!IFF_compare(chunk, mappedChunk, NULL))
+    {
+        fprintf(stderr, "The mapped read of '%s' should be equal to the regular read!\n", filename);
+        status = 1;
+    }
+    else
+        status = 0;
+
+    if(chunk != NULL)
+        IFF_free(chunk, NULL);
+
+    if(mappedChunk != NULL)
+        IFF_free(mappedChunk, NULL);
+
+    return status;
+}
+
+static IFF_Bool checkBorrowedChunkData(const IFF_Chunk *chunk, const IFF_MappedFile *mappedFile)
+{
+    if(chunk->chunkId == IFF_ID_FORM || chunk->chunkId == IFF_ID_CAT || chunk->chunkId == IFF_ID_LIST || chunk->chunkId == IFF_ID_PROP)
+    {
+        const IFF_Group *group = (const IFF_Group*)chunk;
+        unsigned int i;
+
+        for(i = 0; i < group->chunkLength; i++)
+        {
+            if(!checkBorrowedChunkData(group->chunk[i], mappedFile))
+                return FALSE;
+        }
+
+        if(chunk->chunkId == IFF_ID_LIST)
+        {
+            const IFF_List *list = (const IFF_List*)chunk;
+
+            for(i = 0; i < list->propLength; i++)
+            {
+                if(!checkBorrowedChunkData((const IFF_Chunk*)list->prop[i], mappedFile))
+                    return FALSE;
+            }
+        }
+
+        return TRUE;
+    }
+    else
+    {
+        const IFF_RawChunk *rawChunk = (const IFF_RawChunk*)chunk;
+
+        return rawChunk->chunkDataBorrowed
+            && rawChunk->chunkData >= mappedFile->data
+            && rawChunk->chunkData + rawChunk->chunkSize <= mappedFile->data + mappedFile->size;
+    }
+}
+
+static int compareBorrowedRead(const char *filename)
+{
+    IFF_MappedFile mappedFile;
+    IFF_Chunk *chunk, *borrowedChunk;
+    int status;
+
+    if(!IFF_openMappedFile(&mappedFile, filename))
+        return 1;
+
+    chunk = IFF_read(filename, NULL);
+    borrowedChunk = IFF_readMappedFile(&mappedFile, NULL);
+
+    if(chunk == NULL || borrowedChunk == NULL)
+    {
+        fprintf(stderr, "Cannot open '%s'\n", filename);
+        status = 1;
+    }
+    else if(!IFF_compare(chunk, borrowedChunk, NULL))
+    {
+        fprintf(stderr, "The borrowed read of '%s' should be equal to the regular read!\n", filename);
+        status = 1;
+    }
+    else if(!checkBorrowedChunkData(borrowedChunk, &mappedFile))
+    {
+        fprintf(stderr, "The raw chunks of '%s' should refer to the mapped file!\n", filename);
+        status = 1;
+    }
+    else
+        status = 0;
+
+    if(chunk != NULL)
+        IFF_free(chunk, NULL);
+
+    if(borrowedChunk != NULL)
+        IFF_free(borrowedChunk, NULL);
+
+    IFF_closeMappedFile(&mappedFile);
+
+    return status;
+}
+
+static int compareMappedExtensionRead(const char *filename)
+{
+    IFF_Chunk *chunk = TEST_read(filename);
+    IFF_Chunk *mappedChunk = TEST_readMapped(filename);
+    int status;
+
+    if(chunk == NULL || mappedChunk == NULL)
+    {
+        fprintf(stderr, "Cannot open '%s'\n", filename);
+        status = 1;
+    }
+    else if(!TEST_compare(chunk, mappedChunk))
+    {
+        fprintf(stderr, "The mapped read of '%s' should be equal to the regular read!\n", filename);
+        status = 1;
+    }
+    else
+        status = 0;
+
+    if(chunk != NULL)
+        TEST_free(chunk);
+
+    if(mappedChunk != NULL)
+        TEST_free(mappedChunk);
+
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc < 2)
+    {
+        fprintf(stderr, "Usage: %s file.IFF [extension]\n", argv[0]);
+        return 1;
+    }
+    else if(argc > 2 && strcmp(argv[2], "extension") == 0)
+        return compareMappedExtensionRead(argv[1]);
+    else
+        return compareMappedRead(argv[1]) || compareBorrowedRead(argv[1]);
+}
@@ -0,0 +1,6 @@
+#!/bin/sh -e
+
+./readmapped lookupproperty-nested.TEST
+./readmapped lookupproperty-override.TEST
+./readmapped extension-otherform.TEST
+./readmapped extension-otherform.TEST extension
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include "iff.h"
+#include "form.h"
+#include "group.h"
+#include "rawchunk.h"
+#include "id.h"
+
+#define NUM_OF_CHUNKS 1000
+
+#define ID_ABCD IFF_MAKEID('A', 'B', 'C', 'D')
+#define ID_TEST IFF_MAKEID('T', 'E', 'S', 'T')
+
+static void addChunks(IFF_Form *form)
+{
+    unsigned int i;
+
+    for(i = 0; i < NUM_OF_CHUNKS; i++)
+        IFF_addToForm(form, IFF_createRawChunk(ID_ABCD, 0));
+}
+
+static int checkReservedForm(void)
+{
+    IFF_Form *form = IFF_createEmptyForm(ID_TEST);
+    IFF_Chunk **chunk;
+    int status;
+
+    if(!IFF_reserveGroup((IFF_Group*)form, NUM_OF_CHUNKS))
+        return 1;
+
+    chunk = form->chunk;
+    addChunks(form);
+
+    /* The sub chunk array should not have been reallocated */
+    if(form->chunk != chunk || form->chunkCapacity != NUM_OF_CHUNKS)
+    {
+        fprintf(stderr, "The reserved sub chunk array should not be reallocated!\n");
+        status = 1;
+    }
+    else if(!IFF_check((IFF_Chunk*)form, NULL))
+        status = 1;
+    else
+        status = 0;
+
+    IFF_free((IFF_Chunk*)form, NULL);
+    return status;
+}
+
+static int checkGrowingForm(void)
+{
+    IFF_Form *form = IFF_createEmptyForm(ID_TEST);
+    int status;
+
+    addChunks(form);
+
+    /* The capacity should grow geometrically, so it is never more than twice the amount of chunks */
+    if(form->chunkLength != NUM_OF_CHUNKS || form->chunkCapacity < form->chunkLength || form->chunkCapacity >= 2 * form->chunkLength)
+    {
+        fprintf(stderr, "Unexpected capacity: %u for: %u sub chunks\n", form->chunkCapacity, form->chunkLength);
+        status = 1;
+    }
+    else if(!IFF_check((IFF_Chunk*)form, NULL))
+        status = 1;
+    else
+        status = 0;
+
+    IFF_free((IFF_Chunk*)form, NULL);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    return checkReservedForm() || checkGrowingForm();
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <memorystream.h>
+#include <fdstream.h>
+#include "test.h"
+#include "extensiondata.h"
+
+#define BUFFER_SIZE 1024
+
+static int checkMemoryStream(const IFF_Chunk *chunk)
+{
+    IFF_UByte buffer[BUFFER_SIZE];
+    IFF_MemoryIOStream stream;
+    IFF_Chunk *readChunk;
+    int status;
+
+    /* Write the chunk into the buffer */
+    IFF_initMemoryIOStream(&stream, buffer, BUFFER_SIZE);
+
+    if(!TEST_writeStream((IFF_IOStream*)&stream, chunk))
+    {
+        fprintf(stderr, "Cannot write the chunk to a memory stream!\n");
+        return 1;
+    }
+
+    /* Read it back from the part of the buffer that has been written */
+    IFF_initMemoryIOStream(&stream, buffer, stream.position);
+
+    if((readChunk = TEST_readStream((IFF_IOStream*)&stream)) == NULL)
+    {
+        fprintf(stderr, "Cannot read the chunk from a memory stream!\n");
+        return 1;
+    }
+
+    if(TEST_compare(chunk, readChunk))
+        status = 0;
+    else
+    {
+        fprintf(stderr, "The chunk read from a memory stream should be equal to the original!\n");
+        status = 1;
+    }
+
+    TEST_free(readChunk);
+    return status;
+}
+
+static int checkFdStream(const IFF_Chunk *chunk)
+{
+    IFF_FdIOStream stream;
+    IFF_Chunk *readChunk;
+    int fd, status;
+
+    /* Write the chunk through a raw file descriptor */
+    if((fd = open("streams.TEST", O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1)
+    {
+        fprintf(stderr, "Cannot open streams.TEST!\n");
+        return 1;
+    }
+
+    IFF_initFdIOStream(&stream, fd);
+    status = TEST_writeStream((IFF_IOStream*)&stream, chunk);
+    close(fd);
+
+    if(!status)
+    {
+        fprintf(stderr, "Cannot write the chunk to a file descriptor stream!\n");
+        return 1;
+    }
+
+    /* Read it back with the regular file reader */
+    if((readChunk = TEST_read("streams.TEST")) == NULL)
+        return 1;
+
+    if(TEST_compare(chunk, readChunk))
+        status = 0;
+    else
+    {
+        fprintf(stderr, "The chunk written to a file descriptor stream should be equal to the original!\n");
+        status = 1;
+    }
+
+    TEST_free(readChunk);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Form *form = IFF_createTestForm();
+    int status = checkMemoryStream((IFF_Chunk*)form) || checkFdStream((IFF_Chunk*)form);
+    TEST_free((IFF_Chunk*)form);
+    return status;
+}
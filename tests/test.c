@@ -48,16 +48,71 @@ IFF_Chunk *TEST_read(const char *filename)
     return IFF_read(filename, &chunkRegistry);
 }
 
+IFF_Chunk *TEST_readMapped(const char *filename)
+{
+    return IFF_readMapped(filename, &chunkRegistry);
+}
+
+IFF_Chunk *TEST_readStream(IFF_IOStream *stream)
+{
+    return IFF_readStream(stream, &chunkRegistry);
+}
+
+IFF_Chunk *TEST_readBuffer(const IFF_UByte *data, const size_t size)
+{
+    return IFF_readBuffer(data, size, &chunkRegistry);
+}
+
+IFF_Chunk *TEST_readLazyStream(IFF_IOStream *stream)
+{
+    return IFF_readLazyStream(stream, &chunkRegistry);
+}
+
+IFF_Chunk *TEST_readParallelBuffer(const IFF_UByte *data, const size_t size, IFF_Executor executor, void *executorData)
+{
+    return IFF_readParallelBuffer(data, size, &chunkRegistry, executor, executorData);
+}
+
+IFF_Chunk *TEST_readParallel(const char *filename, const unsigned int numOfThreads)
+{
+    return IFF_readParallel(filename, &chunkRegistry, numOfThreads);
+}
+
+IFF_Chunk *TEST_readIndexedChunk(IFF_IOStream *stream, const IFF_IndexEntry *entry)
+{
+    return IFF_readIndexedChunk(stream, entry, &chunkRegistry);
+}
+
+IFF_Bool TEST_visitStream(IFF_IOStream *stream, const IFF_Visitor *visitor, void *data)
+{
+    return IFF_visitStream(stream, &chunkRegistry, visitor, data);
+}
+
 IFF_Bool TEST_write(const char *filename, const IFF_Chunk *chunk)
 {
     return IFF_write(filename, chunk, &chunkRegistry);
 }
 
+IFF_Bool TEST_writeStream(IFF_IOStream *stream, const IFF_Chunk *chunk)
+{
+    return IFF_writeStream(stream, chunk, &chunkRegistry);
+}
+
+IFF_Bool TEST_writeBuffer(const IFF_Chunk *chunk, IFF_UByte **data, size_t *size)
+{
+    return IFF_writeBuffer(chunk, data, size, &chunkRegistry);
+}
+
 void TEST_free(IFF_Chunk *chunk)
 {
     IFF_free(chunk, &chunkRegistry);
 }
 
+void TEST_freeChunk(IFF_Chunk *chunk, const IFF_ID formType)
+{
+    IFF_freeChunk(chunk, formType, &chunkRegistry);
+}
+
 IFF_Bool TEST_check(const IFF_Chunk *chunk)
 {
     return IFF_check(chunk, &chunkRegistry);
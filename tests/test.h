@@ -22,15 +22,41 @@
 #ifndef __TEST_H
 #define __TEST_H
 #include "chunk.h"
+#include "stream.h"
+#include "visitor.h"
+#include "index.h"
+#include "parallel.h"
 
 #define TEST_ID_TEST IFF_MAKEID('T', 'E', 'S', 'T')
 
 IFF_Chunk *TEST_read(const char *filename);
 
+IFF_Chunk *TEST_readMapped(const char *filename);
+
+IFF_Chunk *TEST_readStream(IFF_IOStream *stream);
+
+IFF_Chunk *TEST_readBuffer(const IFF_UByte *data, const size_t size);
+
+IFF_Chunk *TEST_readLazyStream(IFF_IOStream *stream);
+
+IFF_Chunk *TEST_readParallelBuffer(const IFF_UByte *data, const size_t size, IFF_Executor executor, void *executorData);
+
+IFF_Chunk *TEST_readParallel(const char *filename, const unsigned int numOfThreads);
+
+IFF_Chunk *TEST_readIndexedChunk(IFF_IOStream *stream, const IFF_IndexEntry *entry);
+
+IFF_Bool TEST_visitStream(IFF_IOStream *stream, const IFF_Visitor *visitor, void *data);
+
 IFF_Bool TEST_write(const char *filename, const IFF_Chunk *chunk);
 
+IFF_Bool TEST_writeStream(IFF_IOStream *stream, const IFF_Chunk *chunk);
+
+IFF_Bool TEST_writeBuffer(const IFF_Chunk *chunk, IFF_UByte **data, size_t *size);
+
 void TEST_free(IFF_Chunk *chunk);
 
+void TEST_freeChunk(IFF_Chunk *chunk, const IFF_ID formType);
+
 IFF_Bool TEST_check(const IFF_Chunk *chunk);
 
 void TEST_print(const IFF_Chunk *chunk, const unsigned int indentLevel);
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "iff.h"
+#include "context.h"
+#include "error.h"
+#include "memorystream.h"
+
+static const IFF_UByte validCAT[] = {
+    'C', 'A', 'T', ' ', 0, 0, 0, 28, 'T', 'E', 'S', 'T',
+    'F', 'O', 'R', 'M', 0, 0, 0, 16, 'T', 'E', 'S', 'T',
+    'A', 'B', 'C', 'D', 0, 0, 0, 4, 'a', 'b', 'c', 'd'
+};
+
+/* The form type is reserved. The error should be detected right after reading it */
+static const IFF_UByte reservedFormType[] = {
+    'F', 'O', 'R', 'M', 0, 0, 0, 16, 'F', 'O', 'R', '1',
+    'A', 'B', 'C', 'D', 0, 0, 0, 4, 'a', 'b', 'c', 'd'
+};
+
+/* The sub chunk claims 1000000 bytes, while the FORM only has 4 bytes left */
+static const IFF_UByte oversizedSubChunk[] = {
+    'F', 'O', 'R', 'M', 0, 0, 0, 12, 'T', 'E', 'S', 'T',
+    'A', 'B', 'C', 'D', 0, 0x0f, 0x42, 0x40
+};
+
+/* The form type of the FORM does not match the contents type of the CAT */
+static const IFF_UByte mismatchingContentsType[] = {
+    'C', 'A', 'T', ' ', 0, 0, 0, 28, 'T', 'E', 'S', 'T',
+    'F', 'O', 'R', 'M', 0, 0, 0, 16, 'O', 'T', 'H', 'R',
+    'A', 'B', 'C', 'D', 0, 0, 0, 4, 'a', 'b', 'c', 'd'
+};
+
+/* A FORM may not contain a PROP */
+static const IFF_UByte propInForm[] = {
+    'F', 'O', 'R', 'M', 0, 0, 0, 16, 'T', 'E', 'S', 'T',
+    'P', 'R', 'O', 'P', 0, 0, 0, 4, 'T', 'E', 'S', 'T'
+};
+
+/* The contents type of the LIST contains an illegal character */
+static const IFF_UByte illegalContentsType[] = {
+    'L', 'I', 'S', 'T', 0, 0, 0, 4, 1, 'A', 'B', 'C'
+};
+
+/* The main chunk must be a FORM, CAT or LIST */
+static const IFF_UByte dataMainChunk[] = {
+    'A', 'B', 'C', 'D', 0, 0, 0, 4, 'a', 'b', 'c', 'd'
+};
+
+static void discardMessage(const char *formatString, va_list ap)
+{
+}
+
+static IFF_Chunk *readValidated(const IFF_UByte *data, const size_t size, IFF_Context *context)
+{
+    IFF_MemoryIOStream stream;
+    IFF_Chunk *chunk;
+
+    IFF_initContext(context);
+    IFF_initMemoryIOStream(&stream, (IFF_UByte*)data, size);
+
+    IFF_selectContext(context);
+    chunk = IFF_readValidatedStream((IFF_IOStream*)&stream, NULL);
+    IFF_selectContext(NULL);
+
+    return chunk;
+}
+
+static int checkAccepted(const IFF_UByte *data, const size_t size)
+{
+    IFF_Context context;
+    IFF_MemoryIOStream stream;
+    IFF_Chunk *chunk = readValidated(data, size, &context), *uncheckedChunk;
+    int status = 0;
+
+    if(chunk == NULL)
+    {
+        fprintf(stderr, "A valid file should be accepted, but the read failed with: %s\n", IFF_errorCodeToString(context.errorCode));
+        return 1;
+    }
+
+    /* The result should be identical to a regular read */
+    IFF_initMemoryIOStream(&stream, (IFF_UByte*)data, size);
+    uncheckedChunk = IFF_readStream((IFF_IOStream*)&stream, NULL);
+
+    if(uncheckedChunk == NULL || !IFF_compare(chunk, uncheckedChunk, NULL))
+    {
+        fprintf(stderr, "A validated read should produce the same chunk hierarchy as a regular read!\n");
+        status = 1;
+    }
+
+    IFF_free(chunk, NULL);
+
+    if(uncheckedChunk != NULL)
+        IFF_free(uncheckedChunk, NULL);
+
+    return status;
+}
+
+static int checkRejected(const char *description, const IFF_UByte *data, const size_t size, const long offset)
+{
+    IFF_Context context;
+    IFF_Chunk *chunk = readValidated(data, size, &context);
+
+    if(chunk != NULL)
+    {
+        fprintf(stderr, "A file with %s should be rejected!\n", description);
+        IFF_free(chunk, NULL);
+        return 1;
+    }
+
+    if(context.errorCode != IFF_ERROR_INVALID)
+    {
+        fprintf(stderr, "A file with %s should be rejected as invalid data, but the error is: %s\n", description, IFF_errorCodeToString(context.errorCode));
+        return 1;
+    }
+
+    /* The read should stop right after the violating field */
+    if(context.offset != offset)
+    {
+        fprintf(stderr, "A file with %s should be rejected at offset: %ld, but it is rejected at: %ld\n", description, offset, context.offset);
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int status = 0;
+
+    IFF_errorCallback = &discardMessage;
+
+    status |= checkAccepted(validCAT, sizeof(validCAT));
+    status |= checkRejected("a reserved form type", reservedFormType, sizeof(reservedFormType), 12);
+    status |= checkRejected("an oversized sub chunk", oversizedSubChunk, sizeof(oversizedSubChunk), 20);
+    status |= checkRejected("a mismatching contents type", mismatchingContentsType, sizeof(mismatchingContentsType), 36);
+    status |= checkRejected("a PROP in a FORM", propInForm, sizeof(propInForm), 24);
+    status |= checkRejected("an illegal contents type", illegalContentsType, sizeof(illegalContentsType), 12);
+    status |= checkRejected("a data chunk as main chunk", dataMainChunk, sizeof(dataMainChunk), -1);
+
+    /* The validation should only apply to the validated reads */
+    if(IFF_getValidateOnRead())
+    {
+        fprintf(stderr, "Validate-on-read should be disabled after a validated read!\n");
+        status = 1;
+    }
+
+    return status;
+}
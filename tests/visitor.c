@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <memorystream.h>
+#include <cat.h>
+#include <form.h>
+#include "test.h"
+#include "hello.h"
+#include "extensiondata.h"
+
+typedef struct
+{
+    unsigned int numOfGroups;
+    unsigned int numOfEndedGroups;
+    unsigned int numOfChunks;
+    unsigned int numOfHellos;
+    IFF_Bool stopAtFirstChunk;
+}
+Statistics;
+
+static IFF_VisitAction beginGroup(void *data, const IFF_ID chunkId, const IFF_Long chunkSize, const IFF_ID groupType)
+{
+    Statistics *statistics = (Statistics*)data;
+    statistics->numOfGroups++;
+    return IFF_VISIT_DESCEND;
+}
+
+static IFF_Bool endGroup(void *data, const IFF_ID chunkId, const IFF_ID groupType)
+{
+    Statistics *statistics = (Statistics*)data;
+    statistics->numOfEndedGroups++;
+    return TRUE;
+}
+
+static IFF_Bool visitChunk(void *data, const IFF_ID formType, const IFF_Chunk *chunk)
+{
+    Statistics *statistics = (Statistics*)data;
+
+    statistics->numOfChunks++;
+
+    /* A HELO chunk in a TEST form should have been parsed by the TEST registry */
+    if(formType == TEST_ID_TEST && chunk->chunkId == TEST_ID_HELO)
+    {
+        const TEST_Hello *hello = (const TEST_Hello*)chunk;
+
+        if(hello->a == 'a' && hello->b == 'b' && hello->c == 4096)
+            statistics->numOfHellos++;
+    }
+
+    return !statistics->stopAtFirstChunk;
+}
+
+static IFF_VisitAction skipForms(void *data, const IFF_ID formType, const IFF_ID chunkId, const IFF_Long chunkSize)
+{
+    return chunkId == IFF_ID_CAT ? IFF_VISIT_DESCEND : IFF_VISIT_SKIP;
+}
+
+static IFF_Bool visit(const IFF_UByte *data, const size_t size, const IFF_Visitor *visitor, Statistics *statistics)
+{
+    IFF_MemoryIOStream stream;
+    IFF_initMemoryIOStream(&stream, (IFF_UByte*)data, size);
+
+    statistics->numOfGroups = 0;
+    statistics->numOfEndedGroups = 0;
+    statistics->numOfChunks = 0;
+    statistics->numOfHellos = 0;
+
+    return TEST_visitStream((IFF_IOStream*)&stream, visitor, statistics);
+}
+
+static int checkVisitor(const IFF_UByte *data, const size_t size)
+{
+    IFF_Visitor visitor = { NULL, beginGroup, endGroup, visitChunk };
+    Statistics statistics;
+
+    /* Visit all chunks */
+    statistics.stopAtFirstChunk = FALSE;
+
+    if(!visit(data, size, &visitor, &statistics))
+    {
+        fprintf(stderr, "Cannot visit the chunks!\n");
+        return 1;
+    }
+
+    if(statistics.numOfGroups != 3 || statistics.numOfEndedGroups != 3)
+    {
+        fprintf(stderr, "We should have visited 3 groups, but we have visited: %u and ended: %u\n", statistics.numOfGroups, statistics.numOfEndedGroups);
+        return 1;
+    }
+
+    if(statistics.numOfChunks != 4 || statistics.numOfHellos != 2)
+    {
+        fprintf(stderr, "We should have visited 4 chunks of which 2 are hellos, but we have visited: %u and %u\n", statistics.numOfChunks, statistics.numOfHellos);
+        return 1;
+    }
+
+    /* Stop after the first data chunk */
+    statistics.stopAtFirstChunk = TRUE;
+
+    if(!visit(data, size, &visitor, &statistics))
+    {
+        fprintf(stderr, "Cannot visit the chunks!\n");
+        return 1;
+    }
+
+    if(statistics.numOfChunks != 1 || statistics.numOfEndedGroups != 0)
+    {
+        fprintf(stderr, "The visitor should have stopped after the first chunk, but it has visited: %u chunks\n", statistics.numOfChunks);
+        return 1;
+    }
+
+    /* Skip the FORMs inside the CAT */
+    visitor.visitChunkHeader = skipForms;
+    statistics.stopAtFirstChunk = FALSE;
+
+    if(!visit(data, size, &visitor, &statistics))
+    {
+        fprintf(stderr, "Cannot visit the chunks!\n");
+        return 1;
+    }
+
+    if(statistics.numOfGroups != 1 || statistics.numOfChunks != 0)
+    {
+        fprintf(stderr, "We should have only visited the CAT, but we have visited: %u groups and %u chunks\n", statistics.numOfGroups, statistics.numOfChunks);
+        return 1;
+    }
+
+    return 0;
+}
+
+/* A FORM that is too small for a form type should not consume the header of the chunk that follows it */
+static int checkZeroSizeForm(void)
+{
+    static const IFF_UByte data[] = {
+        'C', 'A', 'T', ' ', 0, 0, 0, 24, 'J', 'J', 'J', 'J',
+        'F', 'O', 'R', 'M', 0, 0, 0, 0,
+        'D', 'A', 'T', 'A', 0, 0, 0, 4, 'a', 'b', 'c', 'd'
+    };
+    IFF_Visitor visitor = { NULL, beginGroup, endGroup, visitChunk };
+    Statistics statistics;
+
+    statistics.stopAtFirstChunk = FALSE;
+
+    if(!visit(data, sizeof(data), &visitor, &statistics))
+    {
+        fprintf(stderr, "Cannot visit the chunks after a zero size FORM!\n");
+        return 1;
+    }
+
+    if(statistics.numOfGroups != 2 || statistics.numOfEndedGroups != 2 || statistics.numOfChunks != 1)
+    {
+        fprintf(stderr, "We should have visited 2 groups and the chunk after the zero size FORM, but we have visited: %u groups and %u chunks\n", statistics.numOfGroups, statistics.numOfChunks);
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_CAT *cat = IFF_createEmptyCAT();
+    IFF_UByte *data;
+    size_t size;
+    int status;
+
+    IFF_addToCAT(cat, (IFF_Chunk*)IFF_createTestForm());
+    IFF_addToCAT(cat, (IFF_Chunk*)IFF_createTestForm());
+
+    if(!TEST_writeBuffer((IFF_Chunk*)cat, &data, &size))
+    {
+        fprintf(stderr, "Cannot write the chunk to a buffer!\n");
+        status = 1;
+    }
+    else
+    {
+        status = checkVisitor(data, size);
+        free(data);
+
+        if(status == 0)
+            status = checkZeroSizeForm();
+    }
+
+    TEST_free((IFF_Chunk*)cat);
+    return status;
+}
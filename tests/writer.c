@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <writer.h>
+#include <iff.h>
+#include <cat.h>
+#include <form.h>
+#include <group.h>
+#include <rawchunk.h>
+#include <memorystream.h>
+#include "test.h"
+
+#define ID_DATA IFF_MAKEID('D', 'A', 'T', 'A')
+#define ID_ODD IFF_MAKEID('O', 'D', 'D', ' ')
+
+static IFF_UByte oddData[] = { 'a', 'b', 'c' };
+static IFF_UByte data[] = { 1, 2, 3, 4 };
+
+/*
+ * A stream that cannot seek or tell its position, such as a pipe
+ */
+typedef struct
+{
+    size_t (*read) (IFF_IOStream *stream, void *buffer, const size_t size);
+    size_t (*write) (IFF_IOStream *stream, const void *buffer, const size_t size);
+    IFF_Bool (*seek) (IFF_IOStream *stream, const long offset, const int origin);
+    long (*tell) (IFF_IOStream *stream);
+    IFF_Bool sparse;
+
+    IFF_MemoryIOStream memoryStream;
+}
+PipeIOStream;
+
+static size_t readPipe(IFF_IOStream *stream, void *buffer, const size_t size)
+{
+    IFF_IOStream *memoryStream = (IFF_IOStream*)&((PipeIOStream*)stream)->memoryStream;
+    return memoryStream->read(memoryStream, buffer, size);
+}
+
+static size_t writePipe(IFF_IOStream *stream, const void *buffer, const size_t size)
+{
+    IFF_IOStream *memoryStream = (IFF_IOStream*)&((PipeIOStream*)stream)->memoryStream;
+    return memoryStream->write(memoryStream, buffer, size);
+}
+
+static IFF_Bool seekPipe(IFF_IOStream *stream, const long offset, const int origin)
+{
+    return FALSE;
+}
+
+static long tellPipe(IFF_IOStream *stream)
+{
+    return -1;
+}
+
+static IFF_Chunk *createExpectedCAT(void)
+{
+    IFF_CAT *cat = IFF_createEmptyCAT();
+    IFF_Form *form1 = IFF_createEmptyForm(TEST_ID_TEST);
+    IFF_Form *form2 = IFF_createEmptyForm(TEST_ID_TEST);
+
+    IFF_addToForm(form1, IFF_createBorrowedRawChunk(ID_ODD, sizeof(oddData), oddData));
+    IFF_addToForm(form1, IFF_createBorrowedRawChunk(ID_DATA, sizeof(data), data));
+    IFF_addToForm(form2, IFF_createBorrowedRawChunk(ID_DATA, sizeof(data), data));
+
+    IFF_addToCAT(cat, (IFF_Chunk*)form1);
+    IFF_addToCAT(cat, (IFF_Chunk*)form2);
+
+    IFF_updateChunkSizes((IFF_Chunk*)cat);
+
+    return (IFF_Chunk*)cat;
+}
+
+static IFF_Bool writeCAT(IFF_IOStream *stream)
+{
+    IFF_Writer *writer = IFF_createWriter(stream, NULL);
+    IFF_Chunk *dataChunk = IFF_createBorrowedRawChunk(ID_DATA, sizeof(data), data);
+    IFF_Bool status;
+
+    status = writer != NULL && dataChunk != NULL
+        && IFF_beginGroup(writer, IFF_ID_CAT, IFF_ID_JJJJ)
+        && IFF_beginGroup(writer, IFF_ID_FORM, TEST_ID_TEST)
+        && IFF_writeDataChunk(writer, ID_ODD, oddData, sizeof(oddData))
+        && IFF_writeDataChunk(writer, ID_DATA, data, sizeof(data))
+        && IFF_endGroup(writer)
+        && IFF_beginGroup(writer, IFF_ID_FORM, TEST_ID_TEST)
+        && IFF_writeChunkWithWriter(writer, dataChunk)
+        && IFF_endGroup(writer)
+        && IFF_endGroup(writer);
+
+    if(writer != NULL)
+    {
+        /* There are no more groups to end */
+        if(status && IFF_endGroup(writer))
+        {
+            fprintf(stderr, "Ending a group should fail if no group is open!\n");
+            status = FALSE;
+        }
+
+        IFF_freeWriter(writer);
+    }
+
+    IFF_free(dataChunk, NULL);
+    return status;
+}
+
+static int compareOutput(const IFF_UByte *outputData, const size_t outputSize, const IFF_UByte *expectedData, const size_t expectedSize, const char *description)
+{
+    if(outputSize != expectedSize || memcmp(outputData, expectedData, expectedSize) != 0)
+    {
+        fprintf(stderr, "The output written to a %s stream differs from the output of IFF_writeBuffer()!\n", description);
+        return 1;
+    }
+    else
+        return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Chunk *cat = createExpectedCAT();
+    IFF_UByte *expectedData;
+    size_t expectedSize;
+    IFF_MemoryIOStream memoryStream;
+    PipeIOStream pipeStream;
+    int status = 1;
+
+    if(!IFF_writeBuffer(cat, &expectedData, &expectedSize, NULL))
+    {
+        fprintf(stderr, "Cannot write the expected CAT!\n");
+        IFF_free(cat, NULL);
+        return 1;
+    }
+
+    /* Write to a seekable stream, in which the sizes are patched */
+    IFF_initGrowableMemoryIOStream(&memoryStream, 16);
+
+    if(!writeCAT((IFF_IOStream*)&memoryStream))
+        fprintf(stderr, "Cannot write the CAT to a seekable stream!\n");
+    else if(compareOutput(memoryStream.data, memoryStream.position, expectedData, expectedSize, "seekable") == 0)
+    {
+        /* Write to a stream that cannot seek, in which the groups are buffered */
+        pipeStream.read = &readPipe;
+        pipeStream.write = &writePipe;
+        pipeStream.seek = &seekPipe;
+        pipeStream.tell = &tellPipe;
+        pipeStream.sparse = FALSE;
+        IFF_initGrowableMemoryIOStream(&pipeStream.memoryStream, 16);
+
+        if(!writeCAT((IFF_IOStream*)&pipeStream))
+            fprintf(stderr, "Cannot write the CAT to a non-seekable stream!\n");
+        else
+            status = compareOutput(pipeStream.memoryStream.data, pipeStream.memoryStream.position, expectedData, expectedSize, "non-seekable");
+
+        free(pipeStream.memoryStream.data);
+    }
+
+    free(memoryStream.data);
+    free(expectedData);
+    IFF_free(cat, NULL);
+    return status;
+}
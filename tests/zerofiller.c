@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <io.h>
+#include <filestream.h>
+#include <memorystream.h>
+#include <id.h>
+
+#define ID_FILL IFF_MAKEID('F', 'I', 'L', 'L')
+#define LARGE_FILLER_SIZE 1000000
+#define EXISTING_DATA_SIZE 200000
+
+static int checkBytes(FILE *file, const long offset, const long size, const int expectedValue)
+{
+    long i;
+
+    if(fseek(file, offset, SEEK_SET) != 0)
+        return 1;
+
+    for(i = 0; i < size; i++)
+    {
+        if(fgetc(file) != expectedValue)
+        {
+            fprintf(stderr, "Byte at offset: %ld should be: %d!\n", offset + i, expectedValue);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* A large filler at the end of a file is written as a hole */
+static int checkFillerAtEndOfFile(void)
+{
+    FILE *file = fopen("zerofiller.TEST", "w+b");
+    IFF_FileIOStream stream;
+    int status;
+
+    if(file == NULL)
+        return 1;
+
+    IFF_initFileIOStream(&stream, file);
+
+    if(!IFF_writeUByte((IFF_IOStream*)&stream, 0xff, ID_FILL, "before")
+        || !IFF_writeZeroFillerBytes((IFF_IOStream*)&stream, ID_FILL, LARGE_FILLER_SIZE, 0)
+        || !IFF_writeUByte((IFF_IOStream*)&stream, 0xff, ID_FILL, "after"))
+    {
+        fprintf(stderr, "Cannot write the filler at the end of the file!\n");
+        status = 1;
+    }
+    else if(ftell(file) != LARGE_FILLER_SIZE + 2)
+    {
+        fprintf(stderr, "The filler should extend the file by: %d bytes!\n", LARGE_FILLER_SIZE);
+        status = 1;
+    }
+    else
+        status = checkBytes(file, 0, 1, 0xff) || checkBytes(file, 1, LARGE_FILLER_SIZE, 0) || checkBytes(file, LARGE_FILLER_SIZE + 1, 1, 0xff);
+
+    fclose(file);
+    return status;
+}
+
+/* A large filler that overwrites existing data must write the zeros */
+static int checkFillerOverExistingData(void)
+{
+    FILE *file = fopen("zerofiller.TEST", "w+b");
+    IFF_FileIOStream stream;
+    long i;
+    int status;
+
+    if(file == NULL)
+        return 1;
+
+    for(i = 0; i < EXISTING_DATA_SIZE; i++)
+        fputc(0xff, file);
+
+    fseek(file, 10, SEEK_SET);
+    IFF_initFileIOStream(&stream, file);
+
+    if(!IFF_writeZeroFillerBytes((IFF_IOStream*)&stream, ID_FILL, EXISTING_DATA_SIZE - 20, 0))
+    {
+        fprintf(stderr, "Cannot write the filler over existing data!\n");
+        status = 1;
+    }
+    else if(ftell(file) != EXISTING_DATA_SIZE - 10)
+    {
+        fprintf(stderr, "The filler should end at offset: %d!\n", EXISTING_DATA_SIZE - 10);
+        status = 1;
+    }
+    else
+        status = checkBytes(file, 0, 10, 0xff) || checkBytes(file, 10, EXISTING_DATA_SIZE - 20, 0) || checkBytes(file, EXISTING_DATA_SIZE - 10, 10, 0xff);
+
+    fclose(file);
+    return status;
+}
+
+/* In append mode, every write goes to the end of the file, so the zeros must be written */
+static int checkFillerInAppendMode(void)
+{
+    FILE *file = fopen("zerofiller.TEST", "wb");
+    IFF_FileIOStream stream;
+    int status;
+
+    if(file == NULL)
+        return 1;
+
+    fclose(file);
+
+    if((file = fopen("zerofiller.TEST", "a+b")) == NULL)
+        return 1;
+
+    IFF_initFileIOStream(&stream, file);
+
+    if(!IFF_writeUByte((IFF_IOStream*)&stream, 0xff, ID_FILL, "before")
+        || !IFF_writeZeroFillerBytes((IFF_IOStream*)&stream, ID_FILL, LARGE_FILLER_SIZE, 0)
+        || !IFF_writeUByte((IFF_IOStream*)&stream, 0xff, ID_FILL, "after"))
+    {
+        fprintf(stderr, "Cannot write the filler to a file in append mode!\n");
+        status = 1;
+    }
+    else if(fseek(file, 0, SEEK_END) != 0 || ftell(file) != LARGE_FILLER_SIZE + 2)
+    {
+        fprintf(stderr, "The filler should extend the file in append mode by: %d bytes!\n", LARGE_FILLER_SIZE);
+        status = 1;
+    }
+    else
+        status = checkBytes(file, 0, 1, 0xff) || checkBytes(file, 1, LARGE_FILLER_SIZE, 0) || checkBytes(file, LARGE_FILLER_SIZE + 1, 1, 0xff);
+
+    fclose(file);
+    return status;
+}
+
+/* Memory streams cannot seek beyond their end, so the zeros are written */
+static int checkFillerInMemory(const IFF_Long fillerSize)
+{
+    IFF_MemoryIOStream stream;
+    int status = 0;
+
+    IFF_initGrowableMemoryIOStream(&stream, 16);
+
+    if(!IFF_writeZeroFillerBytes((IFF_IOStream*)&stream, ID_FILL, fillerSize + 1, 1) || stream.position != (size_t)fillerSize)
+    {
+        fprintf(stderr, "Cannot write: %d zero bytes to a memory stream!\n", fillerSize);
+        status = 1;
+    }
+    else
+    {
+        IFF_Long i;
+
+        for(i = 0; i < fillerSize; i++)
+        {
+            if(stream.data[i] != 0)
+            {
+                fprintf(stderr, "Byte: %d of the filler should be 0!\n", i);
+                status = 1;
+                break;
+            }
+        }
+    }
+
+    free(stream.data);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    if(checkFillerAtEndOfFile() != 0)
+        return 1;
+
+    if(checkFillerOverExistingData() != 0)
+        return 1;
+
+    if(checkFillerInAppendMode() != 0)
+        return 1;
+
+    if(checkFillerInMemory(0) != 0 || checkFillerInMemory(3) != 0 || checkFillerInMemory(LARGE_FILLER_SIZE) != 0)
+        return 1;
+
+    return 0;
+}